@@ -0,0 +1,864 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy-bench/Bench.h"
+
+#include "server/Server.h"
+#include "server/ClientListener.h"
+#include "server/ClientProxy.h"
+#include "server/PrimaryClient.h"
+#include "server/Config.h"
+#include "client/Client.h"
+#include "platform/VirtualScreen.h"
+#include "synergy/Screen.h"
+#include "synergy/Clipboard.h"
+#include "net/SocketMultiplexer.h"
+#include "net/NetworkAddress.h"
+#include "net/TCPSocketFactory.h"
+#include "net/UnixSocketFactory.h"
+#include "mt/ThreadPool.h"
+#include "arch/Arch.h"
+#include "base/Metrics.h"
+#include "base/IEventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "base/Log.h"
+
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if SYSAPI_WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// keep the mouse this far from the edges so it never leaves the client
+static const SInt32		kMargin = 16;
+static const SInt32		kRowStep = 8;
+static const SInt32		kColumnStep = 4;
+
+// give up on events that haven't arrived after this long
+static const double		kDrainTimeout = 1.0;
+static const double		kClipboardTimeout = 5.0;
+static const double		kConnectTimeout = 10.0;
+static const double		kFileTimeout = 60.0;
+static const double		kStopTimeout = 3.0;
+
+static
+UInt32
+toMicroseconds(double seconds)
+{
+	if (seconds <= 0.0) {
+		return 0;
+	}
+	return static_cast<UInt32>(seconds * 1.0e6 + 0.5);
+}
+
+//
+// Bench::Stream
+//
+
+Bench::Stream::Stream(const char* name) :
+	m_name(name),
+	m_sent(0),
+	m_received(0),
+	m_lost(0),
+	m_bytes(0)
+{
+	// do nothing
+}
+
+void
+Bench::Stream::send(SInt32 a, SInt32 b, double time)
+{
+	Sent sent;
+	sent.m_a    = a;
+	sent.m_b    = b;
+	sent.m_time = time;
+	m_pending.push_back(sent);
+	++m_sent;
+}
+
+bool
+Bench::Stream::receive(SInt32 a, SInt32 b, double time)
+{
+	// anything sent before the match was coalesced or lost on the way
+	for (SentList::iterator i = m_pending.begin(); i != m_pending.end(); ++i) {
+		if (i->m_a == a && i->m_b == b) {
+			m_lost += static_cast<UInt32>(i - m_pending.begin());
+			++m_received;
+			m_latency.add(toMicroseconds(time - i->m_time));
+			m_pending.erase(m_pending.begin(), i + 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+Bench::Stream::dropPending()
+{
+	m_lost += static_cast<UInt32>(m_pending.size());
+	m_pending.clear();
+}
+
+//
+// Bench
+//
+
+Bench::Bench(IEventQueue* events) :
+	m_events(events),
+	m_duration(10.0),
+	m_rate(0),
+	m_window(64),
+	m_keysPercent(10),
+	m_clipboardSize(4096),
+	m_clipboardInterval(1.0),
+	m_fileSize(0),
+	m_fileInterval(5.0),
+	m_enableCrypto(false),
+	m_port(24810),
+	m_width(1920),
+	m_height(1080),
+	m_threadPool(NULL),
+	m_serverMultiplexer(NULL),
+	m_clientMultiplexer(NULL),
+	m_config(NULL),
+	m_serverVirtualScreen(NULL),
+	m_clientVirtualScreen(NULL),
+	m_serverScreen(NULL),
+	m_clientScreen(NULL),
+	m_primaryClient(NULL),
+	m_listener(NULL),
+	m_server(NULL),
+	m_client(NULL),
+	m_state(kConnecting),
+	m_timer(NULL),
+	m_stateTime(0.0),
+	m_nudgeTime(0.0),
+	m_failed(false),
+	m_startTime(0.0),
+	m_endTime(0.0),
+	m_cpuStart(0.0),
+	m_cpuEnd(0.0),
+	m_bytesSentStart(0),
+	m_bytesSentEnd(0),
+	m_x(0),
+	m_y(0),
+	m_sweepX(kMargin),
+	m_sweepY(kMargin),
+	m_sweepStep(kColumnStep),
+	m_keyCount(0),
+	m_keyCredit(0),
+	m_keyHeld(false),
+	m_keyButton(0),
+	m_clipboardCount(0),
+	m_clipboardTime(0.0),
+	m_nextClipboardTime(0.0),
+	m_fileTime(0.0),
+	m_nextFileTime(0.0),
+	m_fileActive(false),
+	m_fileName("synergy-bench.tmp"),
+	m_mouse("mouse"),
+	m_keys("keys"),
+	m_clipboard("clipboard"),
+	m_file("file")
+{
+	// do nothing
+}
+
+Bench::~Bench()
+{
+	cleanup();
+}
+
+bool
+Bench::parseArgs(int argc, const char* const* argv)
+{
+	for (int i = 1; i < argc; ++i) {
+		const char* arg   = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		bool hasValue     = true;
+
+		if (strcmp(arg, "--duration") == 0 && value != NULL) {
+			m_duration = atof(value);
+		}
+		else if (strcmp(arg, "--rate") == 0 && value != NULL) {
+			m_rate = static_cast<UInt32>(atoi(value));
+		}
+		else if (strcmp(arg, "--window") == 0 && value != NULL) {
+			m_window = static_cast<UInt32>(atoi(value));
+		}
+		else if (strcmp(arg, "--keys") == 0 && value != NULL) {
+			m_keysPercent = static_cast<UInt32>(atoi(value));
+		}
+		else if (strcmp(arg, "--clipboard-size") == 0 && value != NULL) {
+			m_clipboardSize = static_cast<UInt32>(atoi(value));
+		}
+		else if (strcmp(arg, "--clipboard-interval") == 0 && value != NULL) {
+			m_clipboardInterval = atof(value);
+		}
+		else if (strcmp(arg, "--file-size") == 0 && value != NULL) {
+			m_fileSize = static_cast<UInt32>(atoi(value));
+		}
+		else if (strcmp(arg, "--file-interval") == 0 && value != NULL) {
+			m_fileInterval = atof(value);
+		}
+		else if (strcmp(arg, "--port") == 0 && value != NULL) {
+			m_port = atoi(value);
+		}
+		else if (strcmp(arg, "--unix") == 0 && value != NULL) {
+			m_unixPath = value;
+		}
+		else if ((strcmp(arg, "-d") == 0 ||
+				strcmp(arg, "--debug") == 0) && value != NULL) {
+			if (!CLOG->setFilter(value)) {
+				LOG((CLOG_PRINT "%s: unrecognized log level `%s'", argv[0], value));
+				return false;
+			}
+		}
+		else if (strcmp(arg, "--enable-crypto") == 0) {
+			m_enableCrypto = true;
+			hasValue       = false;
+		}
+		else {
+			usage(argv[0]);
+			return false;
+		}
+
+		if (hasValue) {
+			++i;
+		}
+	}
+
+	if (m_duration <= 0.0 || m_window == 0 || m_keysPercent > 100 ||
+		m_port <= 0 || m_port > 65535 ||
+		m_clipboardInterval <= 0.0 || m_fileInterval <= 0.0) {
+		usage(argv[0]);
+		return false;
+	}
+	return true;
+}
+
+int
+Bench::run()
+{
+	if (m_enableCrypto) {
+		ARCH->plugin().load();
+		ARCH->plugin().init(Log::getInstance(), Arch::getInstance());
+	}
+
+	try {
+		NetworkAddress address;
+		if (m_unixPath.empty()) {
+			address = NetworkAddress("127.0.0.1", m_port);
+		}
+		else {
+			address = NetworkAddress("unix:" + m_unixPath, 0);
+		}
+		address.resolve();
+
+		m_threadPool = new ThreadPool(m_events);
+		m_config     = new Config(m_events);
+		m_config->addScreen("server");
+		m_config->addScreen("client");
+		m_config->connect("server", kRight, 0.0f, 1.0f, "client", 0.0f, 1.0f);
+		m_config->connect("client", kLeft, 0.0f, 1.0f, "server", 0.0f, 1.0f);
+
+		// server side
+		m_serverVirtualScreen = new VirtualScreen(m_events, true,
+										m_width, m_height);
+		m_serverScreen        = new synergy::Screen(m_serverVirtualScreen,
+										m_events);
+		m_serverScreen->setEnableDragDrop(true);
+		m_primaryClient       = new PrimaryClient("server", m_serverScreen);
+		m_serverMultiplexer   = new SocketMultiplexer;
+		bool secure           = false;
+		if (m_enableCrypto) {
+			secure = TCPSocketFactory::isSecureAvailable();
+			if (!secure) {
+				LOG((CLOG_NOTE "crypto disabled because of ns plugin not available"));
+			}
+		}
+		m_listener            = new ClientListener(address,
+										newSocketFactory(address,
+											m_serverMultiplexer),
+										m_events, secure);
+		m_server              = new Server(*m_config, m_primaryClient,
+										m_serverScreen, m_events, true);
+		m_listener->setServer(m_server);
+		m_server->setListener(m_listener);
+
+		// client side
+		m_clientVirtualScreen = new VirtualScreen(m_events, false,
+										m_width, m_height);
+		m_clientScreen        = new synergy::Screen(m_clientVirtualScreen,
+										m_events);
+		m_clientScreen->setEnableDragDrop(true);
+		m_clientMultiplexer   = new SocketMultiplexer;
+		m_client              = new Client(m_events, "client", address,
+										newSocketFactory(address,
+											m_clientMultiplexer),
+										m_clientScreen, true, m_enableCrypto);
+	}
+	catch (XBase& e) {
+		LOG((CLOG_CRIT "failed to start: %s", e.what()));
+		cleanup();
+		return kExitFailed;
+	}
+
+	if (m_enableCrypto) {
+		ARCH->plugin().initEvent(m_serverScreen->getEventTarget(), m_events);
+	}
+
+	m_events->adoptHandler(m_events->forClientListener().connected(),
+							m_listener,
+							new TMethodEventJob<Bench>(this,
+								&Bench::handleClientAccepted));
+	m_events->adoptHandler(m_events->forClient().connected(),
+							m_client->getEventTarget(),
+							new TMethodEventJob<Bench>(this,
+								&Bench::handleConnected));
+	m_events->adoptHandler(m_events->forClient().connectionFailed(),
+							m_client->getEventTarget(),
+							new TMethodEventJob<Bench>(this,
+								&Bench::handleConnectionFailed));
+
+	// replace the client's own handler, which would write the file to
+	// the drop directory
+	m_events->adoptHandler(m_events->forIScreen().fileRecieveCompleted(),
+							m_client,
+							new TMethodEventJob<Bench>(this,
+								&Bench::handleFileReceived));
+	m_events->adoptHandler(m_events->forServer().disconnected(), m_server,
+							new TMethodEventJob<Bench>(this,
+								&Bench::handleServerDisconnected));
+
+	if (m_fileSize > 0) {
+		std::ofstream file(m_fileName.c_str(), std::ios::out | std::ios::binary);
+		for (UInt32 i = 0; i < m_fileSize; ++i) {
+			file.put(static_cast<char>('a' + i % 26));
+		}
+	}
+
+	m_timer     = m_events->newTimer(0.001, NULL);
+	m_events->adoptHandler(Event::kTimer, m_timer,
+							new TMethodEventJob<Bench>(this,
+								&Bench::handleTimer));
+	m_state     = kConnecting;
+	m_stateTime = ARCH->time();
+	m_client->connect();
+
+	m_events->loop();
+
+	m_events->removeHandler(Event::kTimer, m_timer);
+	m_events->deleteTimer(m_timer);
+	m_timer = NULL;
+
+	if (!m_failed) {
+		report();
+	}
+	cleanup();
+
+	if (m_enableCrypto) {
+		ARCH->plugin().unload();
+	}
+	if (m_fileSize > 0) {
+		remove(m_fileName.c_str());
+	}
+	return m_failed ? kExitFailed : kExitSuccess;
+}
+
+void
+Bench::start()
+{
+	m_startTime         = ARCH->time();
+	m_cpuStart          = getCPUTime();
+	m_bytesSentStart    = METRICS->counter(
+							"synergy_socket_sent_bytes_total",
+							"Bytes sent on TCP sockets")->getValue();
+	m_nextClipboardTime = m_startTime + m_clipboardInterval;
+	m_nextFileTime      = m_startTime;
+}
+
+void
+Bench::stop()
+{
+	m_endTime      = ARCH->time();
+	m_cpuEnd       = getCPUTime();
+	m_bytesSentEnd = METRICS->counter(
+							"synergy_socket_sent_bytes_total",
+							"Bytes sent on TCP sockets")->getValue();
+
+	m_mouse.dropPending();
+	m_keys.dropPending();
+	if (m_clipboardTime != 0.0) {
+		++m_clipboard.m_lost;
+		m_clipboardTime = 0.0;
+	}
+
+	// disconnect cleanly so both screens end up where they started
+	m_state     = kStopping;
+	m_stateTime = m_endTime;
+	m_server->disconnect();
+}
+
+void
+Bench::cleanup()
+{
+	if (m_client != NULL) {
+		m_events->removeHandler(m_events->forClient().connected(),
+							m_client->getEventTarget());
+		m_events->removeHandler(m_events->forClient().connectionFailed(),
+							m_client->getEventTarget());
+		delete m_client;
+		m_client = NULL;
+	}
+	if (m_server != NULL) {
+		m_events->removeHandler(m_events->forServer().disconnected(), m_server);
+		delete m_server;
+		m_server = NULL;
+	}
+	if (m_listener != NULL) {
+		m_events->removeHandler(m_events->forClientListener().connected(),
+							m_listener);
+		delete m_listener;
+		m_listener = NULL;
+	}
+	delete m_primaryClient;
+	delete m_clientScreen;
+	delete m_serverScreen;
+	delete m_clientMultiplexer;
+	delete m_serverMultiplexer;
+	delete m_threadPool;
+	delete m_config;
+	m_primaryClient       = NULL;
+	m_clientScreen        = NULL;
+	m_serverScreen        = NULL;
+	m_clientVirtualScreen = NULL;
+	m_serverVirtualScreen = NULL;
+	m_clientMultiplexer   = NULL;
+	m_serverMultiplexer   = NULL;
+	m_threadPool          = NULL;
+	m_config              = NULL;
+}
+
+void
+Bench::report()
+{
+	double elapsed = m_endTime - m_startTime;
+	if (elapsed <= 0.0) {
+		return;
+	}
+
+	UInt32 events = m_mouse.m_received + m_keys.m_received;
+	LOG((CLOG_PRINT "duration:  %.2f s", elapsed));
+	LOG((CLOG_PRINT "%-10s %8s %8s %8s %10s %9s %9s %9s",
+		"stream", "sent", "recv", "lost", "events/s",
+		"p50 us", "p99 us", "max us"));
+
+	const Stream* streams[] = { &m_mouse, &m_keys, &m_clipboard, &m_file };
+	for (size_t i = 0; i < sizeof(streams) / sizeof(streams[0]); ++i) {
+		const Stream& s = *streams[i];
+		LOG((CLOG_PRINT "%-10s %8u %8u %8u %10.1f %9u %9u %9u",
+			s.m_name, s.m_sent, s.m_received, s.m_lost,
+			s.m_received / elapsed,
+			s.m_latency.getPercentile(50.0),
+			s.m_latency.getPercentile(99.0),
+			s.m_latency.getMax()));
+	}
+
+	LOG((CLOG_PRINT "throughput: %.1f events/s, %.1f KB/s on the wire",
+		events / elapsed,
+		(m_bytesSentEnd - m_bytesSentStart) / elapsed / 1024.0));
+	if (m_clipboard.m_received > 0) {
+		LOG((CLOG_PRINT "clipboard:  %.1f KB/s",
+			m_clipboard.m_bytes / elapsed / 1024.0));
+	}
+	if (m_file.m_received > 0) {
+		LOG((CLOG_PRINT "file:       %.1f KB/s",
+			m_file.m_bytes / elapsed / 1024.0));
+	}
+	if (events > 0) {
+		LOG((CLOG_PRINT "cpu:        %.2f s, %.1f us per event",
+			m_cpuEnd - m_cpuStart,
+			(m_cpuEnd - m_cpuStart) * 1.0e6 / events));
+	}
+}
+
+void
+Bench::sendInput(double now)
+{
+	while (getOutstanding() < m_window) {
+		if (m_rate != 0 &&
+			m_mouse.m_sent + m_keys.m_sent >= m_rate * (now - m_startTime)) {
+			break;
+		}
+
+		// spread key events evenly through the mouse moves
+		m_keyCredit += m_keysPercent;
+		if (m_keyCredit >= 100) {
+			m_keyCredit -= 100;
+			sendKey(now);
+		}
+		else {
+			sendMouseMove(now);
+		}
+	}
+}
+
+void
+Bench::sendMouseMove(double now)
+{
+	// sweep back and forth a row at a time so that every position in
+	// flight is different from the others
+	m_sweepX += m_sweepStep;
+	if (m_sweepX < kMargin || m_sweepX >= m_width - kMargin) {
+		m_sweepStep = -m_sweepStep;
+		m_sweepX   += 2 * m_sweepStep;
+		m_sweepY   += kRowStep;
+		if (m_sweepY >= m_height - kMargin) {
+			m_sweepY = kMargin;
+		}
+	}
+
+	SInt32 dx = m_sweepX - m_x;
+	SInt32 dy = m_sweepY - m_y;
+	m_x = m_sweepX;
+	m_y = m_sweepY;
+	m_mouse.send(m_x, m_y, now);
+	m_serverVirtualScreen->simulateMouseMove(dx, dy);
+}
+
+void
+Bench::sendKey(double now)
+{
+	if (m_keyHeld) {
+		m_keys.send(VirtualScreen::Input::kKeyUp, m_keyButton, now);
+		m_serverVirtualScreen->simulateKeyUp(
+			static_cast<KeyID>('a' + m_keyCount % 26), 0, m_keyButton);
+		m_keyHeld = false;
+	}
+	else {
+		++m_keyCount;
+		m_keyButton = static_cast<KeyButton>(1 + m_keyCount % 200);
+		m_keys.send(VirtualScreen::Input::kKeyDown, m_keyButton, now);
+		m_serverVirtualScreen->simulateKeyDown(
+			static_cast<KeyID>('a' + m_keyCount % 26), 0, m_keyButton);
+		m_keyHeld = true;
+	}
+}
+
+void
+Bench::startClipboard(double now)
+{
+	// copying happens on the server's screen, so the cursor has to go
+	// back there first; release any key so it isn't left held down
+	if (m_keyHeld) {
+		sendKey(now);
+	}
+	m_state     = kLeaving;
+	m_stateTime = now;
+	m_nudgeTime = 0.0;
+}
+
+void
+Bench::startFile(double now)
+{
+	m_fileActive = true;
+	m_fileTime   = now;
+	++m_file.m_sent;
+	m_server->sendFileToClient(m_fileName.c_str());
+}
+
+void
+Bench::checkInput()
+{
+	const VirtualScreen::InputList& input =
+		m_clientVirtualScreen->getInjectedInput();
+	for (VirtualScreen::InputList::const_iterator i = input.begin();
+								i != input.end(); ++i) {
+		switch (i->m_type) {
+		case VirtualScreen::Input::kMouseMove:
+			m_mouse.receive(i->m_x, i->m_y, i->m_time);
+			break;
+
+		case VirtualScreen::Input::kKeyDown:
+		case VirtualScreen::Input::kKeyUp:
+			m_keys.receive(i->m_type, i->m_button, i->m_time);
+			break;
+
+		default:
+			break;
+		}
+	}
+	m_clientVirtualScreen->clearInjectedInput();
+}
+
+void
+Bench::checkClipboard(double now)
+{
+	if (m_clipboardTime == 0.0) {
+		return;
+	}
+
+	double time = m_clientVirtualScreen->getClipboardTime(kClipboardClipboard);
+	if (time >= m_clipboardTime) {
+		Clipboard clipboard;
+		m_clientVirtualScreen->getClipboard(kClipboardClipboard, &clipboard);
+		clipboard.open(0);
+		String text = clipboard.get(IClipboard::kText);
+		clipboard.close();
+		if (text == m_clipboardText) {
+			++m_clipboard.m_received;
+			m_clipboard.m_bytes += text.size();
+			m_clipboard.m_latency.add(toMicroseconds(time - m_clipboardTime));
+			m_clipboardTime     = 0.0;
+			m_nextClipboardTime = now + m_clipboardInterval;
+			return;
+		}
+	}
+
+	if (now - m_clipboardTime > kClipboardTimeout) {
+		++m_clipboard.m_lost;
+		m_clipboardTime     = 0.0;
+		m_nextClipboardTime = now + m_clipboardInterval;
+	}
+}
+
+UInt32
+Bench::getOutstanding() const
+{
+	return static_cast<UInt32>(m_mouse.m_pending.size() +
+								m_keys.m_pending.size());
+}
+
+void
+Bench::handleTimer(const Event&, void*)
+{
+	double now = ARCH->time();
+
+	checkInput();
+	checkClipboard(now);
+
+	switch (m_state) {
+	case kConnecting:
+		if (now - m_stateTime > kConnectTimeout) {
+			LOG((CLOG_ERR "timed out connecting to server"));
+			m_failed = true;
+			m_events->addEvent(Event(Event::kQuit));
+		}
+		break;
+
+	case kEntering:
+		if (m_clientVirtualScreen->isOnScreen()) {
+			// the client's cursor is wherever the server put it
+			m_clientVirtualScreen->getCursorPos(m_x, m_y);
+			if (m_startTime == 0.0) {
+				start();
+			}
+			m_state     = kRunning;
+			m_stateTime = now;
+		}
+		else if (m_serverVirtualScreen->isOnScreen() &&
+				now - m_nudgeTime > 0.1) {
+			// push the cursor off the right edge of the server's screen
+			m_serverVirtualScreen->simulateMouseMove(m_width, 0);
+			m_nudgeTime = now;
+		}
+		break;
+
+	case kRunning:
+		if (now - m_startTime >= m_duration) {
+			if (!m_fileActive || now - m_fileTime > kFileTimeout) {
+				stop();
+				break;
+			}
+		}
+		else if (m_clipboardSize > 0 && m_clipboardTime == 0.0 &&
+				!m_fileActive && now >= m_nextClipboardTime) {
+			startClipboard(now);
+			break;
+		}
+		else if (m_fileSize > 0 && !m_fileActive &&
+				now >= m_nextFileTime) {
+			startFile(now);
+		}
+		sendInput(now);
+		break;
+
+	case kLeaving:
+		if (getOutstanding() > 0 && now - m_stateTime < kDrainTimeout) {
+			// let the input in flight arrive before leaving
+			break;
+		}
+		m_mouse.dropPending();
+		m_keys.dropPending();
+
+		if (m_serverVirtualScreen->isOnScreen()) {
+			char prefix[32];
+			sprintf(prefix, "#%u ", ++m_clipboardCount);
+			m_clipboardText = prefix;
+			if (m_clipboardText.size() < m_clipboardSize) {
+				m_clipboardText.append(m_clipboardSize - m_clipboardText.size(), 'x');
+			}
+
+			m_clipboardTime = ARCH->time();
+			++m_clipboard.m_sent;
+			m_serverVirtualScreen->simulateCopy(kClipboardClipboard,
+							m_clipboardText);
+
+			// the clipboard is sent when the cursor returns to the client
+			m_state     = kEntering;
+			m_stateTime = now;
+			m_nudgeTime = 0.0;
+		}
+		else if (now - m_nudgeTime > 0.1) {
+			// push the cursor off the left edge of the client's screen
+			m_serverVirtualScreen->simulateMouseMove(-m_width, 0);
+			m_nudgeTime = now;
+		}
+		break;
+
+	case kStopping:
+		if (now - m_stateTime > kStopTimeout) {
+			m_events->addEvent(Event(Event::kQuit));
+		}
+		break;
+	}
+}
+
+void
+Bench::handleClientAccepted(const Event&, void*)
+{
+	ClientProxy* client = m_listener->getNextClient();
+	if (client != NULL) {
+		m_server->adoptClient(client);
+	}
+}
+
+void
+Bench::handleConnected(const Event&, void*)
+{
+	LOG((CLOG_NOTE "connected to server"));
+	m_state     = kEntering;
+	m_stateTime = ARCH->time();
+	m_nudgeTime = 0.0;
+}
+
+void
+Bench::handleConnectionFailed(const Event& event, void*)
+{
+	Client::FailInfo* info =
+		reinterpret_cast<Client::FailInfo*>(event.getData());
+	LOG((CLOG_ERR "failed to connect to server: %s", info->m_what.c_str()));
+	delete info;
+	m_failed = true;
+	m_events->addEvent(Event(Event::kQuit));
+}
+
+void
+Bench::handleFileReceived(const Event&, void*)
+{
+	double now = ARCH->time();
+	if (m_client->isReceivedFileSizeValid()) {
+		++m_file.m_received;
+		m_file.m_bytes += m_fileSize;
+		m_file.m_latency.add(toMicroseconds(now - m_fileTime));
+	}
+	else {
+		++m_file.m_lost;
+	}
+	m_fileActive   = false;
+	m_nextFileTime = now + m_fileInterval;
+}
+
+void
+Bench::handleServerDisconnected(const Event&, void*)
+{
+	m_events->addEvent(Event(Event::kQuit));
+}
+
+ISocketFactory*
+Bench::newSocketFactory(const NetworkAddress& address,
+				SocketMultiplexer* multiplexer)
+{
+	if (address.isUnix()) {
+		return new UnixSocketFactory(m_events, multiplexer);
+	}
+	return new TCPSocketFactory(m_events, multiplexer);
+}
+
+void
+Bench::usage(const char* name)
+{
+	LOG((CLOG_PRINT
+		"Usage: %s [options]\n"
+		"\n"
+		"Runs a server and client over loopback and reports throughput\n"
+		"and latency.\n"
+		"\n"
+		"Options:\n"
+		"      --duration <s>           run for <s> seconds (default 10).\n"
+		"      --rate <n>               send <n> input events per second\n"
+		"                                 (default 0, as fast as possible).\n"
+		"      --window <n>             keep at most <n> input events in\n"
+		"                                 flight (default 64).\n"
+		"      --keys <percent>         percentage of input events that are\n"
+		"                                 key presses (default 10).\n"
+		"      --clipboard-size <bytes> clipboard text size, 0 to disable\n"
+		"                                 (default 4096).\n"
+		"      --clipboard-interval <s> seconds between copies (default 1).\n"
+		"      --file-size <bytes>      file transfer size, 0 to disable\n"
+		"                                 (default 0).\n"
+		"      --file-interval <s>      seconds between transfers\n"
+		"                                 (default 5).\n"
+		"      --enable-crypto          use the network security plugin.\n"
+		"      --port <port>            loopback port (default 24810).\n"
+		"      --unix <path>            connect through a unix domain socket\n"
+		"                                 at <path> instead of loopback.\n"
+		"  -d, --debug <level>          filter out log messages with a\n"
+		"                                 priority below level.",
+		name));
+}
+
+double
+Bench::getCPUTime()
+{
+#if SYSAPI_WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+		return 0.0;
+	}
+	ULARGE_INTEGER k, u;
+	k.LowPart  = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart  = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+	return 1.0e-7 * static_cast<double>(k.QuadPart + u.QuadPart);
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0.0;
+	}
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+			1.0e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+#endif
+}
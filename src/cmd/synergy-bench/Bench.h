@@ -0,0 +1,202 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "synergy/key_types.h"
+#include "base/Histogram.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stddeque.h"
+
+class Client;
+class ClientListener;
+class Config;
+class Event;
+class EventQueueTimer;
+class IEventQueue;
+class ISocketFactory;
+class NetworkAddress;
+class PrimaryClient;
+class Server;
+class SocketMultiplexer;
+class ThreadPool;
+class VirtualScreen;
+namespace synergy { class Screen; }
+
+//! Loopback benchmark
+/*!
+Runs a server and a client in one process, connected over loopback TCP,
+with headless screens on both ends.  Input is generated on the server's
+screen and timed until the client's screen receives it, giving end to
+end throughput and latency for the whole network path.
+*/
+class Bench {
+public:
+	Bench(IEventQueue* events);
+	~Bench();
+
+	//! Parse the command line
+	/*!
+	Returns false and prints usage if the arguments are invalid.
+	*/
+	bool				parseArgs(int argc, const char* const* argv);
+
+	//! Run the benchmark
+	/*!
+	Runs the event loop until the benchmark finishes, prints the report
+	and returns an exit code.
+	*/
+	int					run();
+
+private:
+	enum EState {
+		kConnecting,
+		kEntering,
+		kRunning,
+		kLeaving,
+		kStopping
+	};
+
+	// an event sent but not yet seen by the client's screen
+	class Sent {
+	public:
+		SInt32			m_a;
+		SInt32			m_b;
+		double			m_time;
+	};
+	typedef std::deque<Sent> SentList;
+
+	// results for one kind of event
+	class Stream {
+	public:
+		Stream(const char* name);
+
+		void			send(SInt32 a, SInt32 b, double time);
+		bool			receive(SInt32 a, SInt32 b, double time);
+		void			dropPending();
+
+	public:
+		const char*		m_name;
+		UInt32			m_sent;
+		UInt32			m_received;
+		UInt32			m_lost;
+		UInt64			m_bytes;
+		Histogram		m_latency;
+		SentList		m_pending;
+	};
+
+	void				start();
+	void				stop();
+	void				cleanup();
+	void				report();
+
+	void				sendInput(double now);
+	void				sendMouseMove(double now);
+	void				sendKey(double now);
+	void				startClipboard(double now);
+	void				startFile(double now);
+	void				checkInput();
+	void				checkClipboard(double now);
+	UInt32				getOutstanding() const;
+	ISocketFactory*		newSocketFactory(const NetworkAddress&,
+							SocketMultiplexer*);
+
+	void				handleTimer(const Event&, void*);
+	void				handleClientAccepted(const Event&, void*);
+	void				handleConnected(const Event&, void*);
+	void				handleConnectionFailed(const Event&, void*);
+	void				handleFileReceived(const Event&, void*);
+	void				handleServerDisconnected(const Event&, void*);
+
+	static void			usage(const char* name);
+	static double		getCPUTime();
+
+private:
+	IEventQueue*		m_events;
+
+	// options
+	double				m_duration;
+	UInt32				m_rate;
+	UInt32				m_window;
+	UInt32				m_keysPercent;
+	UInt32				m_clipboardSize;
+	double				m_clipboardInterval;
+	UInt32				m_fileSize;
+	double				m_fileInterval;
+	bool				m_enableCrypto;
+	int					m_port;
+	String				m_unixPath;
+	SInt32				m_width;
+	SInt32				m_height;
+
+	// objects under test
+	ThreadPool*			m_threadPool;
+	SocketMultiplexer*	m_serverMultiplexer;
+	SocketMultiplexer*	m_clientMultiplexer;
+	Config*				m_config;
+	VirtualScreen*		m_serverVirtualScreen;
+	VirtualScreen*		m_clientVirtualScreen;
+	synergy::Screen*	m_serverScreen;
+	synergy::Screen*	m_clientScreen;
+	PrimaryClient*		m_primaryClient;
+	ClientListener*		m_listener;
+	Server*				m_server;
+	Client*				m_client;
+
+	// state
+	EState				m_state;
+	EventQueueTimer*	m_timer;
+	double				m_stateTime;
+	double				m_nudgeTime;
+	bool				m_failed;
+
+	// measurement
+	double				m_startTime;
+	double				m_endTime;
+	double				m_cpuStart;
+	double				m_cpuEnd;
+	UInt64				m_bytesSentStart;
+	UInt64				m_bytesSentEnd;
+
+	// mouse model
+	SInt32				m_x, m_y;
+	SInt32				m_sweepX, m_sweepY;
+	SInt32				m_sweepStep;
+
+	// key model
+	UInt32				m_keyCount;
+	UInt32				m_keyCredit;
+	bool				m_keyHeld;
+	KeyButton			m_keyButton;
+
+	// clipboard and file transfers
+	UInt32				m_clipboardCount;
+	double				m_clipboardTime;
+	double				m_nextClipboardTime;
+	String				m_clipboardText;
+	double				m_fileTime;
+	double				m_nextFileTime;
+	bool				m_fileActive;
+	String				m_fileName;
+
+	Stream				m_mouse;
+	Stream				m_keys;
+	Stream				m_clipboard;
+	Stream				m_file;
+};
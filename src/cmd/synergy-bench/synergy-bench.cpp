@@ -0,0 +1,44 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy-bench/Bench.h"
+#include "arch/Arch.h"
+#include "base/Log.h"
+#include "base/EventQueue.h"
+
+int
+main(int argc, char** argv) 
+{
+#if SYSAPI_WIN32
+	// record window instance for tray icon, etc
+	ArchMiscWindows::setInstanceWin32(GetModuleHandle(NULL));
+#endif
+
+	Arch arch;
+	arch.init();
+
+	Log log;
+	log.setFilter(kWARNING);
+	EventQueue events;
+
+	Bench bench(&events);
+	if (!bench.parseArgs(argc, argv)) {
+		return kExitArgs;
+	}
+	return bench.run();
+}
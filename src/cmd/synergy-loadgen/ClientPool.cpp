@@ -0,0 +1,251 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy-loadgen/ClientPool.h"
+
+#include "synergy-loadgen/LoadStats.h"
+#include "client/Client.h"
+#include "platform/VirtualScreen.h"
+#include "synergy/Screen.h"
+#include "net/SocketMultiplexer.h"
+#include "net/TCPSocketFactory.h"
+#include "mt/Thread.h"
+#include "arch/Arch.h"
+#include "base/EventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "base/TMethodJob.h"
+#include "base/String.h"
+#include "base/Log.h"
+
+// reconnect like synergyc does
+static const double		kRetryTime    = 1.0;
+static const double		kMaxRetryTime = 8.0;
+
+//
+// ClientPool
+//
+
+ClientPool::ClientPool(UInt32 numClients, const NetworkAddress& address,
+				bool enableCrypto, bool storm, SInt32 width, SInt32 height,
+				LoadStats* stats) :
+	m_numClients(numClients),
+	m_address(address),
+	m_enableCrypto(enableCrypto),
+	m_storm(storm),
+	m_width(width),
+	m_height(height),
+	m_stats(stats),
+	m_events(NULL),
+	m_thread(NULL),
+	m_numConnecting(0)
+{
+	// do nothing
+}
+
+ClientPool::~ClientPool()
+{
+	stop();
+}
+
+void
+ClientPool::start()
+{
+	assert(m_thread == NULL);
+
+	// the queue is created here so stop() can post to it at any time
+	m_events = new EventQueue;
+	m_thread = new Thread(new TMethodJob<ClientPool>(
+								this, &ClientPool::run));
+}
+
+void
+ClientPool::stop()
+{
+	if (m_thread == NULL) {
+		return;
+	}
+
+	m_events->addEvent(Event(Event::kQuit));
+	m_thread->wait();
+	delete m_thread;
+	delete m_events;
+	m_thread = NULL;
+	m_events = NULL;
+}
+
+void
+ClientPool::run(void*)
+{
+	SocketMultiplexer multiplexer;
+
+	m_numConnecting = 0;
+	m_clients.resize(m_numClients);
+	for (UInt32 i = 0; i < m_numClients; ++i) {
+		VirtualClient& client  = m_clients[i];
+		client.m_virtualScreen = new VirtualScreen(m_events, false,
+										m_width, m_height);
+		client.m_screen        = new synergy::Screen(client.m_virtualScreen,
+										m_events);
+		client.m_client        = new Client(m_events,
+										synergy::string::sprintf("client%u", i + 1),
+										m_address,
+										new TCPSocketFactory(m_events, &multiplexer),
+										client.m_screen, false, m_enableCrypto);
+		client.m_grabTime      = 0.0;
+
+		void* target = client.m_client->getEventTarget();
+		m_events->adoptHandler(m_events->forClient().connected(), target,
+							new TMethodEventJob<ClientPool>(this,
+								&ClientPool::handleConnected, &client));
+		m_events->adoptHandler(m_events->forClient().connectionFailed(),
+							target,
+							new TMethodEventJob<ClientPool>(this,
+								&ClientPool::handleConnectionFailed,
+								&client));
+		m_events->adoptHandler(m_events->forClient().disconnected(), target,
+							new TMethodEventJob<ClientPool>(this,
+								&ClientPool::handleDisconnected, &client));
+	}
+	EventQueueTimer* timer = m_events->newTimer(0.001, NULL);
+	m_events->adoptHandler(Event::kTimer, timer,
+							new TMethodEventJob<ClientPool>(this,
+								&ClientPool::handleTimer));
+
+	m_events->loop();
+
+	m_events->removeHandler(Event::kTimer, timer);
+	m_events->deleteTimer(timer);
+
+	for (VirtualClientList::iterator i = m_clients.begin();
+								i != m_clients.end(); ++i) {
+		void* target = i->m_client->getEventTarget();
+		m_events->removeHandler(m_events->forClient().connected(), target);
+		m_events->removeHandler(m_events->forClient().connectionFailed(),
+							target);
+		m_events->removeHandler(m_events->forClient().disconnected(), target);
+		delete i->m_client;
+		delete i->m_screen;
+	}
+	m_clients.clear();
+}
+
+void
+ClientPool::checkInput()
+{
+	for (VirtualClientList::iterator i = m_clients.begin();
+								i != m_clients.end(); ++i) {
+		const VirtualScreen::InputList& input =
+			i->m_virtualScreen->getInjectedInput();
+		for (VirtualScreen::InputList::const_iterator j = input.begin();
+								j != input.end(); ++j) {
+			switch (j->m_type) {
+			case VirtualScreen::Input::kMouseMove:
+				m_stats->receiveMouseMove(j->m_x, j->m_y, j->m_time);
+				break;
+
+			case VirtualScreen::Input::kKeyDown:
+			case VirtualScreen::Input::kKeyUp:
+				m_stats->receiveKey(j->m_type, j->m_button, j->m_time);
+				break;
+
+			default:
+				break;
+			}
+		}
+		i->m_virtualScreen->clearInjectedInput();
+
+		double grabTime =
+			i->m_virtualScreen->getClipboardGrabTime(kClipboardClipboard);
+		if (grabTime != i->m_grabTime) {
+			i->m_grabTime = grabTime;
+			m_stats->receiveGrab(grabTime);
+		}
+	}
+}
+
+void
+ClientPool::checkRetries(double now)
+{
+	for (VirtualClientList::iterator i = m_clients.begin();
+								i != m_clients.end(); ++i) {
+		if (i->m_retryTime != 0.0 && now >= i->m_retryTime) {
+			i->m_retryTime = 0.0;
+			i->m_client->connect();
+		}
+	}
+}
+
+void
+ClientPool::handleTimer(const Event&, void*)
+{
+	// start the clients one at a time, as users would, rather than all
+	// at once unless we're testing a reconnect storm
+	if (m_storm) {
+		while (m_numConnecting < m_clients.size()) {
+			m_clients[m_numConnecting++].m_client->connect();
+		}
+	}
+	else if (m_numConnecting < m_clients.size()) {
+		m_clients[m_numConnecting++].m_client->connect();
+	}
+
+	checkRetries(ARCH->time());
+	checkInput();
+}
+
+void
+ClientPool::handleConnected(const Event&, void* vclient)
+{
+	VirtualClient* client = reinterpret_cast<VirtualClient*>(vclient);
+	client->m_backoff.reset();
+}
+
+void
+ClientPool::handleConnectionFailed(const Event& event, void* vclient)
+{
+	VirtualClient* client = reinterpret_cast<VirtualClient*>(vclient);
+	Client::FailInfo* info =
+		reinterpret_cast<Client::FailInfo*>(event.getData());
+
+	m_stats->connectFailed(info->m_retryAfter > 0.0);
+	client->m_retryTime = ARCH->time() +
+							client->m_backoff.next(info->m_retryAfter);
+	delete info;
+}
+
+void
+ClientPool::handleDisconnected(const Event&, void* vclient)
+{
+	VirtualClient* client = reinterpret_cast<VirtualClient*>(vclient);
+	client->m_retryTime   = ARCH->time() + client->m_backoff.next();
+}
+
+//
+// ClientPool::VirtualClient
+//
+
+ClientPool::VirtualClient::VirtualClient() :
+	m_virtualScreen(NULL),
+	m_screen(NULL),
+	m_client(NULL),
+	m_grabTime(0.0),
+	m_backoff(kRetryTime, kMaxRetryTime),
+	m_retryTime(0.0)
+{
+	// do nothing
+}
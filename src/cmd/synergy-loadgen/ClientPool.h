@@ -0,0 +1,97 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "net/NetworkAddress.h"
+#include "base/Backoff.h"
+#include "common/stdvector.h"
+
+class Client;
+class Event;
+class EventQueue;
+class LoadStats;
+class Thread;
+class VirtualScreen;
+namespace synergy { class Screen; }
+
+//! A pool of virtual clients
+/*!
+Runs \c numClients clients with headless screens on a thread of their
+own, with their own event queue, so the server's thread does nothing
+but serve them.  Input arriving at the clients' screens is reported to
+a \c LoadStats.  A client that fails to connect or is disconnected
+reconnects after a backoff, as synergyc would.
+*/
+class ClientPool {
+public:
+	/*!
+	If \p storm is true all the clients connect at once, as after a
+	server restart, rather than one at a time.
+	*/
+	ClientPool(UInt32 numClients, const NetworkAddress& address,
+							bool enableCrypto, bool storm,
+							SInt32 width, SInt32 height, LoadStats* stats);
+	~ClientPool();
+
+	//! @name manipulators
+	//@{
+
+	//! Start the clients' thread and connect
+	void				start();
+
+	//! Disconnect and wait for the clients' thread to exit
+	void				stop();
+
+	//@}
+
+private:
+	class VirtualClient {
+	public:
+		VirtualClient();
+
+		VirtualScreen*		m_virtualScreen;
+		synergy::Screen*	m_screen;
+		Client*				m_client;
+		double				m_grabTime;
+		Backoff				m_backoff;
+		double				m_retryTime;
+	};
+	typedef std::vector<VirtualClient> VirtualClientList;
+
+	void				run(void*);
+	void				checkInput();
+	void				checkRetries(double now);
+	void				handleTimer(const Event&, void*);
+	void				handleConnected(const Event&, void*);
+	void				handleConnectionFailed(const Event&, void*);
+	void				handleDisconnected(const Event&, void*);
+
+private:
+	UInt32				m_numClients;
+	NetworkAddress		m_address;
+	bool				m_enableCrypto;
+	bool				m_storm;
+	SInt32				m_width;
+	SInt32				m_height;
+	LoadStats*			m_stats;
+	EventQueue*			m_events;
+	Thread*				m_thread;
+	VirtualClientList	m_clients;
+	size_t				m_numConnecting;
+};
@@ -0,0 +1,671 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy-loadgen/LoadGen.h"
+
+#include "synergy-loadgen/ClientPool.h"
+#include "server/Server.h"
+#include "server/ClientListener.h"
+#include "server/ClientProxy.h"
+#include "server/PrimaryClient.h"
+#include "server/Config.h"
+#include "platform/VirtualScreen.h"
+#include "synergy/Screen.h"
+#include "net/SocketMultiplexer.h"
+#include "net/TCPSocketFactory.h"
+#include "arch/Arch.h"
+#include "base/IEventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "base/Log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if SYSAPI_WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+// keep the mouse this far from the edges of the clients' screens
+static const SInt32		kMargin = 16;
+static const SInt32		kRowStep = 8;
+static const SInt32		kColumnStep = 4;
+
+static const double		kConnectTimeout = 30.0;
+static const double		kDisconnectTimeout = 10.0;
+static const double		kDrainTimeout = 1.0;
+
+//
+// LoadGen
+//
+
+LoadGen::LoadGen(IEventQueue* events) :
+	m_events(events),
+	m_duration(10.0),
+	m_mouseRate(125.0),
+	m_keyRate(5.0),
+	m_switchInterval(2.0),
+	m_clipboardInterval(1.0),
+	m_enableCrypto(false),
+	m_storm(false),
+	m_ioThreads(0),
+	m_port(24811),
+	m_width(1920),
+	m_height(1080),
+	m_multiplexer(NULL),
+	m_config(NULL),
+	m_virtualScreen(NULL),
+	m_screen(NULL),
+	m_primaryClient(NULL),
+	m_listener(NULL),
+	m_server(NULL),
+	m_run(0),
+	m_pool(NULL),
+	m_state(kConnecting),
+	m_timer(NULL),
+	m_stateTime(0.0),
+	m_connectTime(0.0),
+	m_lastTime(0.0),
+	m_startTime(0.0),
+	m_endTime(0.0),
+	m_threadCPUStart(0.0),
+	m_threadCPUEnd(0.0),
+	m_processCPUStart(0.0),
+	m_processCPUEnd(0.0),
+	m_failed(false),
+	m_mouseCredit(0.0),
+	m_keyCredit(0.0),
+	m_nextSwitchTime(0.0),
+	m_nextGrabTime(0.0),
+	m_active(0),
+	m_x(0),
+	m_y(0),
+	m_sweepX(kMargin),
+	m_sweepY(kMargin),
+	m_sweepStep(kColumnStep),
+	m_keyCount(0),
+	m_keyHeld(false),
+	m_keyButton(0),
+	m_grabCount(0)
+{
+	// do nothing
+}
+
+LoadGen::~LoadGen()
+{
+	cleanup();
+}
+
+bool
+LoadGen::parseArgs(int argc, const char* const* argv)
+{
+	for (int i = 1; i < argc; ++i) {
+		const char* arg   = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		bool hasValue     = true;
+
+		if (strcmp(arg, "--clients") == 0 && value != NULL) {
+			// comma separated list of client counts
+			m_clientCounts.clear();
+			const char* next = value;
+			while (*next != '\0') {
+				char* end;
+				long n = strtol(next, &end, 10);
+				if (end == next || n <= 0 || (*end != ',' && *end != '\0')) {
+					usage(argv[0]);
+					return false;
+				}
+				m_clientCounts.push_back(static_cast<UInt32>(n));
+				next = (*end == ',') ? end + 1 : end;
+			}
+		}
+		else if (strcmp(arg, "--duration") == 0 && value != NULL) {
+			m_duration = atof(value);
+		}
+		else if (strcmp(arg, "--mouse-rate") == 0 && value != NULL) {
+			m_mouseRate = atof(value);
+		}
+		else if (strcmp(arg, "--key-rate") == 0 && value != NULL) {
+			m_keyRate = atof(value);
+		}
+		else if (strcmp(arg, "--switch-interval") == 0 && value != NULL) {
+			m_switchInterval = atof(value);
+		}
+		else if (strcmp(arg, "--clipboard-interval") == 0 && value != NULL) {
+			m_clipboardInterval = atof(value);
+		}
+		else if (strcmp(arg, "--io-threads") == 0 && value != NULL) {
+			m_ioThreads = atoi(value);
+		}
+		else if (strcmp(arg, "--port") == 0 && value != NULL) {
+			m_port = atoi(value);
+		}
+		else if ((strcmp(arg, "-d") == 0 ||
+				strcmp(arg, "--debug") == 0) && value != NULL) {
+			if (!CLOG->setFilter(value)) {
+				LOG((CLOG_PRINT "%s: unrecognized log level `%s'", argv[0], value));
+				return false;
+			}
+		}
+		else if (strcmp(arg, "--enable-crypto") == 0) {
+			m_enableCrypto = true;
+			hasValue       = false;
+		}
+		else if (strcmp(arg, "--storm") == 0) {
+			m_storm        = true;
+			hasValue       = false;
+		}
+		else {
+			usage(argv[0]);
+			return false;
+		}
+
+		if (hasValue) {
+			++i;
+		}
+	}
+
+	if (m_clientCounts.empty()) {
+		m_clientCounts.push_back(1);
+		m_clientCounts.push_back(10);
+		m_clientCounts.push_back(50);
+	}
+
+	if (m_duration <= 0.0 || m_mouseRate < 0.0 || m_keyRate < 0.0 ||
+		m_switchInterval <= 0.0 || m_clipboardInterval <= 0.0 ||
+		m_ioThreads < 0 || m_port <= 0 || m_port > 65535) {
+		usage(argv[0]);
+		return false;
+	}
+
+	// the ns plugin keeps a single client socket per process, so every
+	// client after the first would take over the previous one's socket
+	if (m_enableCrypto) {
+		for (ClientCounts::const_iterator i = m_clientCounts.begin();
+								i != m_clientCounts.end(); ++i) {
+			if (*i > 1) {
+				LOG((CLOG_PRINT "%s: --enable-crypto supports only one client",
+					argv[0]));
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+int
+LoadGen::run()
+{
+	if (m_enableCrypto) {
+		ARCH->plugin().load();
+		ARCH->plugin().init(Log::getInstance(), Arch::getInstance());
+	}
+
+	try {
+		m_address = NetworkAddress("127.0.0.1", m_port);
+		m_address.resolve();
+
+		// the clients aren't connected to anything so they can only be
+		// reached by switching to them directly
+		UInt32 maxClients = 0;
+		for (ClientCounts::const_iterator i = m_clientCounts.begin();
+								i != m_clientCounts.end(); ++i) {
+			if (*i > maxClients) {
+				maxClients = *i;
+			}
+		}
+		m_config = new Config(m_events);
+		m_config->addScreen("server");
+		for (UInt32 i = 1; i <= maxClients; ++i) {
+			m_config->addScreen(synergy::string::sprintf("client%u", i));
+		}
+
+		m_virtualScreen = new VirtualScreen(m_events, true, m_width, m_height);
+		m_screen        = new synergy::Screen(m_virtualScreen, m_events);
+		m_primaryClient = new PrimaryClient("server", m_screen);
+		m_multiplexer   = new SocketMultiplexer;
+		m_multiplexer->setIOThreads(m_ioThreads);
+		bool secure     = false;
+		if (m_enableCrypto) {
+			secure = TCPSocketFactory::isSecureAvailable();
+			if (!secure) {
+				LOG((CLOG_NOTE "crypto disabled because of ns plugin not available"));
+			}
+		}
+		m_listener      = new ClientListener(m_address,
+								new TCPSocketFactory(m_events, m_multiplexer),
+								m_events, secure);
+		m_server        = new Server(*m_config, m_primaryClient,
+								m_screen, m_events, false);
+		m_listener->setServer(m_server);
+		m_server->setListener(m_listener);
+	}
+	catch (XBase& e) {
+		LOG((CLOG_CRIT "failed to start server: %s", e.what()));
+		cleanup();
+		return kExitFailed;
+	}
+
+	if (m_enableCrypto) {
+		ARCH->plugin().initEvent(m_screen->getEventTarget(), m_events);
+	}
+
+	m_events->adoptHandler(m_events->forClientListener().connected(),
+							m_listener,
+							new TMethodEventJob<LoadGen>(this,
+								&LoadGen::handleClientAccepted));
+
+	m_timer = m_events->newTimer(0.001, NULL);
+	m_events->adoptHandler(Event::kTimer, m_timer,
+							new TMethodEventJob<LoadGen>(this,
+								&LoadGen::handleTimer));
+
+	LOG((CLOG_PRINT "%7s %7s %7s %7s %9s %9s %9s %9s %9s %9s %9s %9s %9s %7s",
+		"clients", "conn s", "retries", "busy",
+		"events/s", "srv cpu%", "cpu%", "us/event",
+		"in p50", "in p99", "grab p50", "grab p99", "fan p99", "lost"));
+
+	m_run = 0;
+	startRun();
+	m_events->loop();
+
+	m_events->removeHandler(Event::kTimer, m_timer);
+	m_events->deleteTimer(m_timer);
+	m_timer = NULL;
+
+	cleanup();
+
+	if (m_enableCrypto) {
+		ARCH->plugin().unload();
+	}
+	return m_failed ? kExitFailed : kExitSuccess;
+}
+
+void
+LoadGen::startRun()
+{
+	UInt32 numClients = m_clientCounts[m_run];
+	LOG((CLOG_NOTE "connecting %u clients", numClients));
+
+	m_stats.reset(numClients);
+	m_pool      = new ClientPool(numClients, m_address, m_enableCrypto,
+							m_storm, m_width, m_height, &m_stats);
+	m_pool->start();
+	m_state     = kConnecting;
+	m_stateTime = ARCH->time();
+}
+
+void
+LoadGen::finishRun(double now)
+{
+	m_endTime       = now;
+	m_threadCPUEnd  = getThreadCPUTime();
+	m_processCPUEnd = getProcessCPUTime();
+	m_stats.dropPending();
+	report();
+	stopRun();
+}
+
+void
+LoadGen::stopRun()
+{
+	m_pool->stop();
+	delete m_pool;
+	m_pool      = NULL;
+	m_state     = kDisconnecting;
+	m_stateTime = ARCH->time();
+}
+
+void
+LoadGen::report()
+{
+	double elapsed = m_endTime - m_startTime;
+	if (elapsed <= 0.0) {
+		return;
+	}
+
+	LoadStats::Stream mouse  = m_stats.getMouse();
+	LoadStats::Stream keys   = m_stats.getKeys();
+	LoadStats::Stream fanOut = m_stats.getFanOut();
+	Histogram input(mouse.m_latency);
+	input.merge(keys.m_latency);
+	Histogram grab = m_stats.getGrabLatency();
+
+	UInt32 events      = mouse.m_received + keys.m_received;
+	double threadCPU   = m_threadCPUEnd - m_threadCPUStart;
+	double processCPU  = m_processCPUEnd - m_processCPUStart;
+	LOG((CLOG_PRINT "%7u %7.1f %7u %7u %9.1f %9.1f %9.1f %9.1f %9u %9u %9u %9u %9u %7u",
+		m_clientCounts[m_run],
+		m_connectTime,
+		m_stats.getConnectFailures(),
+		m_stats.getTurnedAway(),
+		events / elapsed,
+		100.0 * threadCPU / elapsed,
+		100.0 * processCPU / elapsed,
+		events > 0 ? 1.0e6 * threadCPU / events : 0.0,
+		input.getPercentile(50.0),
+		input.getPercentile(99.0),
+		grab.getPercentile(50.0),
+		grab.getPercentile(99.0),
+		fanOut.m_latency.getPercentile(99.0),
+		mouse.m_lost + keys.m_lost + fanOut.m_lost));
+}
+
+void
+LoadGen::cleanup()
+{
+	if (m_pool != NULL) {
+		m_pool->stop();
+		delete m_pool;
+		m_pool = NULL;
+	}
+	if (m_server != NULL) {
+		delete m_server;
+		m_server = NULL;
+	}
+	if (m_listener != NULL) {
+		m_events->removeHandler(m_events->forClientListener().connected(),
+							m_listener);
+		delete m_listener;
+		m_listener = NULL;
+	}
+	delete m_primaryClient;
+	delete m_screen;
+	delete m_multiplexer;
+	delete m_config;
+	m_primaryClient = NULL;
+	m_screen        = NULL;
+	m_virtualScreen = NULL;
+	m_multiplexer   = NULL;
+	m_config        = NULL;
+}
+
+void
+LoadGen::sendInput(double now, double elapsed)
+{
+	// catch up after a pause, but not with a burst of more than 100ms
+	m_mouseCredit += m_mouseRate * elapsed;
+	if (m_mouseCredit > 1.0 + m_mouseRate * 0.1) {
+		m_mouseCredit = 1.0 + m_mouseRate * 0.1;
+	}
+	while (m_mouseCredit >= 1.0) {
+		m_mouseCredit -= 1.0;
+		sendMouseMove(now);
+	}
+
+	// a key press is two events
+	m_keyCredit += 2.0 * m_keyRate * elapsed;
+	if (m_keyCredit > 1.0 + m_keyRate * 0.2) {
+		m_keyCredit = 1.0 + m_keyRate * 0.2;
+	}
+	while (m_keyCredit >= 1.0) {
+		m_keyCredit -= 1.0;
+		sendKey(now);
+	}
+}
+
+void
+LoadGen::sendMouseMove(double now)
+{
+	// sweep back and forth a row at a time so that every position in
+	// flight is different from the others
+	m_sweepX += m_sweepStep;
+	if (m_sweepX < kMargin || m_sweepX >= m_width - kMargin) {
+		m_sweepStep = -m_sweepStep;
+		m_sweepX   += 2 * m_sweepStep;
+		m_sweepY   += kRowStep;
+		if (m_sweepY >= m_height - kMargin) {
+			m_sweepY = kMargin;
+		}
+	}
+
+	SInt32 dx = m_sweepX - m_x;
+	SInt32 dy = m_sweepY - m_y;
+	m_x = m_sweepX;
+	m_y = m_sweepY;
+	m_stats.sendMouseMove(m_x, m_y, now);
+	m_virtualScreen->simulateMouseMove(dx, dy);
+}
+
+void
+LoadGen::sendKey(double now)
+{
+	if (m_keyHeld) {
+		m_stats.sendKey(VirtualScreen::Input::kKeyUp, m_keyButton, now);
+		m_virtualScreen->simulateKeyUp(
+			static_cast<KeyID>('a' + m_keyCount % 26), 0, m_keyButton);
+		m_keyHeld = false;
+	}
+	else {
+		++m_keyCount;
+		m_keyButton = static_cast<KeyButton>(1 + m_keyCount % 200);
+		m_stats.sendKey(VirtualScreen::Input::kKeyDown, m_keyButton, now);
+		m_virtualScreen->simulateKeyDown(
+			static_cast<KeyID>('a' + m_keyCount % 26), 0, m_keyButton);
+		m_keyHeld = true;
+	}
+}
+
+void
+LoadGen::sendGrab(double now)
+{
+	// the server tells every client to take ownership of the clipboard
+	// as soon as the primary screen grabs it
+	m_stats.sendGrab(now);
+	m_virtualScreen->simulateCopy(kClipboardClipboard,
+		synergy::string::sprintf("#%u", ++m_grabCount));
+	m_nextGrabTime = now + m_clipboardInterval;
+}
+
+void
+LoadGen::switchScreen()
+{
+	UInt32 numClients = m_clientCounts[m_run];
+	UInt32 next       = static_cast<UInt32>(rand()) % numClients;
+	if (next == m_active && numClients > 1) {
+		next = (next + 1) % numClients;
+	}
+	m_active = next;
+
+	// as if the user pressed a switchToScreen hot key
+	String name = synergy::string::sprintf("client%u", m_active + 1);
+	m_events->addEvent(Event(m_events->forServer().switchToScreen(),
+							m_config->getInputFilter(),
+							Server::SwitchToScreenInfo::alloc(name)));
+}
+
+void
+LoadGen::handleTimer(const Event&, void*)
+{
+	double now = ARCH->time();
+
+	switch (m_state) {
+	case kConnecting:
+		if (m_server->getNumClients() == m_clientCounts[m_run] + 1) {
+			m_connectTime     = now - m_stateTime;
+			m_startTime       = now;
+			m_threadCPUStart  = getThreadCPUTime();
+			m_processCPUStart = getProcessCPUTime();
+			m_nextGrabTime    = now + m_clipboardInterval;
+			m_active          = m_clientCounts[m_run];
+			m_mouseCredit     = 0.0;
+			m_keyCredit       = 0.0;
+			m_state           = kDraining;
+			m_stateTime       = now;
+		}
+		else if (now - m_stateTime > kConnectTimeout) {
+			LOG((CLOG_ERR "only %u of %u clients connected",
+				m_server->getNumClients() - 1, m_clientCounts[m_run]));
+			m_failed = true;
+			stopRun();
+		}
+		break;
+
+	case kRunning: {
+		double elapsed = now - m_lastTime;
+		m_lastTime     = now;
+		if (now - m_startTime >= m_duration) {
+			finishRun(now);
+			break;
+		}
+		if (now >= m_nextGrabTime) {
+			sendGrab(now);
+		}
+		if (now >= m_nextSwitchTime) {
+			// release any key so it isn't left held down
+			if (m_keyHeld) {
+				sendKey(now);
+			}
+			m_state     = kDraining;
+			m_stateTime = now;
+			break;
+		}
+		sendInput(now, elapsed);
+		break;
+	}
+
+	case kDraining:
+		if (m_stats.getOutstanding() > 0 && now - m_stateTime < kDrainTimeout) {
+			// let the input in flight arrive before switching
+			break;
+		}
+		m_stats.dropPending();
+		switchScreen();
+		m_state = kSwitching;
+		break;
+
+	case kSwitching:
+		if (m_virtualScreen->isOnScreen()) {
+			// the server hasn't left its own screen yet
+			break;
+		}
+
+		// the clients have no neighbors so a big enough move pins the
+		// cursor to the top left corner wherever it entered
+		m_virtualScreen->simulateMouseMove(-2 * m_width, -2 * m_height);
+		m_x              = 0;
+		m_y              = 0;
+		m_lastTime       = now;
+		m_nextSwitchTime = now + m_switchInterval;
+		m_state          = kRunning;
+		break;
+
+	case kDisconnecting:
+		if (m_server->getNumClients() == 1 ||
+			now - m_stateTime > kDisconnectTimeout) {
+			if (++m_run < m_clientCounts.size() && !m_failed) {
+				startRun();
+			}
+			else {
+				m_events->addEvent(Event(Event::kQuit));
+			}
+		}
+		break;
+	}
+}
+
+void
+LoadGen::handleClientAccepted(const Event&, void*)
+{
+	ClientProxy* client = m_listener->getNextClient();
+	if (client != NULL) {
+		m_server->adoptClient(client);
+	}
+}
+
+void
+LoadGen::usage(const char* name)
+{
+	LOG((CLOG_PRINT
+		"Usage: %s [options]\n"
+		"\n"
+		"Runs a server and a growing number of virtual clients over\n"
+		"loopback and reports server CPU use and latency.\n"
+		"\n"
+		"Options:\n"
+		"      --clients <n,n,...>        client counts to test in turn\n"
+		"                                   (default 1,10,50).\n"
+		"      --duration <s>             seconds to test each count\n"
+		"                                   (default 10).\n"
+		"      --mouse-rate <n>           mouse moves per second (default 125).\n"
+		"      --key-rate <n>             key presses per second (default 5).\n"
+		"      --switch-interval <s>      seconds between switching to a\n"
+		"                                   random client (default 2).\n"
+		"      --clipboard-interval <s>   seconds between copies (default 1).\n"
+		"      --enable-crypto            use the network security plugin.\n"
+		"                                   needs --clients 1.\n"
+		"      --storm                    connect all clients at once, as\n"
+		"                                   after a server restart.\n"
+		"      --io-threads <n>           spread the server's client\n"
+		"                                   connections over n threads\n"
+		"                                   (default 0, all on one).\n"
+		"      --port <port>              loopback port (default 24811).\n"
+		"  -d, --debug <level>            filter out log messages with a\n"
+		"                                   priority below level.",
+		name));
+}
+
+double
+LoadGen::getThreadCPUTime()
+{
+#if SYSAPI_WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+		return 0.0;
+	}
+	ULARGE_INTEGER k, u;
+	k.LowPart  = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart  = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+	return 1.0e-7 * static_cast<double>(k.QuadPart + u.QuadPart);
+#else
+	struct timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+		return 0.0;
+	}
+	return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+#endif
+}
+
+double
+LoadGen::getProcessCPUTime()
+{
+#if SYSAPI_WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+		return 0.0;
+	}
+	ULARGE_INTEGER k, u;
+	k.LowPart  = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart  = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+	return 1.0e-7 * static_cast<double>(k.QuadPart + u.QuadPart);
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0.0;
+	}
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+			1.0e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+#endif
+}
@@ -0,0 +1,155 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "synergy-loadgen/LoadStats.h"
+#include "synergy/key_types.h"
+#include "net/NetworkAddress.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stdvector.h"
+
+class ClientListener;
+class ClientPool;
+class Config;
+class Event;
+class EventQueueTimer;
+class IEventQueue;
+class PrimaryClient;
+class Server;
+class SocketMultiplexer;
+class VirtualScreen;
+namespace synergy { class Screen; }
+
+//! Multi-client load generator
+/*!
+Runs a server with a headless primary screen and, for each requested
+client count in turn, a \c ClientPool of that many virtual clients.
+While they are connected it generates typical input on the primary
+screen: steady mouse motion and typing, switching to a random client
+every so often, and clipboard copies, which the server announces to
+every client.  For each client count it reports the CPU used by the
+server's thread and the latency of input and of the clipboard fan-out.
+*/
+class LoadGen {
+public:
+	LoadGen(IEventQueue* events);
+	~LoadGen();
+
+	//! Parse the command line
+	/*!
+	Returns false and prints usage if the arguments are invalid.
+	*/
+	bool				parseArgs(int argc, const char* const* argv);
+
+	//! Run the load test
+	/*!
+	Runs the event loop until every client count has been tested and
+	returns an exit code.
+	*/
+	int					run();
+
+private:
+	enum EState {
+		kConnecting,
+		kRunning,
+		kDraining,
+		kSwitching,
+		kDisconnecting
+	};
+
+	void				startRun();
+	void				finishRun(double now);
+	void				stopRun();
+	void				report();
+	void				cleanup();
+
+	void				sendInput(double now, double elapsed);
+	void				sendMouseMove(double now);
+	void				sendKey(double now);
+	void				sendGrab(double now);
+	void				switchScreen();
+
+	void				handleTimer(const Event&, void*);
+	void				handleClientAccepted(const Event&, void*);
+
+	static void			usage(const char* name);
+	static double		getThreadCPUTime();
+	static double		getProcessCPUTime();
+
+private:
+	typedef std::vector<UInt32> ClientCounts;
+
+	IEventQueue*		m_events;
+
+	// options
+	ClientCounts		m_clientCounts;
+	double				m_duration;
+	double				m_mouseRate;
+	double				m_keyRate;
+	double				m_switchInterval;
+	double				m_clipboardInterval;
+	bool				m_enableCrypto;
+	bool				m_storm;
+	int					m_ioThreads;
+	int					m_port;
+	SInt32				m_width;
+	SInt32				m_height;
+
+	// the server
+	NetworkAddress		m_address;
+	SocketMultiplexer*	m_multiplexer;
+	Config*				m_config;
+	VirtualScreen*		m_virtualScreen;
+	synergy::Screen*	m_screen;
+	PrimaryClient*		m_primaryClient;
+	ClientListener*		m_listener;
+	Server*				m_server;
+
+	// the current run
+	size_t				m_run;
+	ClientPool*			m_pool;
+	LoadStats			m_stats;
+	EState				m_state;
+	EventQueueTimer*	m_timer;
+	double				m_stateTime;
+	double				m_connectTime;
+	double				m_lastTime;
+	double				m_startTime;
+	double				m_endTime;
+	double				m_threadCPUStart;
+	double				m_threadCPUEnd;
+	double				m_processCPUStart;
+	double				m_processCPUEnd;
+	bool				m_failed;
+
+	// input model
+	double				m_mouseCredit;
+	double				m_keyCredit;
+	double				m_nextSwitchTime;
+	double				m_nextGrabTime;
+	UInt32				m_active;
+	SInt32				m_x, m_y;
+	SInt32				m_sweepX, m_sweepY;
+	SInt32				m_sweepStep;
+	UInt32				m_keyCount;
+	bool				m_keyHeld;
+	KeyButton			m_keyButton;
+	UInt32				m_grabCount;
+};
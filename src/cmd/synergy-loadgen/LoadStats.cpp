@@ -0,0 +1,241 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy-loadgen/LoadStats.h"
+
+#include "mt/Lock.h"
+
+static
+UInt32
+toMicroseconds(double seconds)
+{
+	if (seconds <= 0.0) {
+		return 0;
+	}
+	return static_cast<UInt32>(seconds * 1.0e6 + 0.5);
+}
+
+//
+// LoadStats::Stream
+//
+
+LoadStats::Stream::Stream() :
+	m_sent(0),
+	m_received(0),
+	m_lost(0)
+{
+	// do nothing
+}
+
+void
+LoadStats::Stream::send(SInt32 a, SInt32 b, double time)
+{
+	Sent sent;
+	sent.m_a    = a;
+	sent.m_b    = b;
+	sent.m_time = time;
+	m_pending.push_back(sent);
+	++m_sent;
+}
+
+void
+LoadStats::Stream::receive(SInt32 a, SInt32 b, double time)
+{
+	// anything sent before the match was coalesced or lost on the way.
+	// anything unmatched wasn't sent by us (e.g. the move on entering a
+	// screen) and is ignored.
+	for (SentList::iterator i = m_pending.begin(); i != m_pending.end(); ++i) {
+		if (i->m_a == a && i->m_b == b) {
+			m_lost += static_cast<UInt32>(i - m_pending.begin());
+			++m_received;
+			m_latency.add(toMicroseconds(time - i->m_time));
+			m_pending.erase(m_pending.begin(), i + 1);
+			return;
+		}
+	}
+}
+
+void
+LoadStats::Stream::dropPending()
+{
+	m_lost += static_cast<UInt32>(m_pending.size());
+	m_pending.clear();
+}
+
+void
+LoadStats::Stream::reset()
+{
+	m_sent     = 0;
+	m_received = 0;
+	m_lost     = 0;
+	m_latency.reset();
+	m_pending.clear();
+}
+
+//
+// LoadStats
+//
+
+LoadStats::LoadStats() :
+	m_numClients(0),
+	m_grabTime(0.0),
+	m_grabReceived(0),
+	m_connectFailures(0),
+	m_turnedAway(0)
+{
+	// do nothing
+}
+
+void
+LoadStats::reset(UInt32 numClients)
+{
+	Lock lock(&m_mutex);
+	m_numClients   = numClients;
+	m_mouse.reset();
+	m_keys.reset();
+	m_fanOut.reset();
+	m_grabLatency.reset();
+	m_grabTime        = 0.0;
+	m_grabReceived    = 0;
+	m_connectFailures = 0;
+	m_turnedAway      = 0;
+}
+
+void
+LoadStats::sendMouseMove(SInt32 x, SInt32 y, double time)
+{
+	Lock lock(&m_mutex);
+	m_mouse.send(x, y, time);
+}
+
+void
+LoadStats::sendKey(SInt32 type, KeyButton button, double time)
+{
+	Lock lock(&m_mutex);
+	m_keys.send(type, button, time);
+}
+
+void
+LoadStats::sendGrab(double time)
+{
+	Lock lock(&m_mutex);
+	if (m_grabTime != 0.0) {
+		++m_fanOut.m_lost;
+	}
+	++m_fanOut.m_sent;
+	m_grabTime     = time;
+	m_grabReceived = 0;
+}
+
+void
+LoadStats::dropPending()
+{
+	Lock lock(&m_mutex);
+	m_mouse.dropPending();
+	m_keys.dropPending();
+}
+
+void
+LoadStats::receiveMouseMove(SInt32 x, SInt32 y, double time)
+{
+	Lock lock(&m_mutex);
+	m_mouse.receive(x, y, time);
+}
+
+void
+LoadStats::receiveKey(SInt32 type, KeyButton button, double time)
+{
+	Lock lock(&m_mutex);
+	m_keys.receive(type, button, time);
+}
+
+void
+LoadStats::receiveGrab(double time)
+{
+	Lock lock(&m_mutex);
+	if (m_grabTime == 0.0 || time < m_grabTime) {
+		return;
+	}
+
+	m_grabLatency.add(toMicroseconds(time - m_grabTime));
+	if (++m_grabReceived == m_numClients) {
+		++m_fanOut.m_received;
+		m_fanOut.m_latency.add(toMicroseconds(time - m_grabTime));
+		m_grabTime = 0.0;
+	}
+}
+
+void
+LoadStats::connectFailed(bool turnedAway)
+{
+	Lock lock(&m_mutex);
+	++m_connectFailures;
+	if (turnedAway) {
+		++m_turnedAway;
+	}
+}
+
+UInt32
+LoadStats::getOutstanding() const
+{
+	Lock lock(&m_mutex);
+	return static_cast<UInt32>(m_mouse.m_pending.size() +
+								m_keys.m_pending.size());
+}
+
+LoadStats::Stream
+LoadStats::getMouse() const
+{
+	Lock lock(&m_mutex);
+	return m_mouse;
+}
+
+LoadStats::Stream
+LoadStats::getKeys() const
+{
+	Lock lock(&m_mutex);
+	return m_keys;
+}
+
+LoadStats::Stream
+LoadStats::getFanOut() const
+{
+	Lock lock(&m_mutex);
+	return m_fanOut;
+}
+
+Histogram
+LoadStats::getGrabLatency() const
+{
+	Lock lock(&m_mutex);
+	return m_grabLatency;
+}
+
+UInt32
+LoadStats::getConnectFailures() const
+{
+	Lock lock(&m_mutex);
+	return m_connectFailures;
+}
+
+UInt32
+LoadStats::getTurnedAway() const
+{
+	Lock lock(&m_mutex);
+	return m_turnedAway;
+}
@@ -0,0 +1,144 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "synergy/key_types.h"
+#include "mt/Mutex.h"
+#include "base/Histogram.h"
+#include "common/basic_types.h"
+#include "common/stddeque.h"
+
+//! Load test results
+/*!
+Input is generated on the server's thread and arrives on the clients'
+thread, so the events in flight and the latencies measured are kept
+here under a mutex.  Mouse moves and keys are matched to what was sent
+by value.  A clipboard grab is sent to every client, so each one is
+timed separately and the fan-out is complete when the last arrives.
+*/
+class LoadStats {
+public:
+	//! Results for one kind of event
+	class Stream {
+	public:
+		class Sent {
+		public:
+			SInt32		m_a;
+			SInt32		m_b;
+			double		m_time;
+		};
+		typedef std::deque<Sent> SentList;
+
+		Stream();
+
+		void			send(SInt32 a, SInt32 b, double time);
+		void			receive(SInt32 a, SInt32 b, double time);
+		void			dropPending();
+		void			reset();
+
+	public:
+		UInt32			m_sent;
+		UInt32			m_received;
+		UInt32			m_lost;
+		Histogram		m_latency;
+		SentList		m_pending;
+	};
+
+	LoadStats();
+
+	//! @name manipulators
+	//@{
+
+	//! Start again with \p numClients clients
+	void				reset(UInt32 numClients);
+
+	//! Record a mouse move sent to position \p x,\p y
+	void				sendMouseMove(SInt32 x, SInt32 y, double time);
+
+	//! Record a key event of VirtualScreen::Input type \p type sent
+	void				sendKey(SInt32 type, KeyButton button, double time);
+
+	//! Record a clipboard grab sent to all clients
+	/*!
+	A previous grab that hasn't reached every client yet is counted as
+	lost.
+	*/
+	void				sendGrab(double time);
+
+	//! Count all mouse moves and keys in flight as lost
+	void				dropPending();
+
+	//! Record a mouse move arriving at position \p x,\p y
+	void				receiveMouseMove(SInt32 x, SInt32 y, double time);
+
+	//! Record a key event arriving
+	void				receiveKey(SInt32 type, KeyButton button, double time);
+
+	//! Record a clipboard grab arriving at one client
+	void				receiveGrab(double time);
+
+	//! Record a client connection attempt that failed
+	/*!
+	\p turnedAway is true if the server asked the client to retry later.
+	*/
+	void				connectFailed(bool turnedAway);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the number of mouse moves and keys in flight
+	UInt32				getOutstanding() const;
+
+	//! Get the mouse move results
+	Stream				getMouse() const;
+
+	//! Get the key results
+	Stream				getKeys() const;
+
+	//! Get the clipboard grab results
+	/*!
+	Counts are of grabs that reached every client.  The latency is the
+	time for the last client to receive each grab.
+	*/
+	Stream				getFanOut() const;
+
+	//! Get the latency of clipboard grabs to each client
+	Histogram			getGrabLatency() const;
+
+	//! Get the number of failed connection attempts
+	UInt32				getConnectFailures() const;
+
+	//! Get the number of connection attempts the server turned away
+	UInt32				getTurnedAway() const;
+
+	//@}
+
+private:
+	Mutex				m_mutex;
+	UInt32				m_numClients;
+	Stream				m_mouse;
+	Stream				m_keys;
+	Stream				m_fanOut;
+	Histogram			m_grabLatency;
+	double				m_grabTime;
+	UInt32				m_grabReceived;
+	UInt32				m_connectFailures;
+	UInt32				m_turnedAway;
+};
@@ -24,6 +24,7 @@ SOURCES += src/main.cpp \
     src/ScreenSetupView.cpp \
     src/Screen.cpp \
     src/ScreenSetupModel.cpp \
+    src/LogModel.cpp \
     src/NewScreenWidget.cpp \
     src/TrashScreenWidget.cpp \
     src/ScreenSettingsDialog.cpp \
@@ -63,6 +64,7 @@ HEADERS += src/MainWindow.h \
     src/ScreenSetupView.h \
     src/Screen.h \
     src/ScreenSetupModel.h \
+    src/LogModel.h \
     src/NewScreenWidget.h \
     src/TrashScreenWidget.h \
     src/ScreenSettingsDialog.h \
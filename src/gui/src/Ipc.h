@@ -22,12 +22,15 @@
 
 #define IPC_HOST "127.0.0.1"
 #define IPC_PORT 24801
+#define IPC_SOCKET_NAME "ipc.sock"
 
 enum qIpcMessageType {
 	kIpcHello,
 	kIpcLogLine,
 	kIpcCommand,
 	kIpcShutdown,
+	kIpcMetrics,
+	kIpcLogBatch,
 };
 
 enum qIpcClientType {
@@ -40,3 +43,5 @@ extern const char*		kIpcMsgHello;
 extern const char*		kIpcMsgLogLine;
 extern const char*		kIpcMsgCommand;
 extern const char*		kIpcMsgShutdown;
+extern const char*		kIpcMsgMetrics;
+extern const char*		kIpcMsgLogBatch;
@@ -18,7 +18,9 @@
 
 #include "IpcClient.h"
 #include <QTcpSocket>
+#include <QLocalSocket>
 #include <QHostAddress>
+#include <QDir>
 #include <iostream>
 #include <QTimer>
 #include "IpcReader.h"
@@ -29,12 +31,20 @@ IpcClient::IpcClient() :
 m_ReaderStarted(false),
 m_Enabled(false)
 {
+#if defined(Q_OS_WIN)
 	m_Socket = new QTcpSocket(this);
 	connect(m_Socket, SIGNAL(connected()), this, SLOT(connected()));
 	connect(m_Socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(error(QAbstractSocket::SocketError)));
+#else
+	// the daemon listens on a unix domain socket in the profile directory
+	m_Socket = new QLocalSocket(this);
+	connect(m_Socket, SIGNAL(connected()), this, SLOT(connected()));
+	connect(m_Socket, SIGNAL(error(QLocalSocket::LocalSocketError)), this, SLOT(localError(QLocalSocket::LocalSocketError)));
+#endif
 
 	m_Reader = new IpcReader(m_Socket);
 	connect(m_Reader, SIGNAL(readLogLine(const QString&)), this, SLOT(handleReadLogLine(const QString&)));
+	connect(m_Reader, SIGNAL(readMetrics(const QString&)), this, SIGNAL(readMetrics(const QString&)));
 }
 
 IpcClient::~IpcClient()
@@ -52,7 +62,15 @@ void IpcClient::connectToHost()
 	m_Enabled = true;
 
 	infoMessage("connecting to service...");
-	m_Socket->connectToHost(QHostAddress(QHostAddress::LocalHost), IPC_PORT);
+#if defined(Q_OS_WIN)
+	static_cast<QTcpSocket*>(m_Socket)->connectToHost(QHostAddress(QHostAddress::LocalHost), IPC_PORT);
+#elif defined(Q_OS_MAC)
+	static_cast<QLocalSocket*>(m_Socket)->connectToServer(
+		QDir::homePath() + "/Library/Synergy/" + IPC_SOCKET_NAME);
+#else
+	static_cast<QLocalSocket*>(m_Socket)->connectToServer(
+		QDir::homePath() + "/.synergy/" + IPC_SOCKET_NAME);
+#endif
 
 	if (!m_ReaderStarted) {
 		m_Reader->start();
@@ -81,6 +99,21 @@ void IpcClient::error(QAbstractSocket::SocketError error)
 	QTimer::singleShot(1000, this, SLOT(retryConnect()));
 }
 
+void IpcClient::localError(QLocalSocket::LocalSocketError error)
+{
+	QString text;
+	switch (error) {
+		case QLocalSocket::ConnectionRefusedError:
+		case QLocalSocket::ServerNotFoundError: text = "connection refused"; break;
+		case QLocalSocket::PeerClosedError: text = "remote host closed"; break;
+		default: text = QString("code=%1").arg(error); break;
+	}
+
+	errorMessage(QString("ipc connection error, %1").arg(text));
+
+	QTimer::singleShot(1000, this, SLOT(retryConnect()));
+}
+
 void IpcClient::retryConnect()
 {
 	if (m_Enabled) {
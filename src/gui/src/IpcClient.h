@@ -20,8 +20,9 @@
 
 #include <QObject>
 #include <QAbstractSocket>
+#include <QLocalSocket>
 
-class QTcpSocket;
+class QIODevice;
 class IpcReader;
 
 class IpcClient : public QObject
@@ -46,15 +47,18 @@ private:
 private slots:
 	void connected();
 	void error(QAbstractSocket::SocketError error);
+	void localError(QLocalSocket::LocalSocketError error);
 	void handleReadLogLine(const QString& text);
 
 signals:
 	void readLogLine(const QString& text);
+	void readMetrics(const QString& text);
 	void infoMessage(const QString& text);
 	void errorMessage(const QString& text);
 
 private:
-	QTcpSocket* m_Socket;
+	// a QTcpSocket on windows, otherwise a QLocalSocket
+	QIODevice* m_Socket;
 	IpcReader* m_Reader;
 	bool m_ReaderStarted;
 	bool m_Enabled;
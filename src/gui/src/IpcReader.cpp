@@ -17,13 +17,14 @@
  */
 
 #include "IpcReader.h"
-#include <QTcpSocket>
+#include <QIODevice>
 #include "Ipc.h"
 #include <iostream>
 #include <QMutex>
 #include <QByteArray>
+#include <QStringList>
 
-IpcReader::IpcReader(QTcpSocket* socket) :
+IpcReader::IpcReader(QIODevice* socket) :
 m_Socket(socket)
 {
 }
@@ -69,6 +70,49 @@ void IpcReader::read()
 
 			readLogLine(line);
 		}
+		else if (memcmp(codeBuf, kIpcMsgLogBatch, 4) == 0) {
+			char droppedBuf[4];
+			readStream(droppedBuf, 4);
+			int dropped = bytesToInt(droppedBuf, 4);
+
+			char lenBuf[4];
+			readStream(lenBuf, 4);
+			int len = bytesToInt(lenBuf, 4);
+
+			char* data = new char[len];
+			readStream(data, len);
+
+			// each line is framed with a 4 byte length
+			QStringList lines;
+			if (dropped > 0) {
+				lines.append(QString("WARNING: %1 log lines dropped").arg(dropped));
+			}
+			int offset = 0;
+			while (len - offset >= 4) {
+				int lineLen = bytesToInt(data + offset, 4);
+				offset += 4;
+				if (lineLen > len - offset) {
+					break;
+				}
+				lines.append(QString::fromUtf8(data + offset, lineLen));
+				offset += lineLen;
+			}
+			delete[] data;
+
+			readLogLine(lines.join("\n"));
+		}
+		else if (memcmp(codeBuf, kIpcMsgMetrics, 4) == 0) {
+			char lenBuf[4];
+			readStream(lenBuf, 4);
+			int len = bytesToInt(lenBuf, 4);
+
+			char* data = new char[len];
+			readStream(data, len);
+			QString metrics = QString::fromUtf8(data, len);
+			delete[] data;
+
+			readMetrics(metrics);
+		}
 		else {
 			std::cerr << "aborting, message invalid" << std::endl;
 			return;
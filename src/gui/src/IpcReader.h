@@ -21,20 +21,21 @@
 #include <QObject>
 #include <QMutex>
 
-class QTcpSocket;
+class QIODevice;
 
 class IpcReader : public QObject
 {
 	Q_OBJECT;
 
 public:
-	IpcReader(QTcpSocket* socket);
+	IpcReader(QIODevice* socket);
 	virtual ~IpcReader();
 	void start();
 	void stop();
 
 signals:
 	void readLogLine(const QString& text);
+	void readMetrics(const QString& text);
 
 private:
 	bool readStream(char* buffer, int length);
@@ -44,6 +45,6 @@ private slots:
 	void read();
 
 private:
-	QTcpSocket* m_Socket;
+	QIODevice* m_Socket;
 	QMutex m_Mutex;
 };
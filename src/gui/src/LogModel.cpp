@@ -0,0 +1,250 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "LogModel.h"
+
+#include <QtAlgorithms>
+
+// names of levels, as printed by the synergy logger
+static const char* const kLevelNames[] =
+{
+	"FATAL",
+	"ERROR",
+	"WARNING",
+	"NOTE",
+	"INFO",
+	"DEBUG",
+	"DEBUG1",
+	"DEBUG2",
+	"DEBUG3",
+	"DEBUG4",
+	"DEBUG5"
+};
+
+static const int kNumLevels = (int)(sizeof(kLevelNames) / sizeof(kLevelNames[0]));
+
+LogModel::LogModel(QObject* parent, int capacity) :
+	QAbstractListModel(parent),
+	m_Lines(capacity),
+	m_Capacity(capacity),
+	m_First(0),
+	m_End(0),
+	m_LastLevel(kPrint),
+	m_RowsBegin(0),
+	m_Skipped(0),
+	m_LevelFilter(kAllLevels)
+{
+	m_FlushTimer.setSingleShot(true);
+	m_FlushTimer.setInterval(kFrameInterval);
+	connect(&m_FlushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+void LogModel::append(const QString& line)
+{
+	m_Pending.append(line);
+
+	// lines beyond the capacity would be overwritten by this same
+	// flush, so never hold on to them
+	if (m_Pending.size() > m_Capacity)
+	{
+		m_Pending.removeFirst();
+		m_Skipped++;
+	}
+
+	if (!m_FlushTimer.isActive())
+		m_FlushTimer.start();
+}
+
+void LogModel::clear()
+{
+	beginResetModel();
+	m_Lines.fill(Line());
+	m_First = m_End;
+	m_LastLevel = kPrint;
+	m_Rows.clear();
+	m_RowsBegin = 0;
+	m_Pending.clear();
+	m_Skipped = 0;
+	endResetModel();
+}
+
+QString LogModel::text(const QModelIndexList& indexes) const
+{
+	QList<int> rows;
+	foreach (const QModelIndex& index, indexes)
+	{
+		if (index.isValid() && index.row() < rowCount())
+			rows.append(index.row());
+	}
+	qSort(rows);
+
+	QStringList lines;
+	foreach (int r, rows)
+		lines.append(line(row(r)).m_Text);
+
+	return lines.join("\n");
+}
+
+int LogModel::rowCount(const QModelIndex& parent) const
+{
+	if (parent.isValid())
+		return 0;
+
+	return m_Rows.size() - m_RowsBegin;
+}
+
+QVariant LogModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= rowCount())
+		return QVariant();
+
+	if (role == Qt::DisplayRole)
+		return line(row(index.row())).m_Text;
+
+	return QVariant();
+}
+
+int LogModel::parseLevel(const QString& line, int previous)
+{
+	// debug builds put the file and line on an indented line of its own
+	if (line.isEmpty() || line[0].isSpace())
+		return previous;
+
+	// the level is either the first word or follows the timestamp
+	int start = 0;
+	for (int word = 0; word < 2; word++)
+	{
+		int end = line.indexOf(' ', start);
+		if (end < 0)
+			break;
+
+		if (end > start + 1 && line[end - 1] == ':')
+		{
+			QStringRef name = line.midRef(start, end - start - 1);
+			for (int i = 0; i < kNumLevels; i++)
+			{
+				if (name == QLatin1String(kLevelNames[i]))
+					return i;
+			}
+		}
+
+		start = end + 1;
+	}
+
+	return kPrint;
+}
+
+void LogModel::setLevelFilter(int level)
+{
+	if (level == m_LevelFilter)
+		return;
+
+	m_LevelFilter = level;
+	rebuildRows();
+}
+
+void LogModel::setSearchText(const QString& text)
+{
+	if (text == m_SearchText)
+		return;
+
+	m_SearchText = text;
+	rebuildRows();
+}
+
+void LogModel::flush()
+{
+	m_FlushTimer.stop();
+	if (m_Pending.isEmpty())
+		return;
+
+	qint64 end = m_End + m_Skipped + m_Pending.size();
+	qint64 first = qMax(m_First, end - m_Capacity);
+	m_Skipped = 0;
+
+	// forget the rows whose lines are about to be overwritten
+	int stale = 0;
+	while (stale < rowCount() && row(stale) < first)
+		stale++;
+	dropRows(stale);
+	m_First = first;
+
+	QVector<qint64> added;
+	qint64 seq = end - m_Pending.size();
+	foreach (const QString& text, m_Pending)
+	{
+		Line& l = line(seq);
+		l.m_Text = text;
+		l.m_Level = parseLevel(text, m_LastLevel);
+		m_LastLevel = l.m_Level;
+
+		if (accepts(l))
+			added.append(seq);
+
+		seq++;
+	}
+	m_End = end;
+	m_Pending.clear();
+
+	if (!added.isEmpty())
+	{
+		int count = rowCount();
+		beginInsertRows(QModelIndex(), count, count + added.size() - 1);
+		m_Rows += added;
+		endInsertRows();
+	}
+}
+
+bool LogModel::accepts(const Line& line) const
+{
+	if (line.m_Level > m_LevelFilter)
+		return false;
+
+	return m_SearchText.isEmpty() ||
+		line.m_Text.contains(m_SearchText, Qt::CaseInsensitive);
+}
+
+void LogModel::dropRows(int count)
+{
+	if (count == 0)
+		return;
+
+	beginRemoveRows(QModelIndex(), 0, count - 1);
+	m_RowsBegin += count;
+
+	// compact once the dropped prefix outgrows the live rows
+	if (m_RowsBegin > m_Rows.size() / 2)
+	{
+		m_Rows.remove(0, m_RowsBegin);
+		m_RowsBegin = 0;
+	}
+	endRemoveRows();
+}
+
+void LogModel::rebuildRows()
+{
+	beginResetModel();
+	m_Rows.clear();
+	m_RowsBegin = 0;
+	for (qint64 seq = m_First; seq < m_End; seq++)
+	{
+		if (accepts(line(seq)))
+			m_Rows.append(seq);
+	}
+	endResetModel();
+}
@@ -0,0 +1,115 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+//! Bounded log line model
+/*!
+Holds the most recent log lines in a fixed size ring so memory stays
+flat however much synergys/c logs.  Lines are queued by append() and
+only handed to the view once per frame, which turns thousands of
+inserts per second into a single insert and repaint.  The level filter
+and search text are applied here, so the view only ever sees the rows
+it has to draw.
+*/
+class LogModel : public QAbstractListModel
+{
+	Q_OBJECT
+
+public:
+	enum ELevel {
+		kPrint = -1,
+		kFatal,
+		kError,
+		kWarning,
+		kNote,
+		kInfo,
+		kDebug,
+		kDebug1,
+		kDebug2,
+		kDebug3,
+		kDebug4,
+		kDebug5,
+		kAllLevels = kDebug5
+	};
+
+	enum {
+		kDefaultCapacity = 100000,
+		kFrameInterval = 33 // ms, about 30 frames per second
+	};
+
+public:
+	LogModel(QObject* parent = NULL, int capacity = kDefaultCapacity);
+
+	void append(const QString& line);
+	void clear();
+	bool isEmpty() const { return m_End == m_First && m_Pending.isEmpty(); }
+	QString text(const QModelIndexList& indexes) const;
+	int levelFilter() const { return m_LevelFilter; }
+	const QString& searchText() const { return m_SearchText; }
+
+	int rowCount(const QModelIndex& parent = QModelIndex()) const;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+
+	static int parseLevel(const QString& line, int previous);
+
+public slots:
+	void setLevelFilter(int level);
+	void setSearchText(const QString& text);
+	void flush();
+
+private:
+	struct Line
+	{
+		QString m_Text;
+		int m_Level;
+	};
+
+	const Line& line(qint64 seq) const { return m_Lines[seq % m_Capacity]; }
+	Line& line(qint64 seq) { return m_Lines[seq % m_Capacity]; }
+	qint64 row(int index) const { return m_Rows[m_RowsBegin + index]; }
+	bool accepts(const Line& line) const;
+	void dropRows(int count);
+	void rebuildRows();
+
+private:
+	// ring of lines, addressed by a sequence number that never wraps
+	QVector<Line> m_Lines;
+	int m_Capacity;
+	qint64 m_First;
+	qint64 m_End;
+	int m_LastLevel;
+
+	// sequence numbers of the lines that pass the filters; rows are
+	// dropped from the front by advancing m_RowsBegin
+	QVector<qint64> m_Rows;
+	int m_RowsBegin;
+
+	// lines waiting for the next frame
+	QStringList m_Pending;
+	qint64 m_Skipped;
+	QTimer m_FlushTimer;
+
+	int m_LevelFilter;
+	QString m_SearchText;
+};
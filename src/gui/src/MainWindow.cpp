@@ -41,6 +41,9 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QDesktopServices>
+#include <QApplication>
+#include <QClipboard>
+#include <QScrollBar>
 
 #if defined(Q_OS_MAC)
 #include <ApplicationServices/ApplicationServices.h>
@@ -92,10 +95,13 @@ MainWindow::MainWindow(QSettings& settings, AppConfig& appConfig) :
 	m_pCancelButton(NULL),
 	m_SuppressAutoConfigWarning(false),
 	m_BonjourInstall(NULL),
-	m_SuppressEmptyServerWarning(false)
+	m_SuppressEmptyServerWarning(false),
+	m_LogAtBottom(true)
 {
 	setupUi(this);
 
+	m_pLogOutput->setModel(&m_LogModel);
+
 	createMenuBar();
 	loadSettings();
 	initConnections();
@@ -108,6 +114,7 @@ MainWindow::MainWindow(QSettings& settings, AppConfig& appConfig) :
 #if defined(Q_OS_WIN)
 	// ipc must always be enabled, so that we can disable command when switching to desktop mode.
 	connect(&m_IpcClient, SIGNAL(readLogLine(const QString&)), this, SLOT(appendLogRaw(const QString&)));
+	connect(&m_IpcClient, SIGNAL(readMetrics(const QString&)), this, SLOT(updateMetrics(const QString&)));
 	connect(&m_IpcClient, SIGNAL(errorMessage(const QString&)), this, SLOT(appendLogError(const QString&)));
 	connect(&m_IpcClient, SIGNAL(infoMessage(const QString&)), this, SLOT(appendLogNote(const QString&)));
 	m_IpcClient.connectToHost();
@@ -201,6 +208,18 @@ void MainWindow::setStatus(const QString &status)
 	m_pStatusLabel->setText(status);
 }
 
+void MainWindow::updateMetrics(const QString& text)
+{
+	// show the latest metrics from synergys/c when hovering over the status
+	QStringList lines;
+	foreach (QString line, text.split("\n", QString::SkipEmptyParts)) {
+		if (!line.startsWith("#")) {
+			lines.append(line);
+		}
+	}
+	m_pStatusLabel->setToolTip(lines.join("\n"));
+}
+
 void MainWindow::createTrayIcon()
 {
 	m_pTrayIconMenu = new QMenu(this);
@@ -285,6 +304,14 @@ void MainWindow::initConnections()
 	connect(m_pActionStopSynergy, SIGNAL(triggered()), this, SLOT(stopSynergy()));
 	connect(m_pActionQuit, SIGNAL(triggered()), qApp, SLOT(quit()));
 	connect(&m_VersionChecker, SIGNAL(updateFound(const QString&)), this, SLOT(updateFound(const QString&)));
+	connect(&m_LogModel, SIGNAL(rowsAboutToBeInserted(const QModelIndex&, int, int)), this, SLOT(logRowsAboutToBeInserted()));
+	connect(&m_LogModel, SIGNAL(rowsInserted(const QModelIndex&, int, int)), this, SLOT(logRowsInserted()));
+
+	QAction* copyAction = new QAction(tr("&Copy"), m_pLogOutput);
+	copyAction->setShortcut(QKeySequence::Copy);
+	copyAction->setShortcutContext(Qt::WidgetShortcut);
+	m_pLogOutput->addAction(copyAction);
+	connect(copyAction, SIGNAL(triggered()), this, SLOT(copyLog()));
 }
 
 void MainWindow::saveSettings()
@@ -380,7 +407,7 @@ void MainWindow::appendLogRaw(const QString& text)
 {
 	foreach(QString line, text.split(QRegExp("\r|\n|\r\n"))) {
 		if (!line.isEmpty()) {
-			m_pLogOutput->append(line);
+			m_LogModel.append(line);
 			updateStateFromLogLine(line);
 		}
 	}
@@ -399,7 +426,39 @@ void MainWindow::updateStateFromLogLine(const QString &line)
 
 void MainWindow::clearLog()
 {
-	m_pLogOutput->clear();
+	m_LogModel.clear();
+}
+
+void MainWindow::logRowsAboutToBeInserted()
+{
+	// only follow the log if the user hasn't scrolled up to read it
+	QScrollBar* scrollBar = m_pLogOutput->verticalScrollBar();
+	m_LogAtBottom = scrollBar->value() == scrollBar->maximum();
+}
+
+void MainWindow::logRowsInserted()
+{
+	if (m_LogAtBottom)
+		m_pLogOutput->scrollToBottom();
+}
+
+void MainWindow::copyLog()
+{
+	QString text = m_LogModel.text(m_pLogOutput->selectionModel()->selectedIndexes());
+	if (!text.isEmpty())
+		QApplication::clipboard()->setText(text);
+}
+
+void MainWindow::on_m_pComboLogLevel_currentIndexChanged(int index)
+{
+	// "All" is the first entry, the rest follow the log levels from
+	// ERROR to DEBUG5 so each entry's index is its level
+	m_LogModel.setLevelFilter(index == 0 ? LogModel::kAllLevels : index);
+}
+
+void MainWindow::on_m_pLineEditLogSearch_textChanged(const QString& text)
+{
+	m_LogModel.setSearchText(text);
 }
 
 void MainWindow::startSynergy()
@@ -472,7 +531,7 @@ void MainWindow::startSynergy()
 	}
 
 	// put a space between last log output and new instance.
-	if (!m_pLogOutput->toPlainText().isEmpty())
+	if (!m_LogModel.isEmpty())
 		appendLogRaw("");
 
 	appendLogNote("starting " + QString(synergyType() == synergyServer ? "server" : "client"));
@@ -33,6 +33,7 @@
 #include "VersionChecker.h"
 #include "IpcClient.h"
 #include "Ipc.h"
+#include "LogModel.h"
 
 #include <QMutex>
 
@@ -109,6 +110,7 @@ class MainWindow : public QMainWindow, public Ui::MainWindowBase
 
 	public slots:
 		void appendLogRaw(const QString& text);
+		void updateMetrics(const QString& text);
 		void appendLogNote(const QString& text);
 		void appendLogDebug(const QString& text);
 		void appendLogError(const QString& text);
@@ -130,6 +132,9 @@ class MainWindow : public QMainWindow, public Ui::MainWindowBase
 		void logError();
 		void updateFound(const QString& version);
 		void bonjourInstallFinished();
+		void logRowsAboutToBeInserted();
+		void logRowsInserted();
+		void copyLog();
 
 	protected:
 		QSettings& settings() { return m_Settings; }
@@ -193,12 +198,16 @@ class MainWindow : public QMainWindow, public Ui::MainWindowBase
 		bool m_SuppressAutoConfigWarning;
 		CommandProcess* m_BonjourInstall;
 		bool m_SuppressEmptyServerWarning;
+		LogModel m_LogModel;
+		bool m_LogAtBottom;
 
 private slots:
 	void on_m_pCheckBoxAutoConfig_toggled(bool checked);
 	void on_m_pComboServerList_currentIndexChanged(QString );
 	void on_m_pButtonApply_clicked();
 	void installBonjour();
+	void on_m_pComboLogLevel_currentIndexChanged(int index);
+	void on_m_pLineEditLogSearch_textChanged(const QString& text);
 };
 
 #endif
@@ -195,12 +195,43 @@ public:
 
 	//! Change thread priority
 	/*!
-	Changes the priority of \c thread by \c n.  If \c n is positive
-	the thread has a lower priority and if negative a higher priority.
-	Some architectures may not support either or both directions.
+	Sets the priority of \c thread to \c n levels from normal.  If \c n
+	is positive the thread has a lower priority and if negative a higher
+	priority.  What a level is depends on the architecture;  on Windows
+	the higher levels move the whole process into the high and then the
+	real-time priority class.  Some architectures may not support either
+	or both directions.
 	*/
 	virtual void		setPriorityOfThread(ArchThread, int n) = 0;
 
+	//! Set thread niceness
+	/*!
+	Sets the niceness of \c thread to \c nice, from -20 (most favored)
+	to 19 (least favored) with 0 normal, as with the Unix nice value.
+	The thread stays in the normal scheduling class.  Architectures
+	without a per-thread nice value use the nearest thread priority
+	within the process's priority class.  Raising the priority may not
+	be permitted and is then limited to what is.
+	*/
+	virtual void		setNiceOfThread(ArchThread, int nice) = 0;
+
+	//! Use real-time scheduling for thread
+	/*!
+	Moves \c thread into a real-time scheduling class at \c priority
+	(1 is the lowest real-time priority).  Returns false if real-time
+	scheduling isn't supported or permitted, leaving the thread's
+	scheduling unchanged.
+	*/
+	virtual bool		setRealtimePriorityOfThread(ArchThread,
+							int priority) = 0;
+
+	//! Bind thread to a CPU
+	/*!
+	Restricts \c thread to run only on CPU number \c cpu.  Returns
+	false if that isn't supported or \c cpu doesn't exist.
+	*/
+	virtual bool		setAffinityOfThread(ArchThread, int cpu) = 0;
+
 	//! Cancellation point
 	/*!
 	This method does nothing but is a cancellation point.  Clients
@@ -64,6 +64,7 @@ public:
 	enum EAddressFamily {
 		kUNKNOWN,
 		kINET,
+		kUNIX		//!< Unix domain (not supported everywhere)
 	};
 
 	//! Supported socket types
@@ -236,12 +237,28 @@ public:
 	*/
 	virtual bool		setReuseAddrOnSocket(ArchSocket, bool reuse) = 0;
 
+	//! Check the user at the other end of a socket
+	/*!
+	Returns true if the peer of the connected unix domain socket \c s
+	is running as the same user as this process or as the superuser.
+	Returns false for any other socket, or if the platform can't tell.
+	*/
+	virtual bool		isPeerTrustedOnSocket(ArchSocket s) = 0;
+
 	//! Return local host's name
 	virtual std::string		getHostName() = 0;
 
 	//! Create an "any" network address
 	virtual ArchNetAddress	newAnyAddr(EAddressFamily) = 0;
 
+	//! Create a unix domain address
+	/*!
+	Returns the address of the unix domain socket at \c path.  Throws
+	XArchNetworkSupport if unix domain sockets aren't supported and
+	XArchNetworkName if the path is too long.
+	*/
+	virtual ArchNetAddress	newUnixAddr(const std::string& path) = 0;
+
 	//! Copy a network address
 	virtual ArchNetAddress	copyAddr(ArchNetAddress) = 0;
 
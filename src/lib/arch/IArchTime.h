@@ -33,7 +33,9 @@ public:
 	//! Get the current time
 	/*!
 	Returns the number of seconds since some arbitrary starting time.
-	This should return as high a precision as reasonable.
+	This should return as high a precision as reasonable.  The clock
+	is monotonic where the platform provides one so it is suitable for
+	measuring intervals but not for telling the time of day.
 	*/
 	virtual double		time() = 0;
 
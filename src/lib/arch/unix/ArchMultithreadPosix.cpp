@@ -18,16 +18,24 @@
 
 #include "arch/unix/ArchMultithreadPosix.h"
 
+#include "arch/unix/ArchWakeupUnix.h"
 #include "arch/Arch.h"
 #include "arch/XArch.h"
 
 #include <signal.h>
+#include <sched.h>
+#include <sys/resource.h>
+#if defined(__linux__)
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
 #if TIME_WITH_SYS_TIME
 #	include <sys/time.h>
 #	include <time.h>
 #else
 #	if HAVE_SYS_TIME_H
 #		include <sys/time.h>
+#		include <time.h>
 #	else
 #		include <time.h>
 #	endif
@@ -36,6 +44,13 @@
 
 #define SIGWAKEUP SIGUSR1
 
+// condition variable timeouts are measured against the monotonic clock
+// where the platform allows it so that stepping the wall clock neither
+// stalls nor prematurely expires a timed wait.
+#if HAVE_CLOCK_GETTIME && HAVE_PTHREAD_CONDATTR_SETCLOCK && defined(CLOCK_MONOTONIC)
+#	define SYNERGY_CONDVAR_MONOTONIC 1
+#endif
+
 #if !HAVE_PTHREAD_SIGNAL
 	// boy, is this platform broken.  forget about pthread signal
 	// handling and let signals through to every process.  synergy
@@ -47,6 +62,31 @@
 #	define HAVE_POSIX_SIGWAIT 1
 #endif
 
+static
+int
+getCurrentTID()
+{
+#if defined(__linux__)
+	return static_cast<int>(syscall(SYS_gettid));
+#else
+	return 0;
+#endif
+}
+
+static
+void
+getCondVarTime(struct timespec* now)
+{
+#if SYNERGY_CONDVAR_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, now);
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	now->tv_sec  = tv.tv_sec;
+	now->tv_nsec = tv.tv_usec * 1000;
+#endif
+}
+
 static
 void
 setSignalSet(sigset_t* sigset)
@@ -65,6 +105,7 @@ setSignalSet(sigset_t* sigset)
 class ArchThreadImpl {
 public:
 	ArchThreadImpl();
+	~ArchThreadImpl();
 
 public:
 	int					m_refCount;
@@ -76,7 +117,8 @@ public:
 	bool				m_cancelling;
 	bool				m_exited;
 	void*				m_result;
-	void*				m_networkData;
+	ArchWakeupUnix*		m_wakeup;
+	int					m_tid;			// kernel thread id, 0 if unknown
 };
 
 ArchThreadImpl::ArchThreadImpl() :
@@ -88,11 +130,17 @@ ArchThreadImpl::ArchThreadImpl() :
 	m_cancelling(false),
 	m_exited(false),
 	m_result(NULL),
-	m_networkData(NULL)
+	m_wakeup(NULL),
+	m_tid(0)
 {
 	// do nothing
 }
 
+ArchThreadImpl::~ArchThreadImpl()
+{
+	delete m_wakeup;
+}
+
 
 //
 // ArchMultithreadPosix
@@ -121,6 +169,7 @@ ArchMultithreadPosix::ArchMultithreadPosix() :
 	// list.  no need to lock the mutex since we're the only thread.
 	m_mainThread           = new ArchThreadImpl;
 	m_mainThread->m_thread = pthread_self();
+	m_mainThread->m_tid    = getCurrentTID();
 	insert(m_mainThread);
 
 	// install SIGWAKEUP handler.  this causes SIGWAKEUP to interrupt
@@ -157,22 +206,18 @@ ArchMultithreadPosix::~ArchMultithreadPosix()
 	s_instance = NULL;
 }
 
-void
-ArchMultithreadPosix::setNetworkDataForCurrentThread(void* data)
+ArchWakeupUnix*
+ArchMultithreadPosix::getWakeupForThread(ArchThread thread)
 {
-	lockMutex(m_threadMutex);
-	ArchThreadImpl* thread = find(pthread_self());
-	thread->m_networkData = data;
-	unlockMutex(m_threadMutex);
-}
+	assert(thread != NULL);
 
-void*
-ArchMultithreadPosix::getNetworkDataForThread(ArchThread thread)
-{
 	lockMutex(m_threadMutex);
-	void* data = thread->m_networkData;
+	if (thread->m_wakeup == NULL) {
+		thread->m_wakeup = new ArchWakeupUnix;
+	}
+	ArchWakeupUnix* wakeup = thread->m_wakeup;
 	unlockMutex(m_threadMutex);
-	return data;
+	return wakeup;
 }
 
 ArchMultithreadPosix*
@@ -185,9 +230,20 @@ ArchCond
 ArchMultithreadPosix::newCondVar()
 {
 	ArchCondImpl* cond = new ArchCondImpl;
+#if SYNERGY_CONDVAR_MONOTONIC
+	pthread_condattr_t attr;
+	int status = pthread_condattr_init(&attr);
+	assert(status == 0);
+	status = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	assert(status == 0);
+	status = pthread_cond_init(&cond->m_cond, &attr);
+	assert(status == 0);
+	pthread_condattr_destroy(&attr);
+#else
 	int status = pthread_cond_init(&cond->m_cond, NULL);
-	(void)status;
 	assert(status == 0);
+#endif
+	(void)status;
 	return cond;
 }
 
@@ -237,11 +293,8 @@ ArchMultithreadPosix::waitCondVar(ArchCond cond,
 	testCancelThread();
 
 	// get final time
-	struct timeval now;
-	gettimeofday(&now, NULL);
 	struct timespec finalTime;
-	finalTime.tv_sec   = now.tv_sec;
-	finalTime.tv_nsec  = now.tv_usec * 1000;
+	getCondVarTime(&finalTime);
 	long timeout_sec   = (long)timeout;
 	long timeout_nsec  = (long)(1.0e+9 * (timeout - timeout_sec));
 	finalTime.tv_sec  += timeout_sec;
@@ -440,25 +493,118 @@ ArchMultithreadPosix::cancelThread(ArchThread thread)
 
 	// set cancel and wakeup flags if thread can be cancelled
 	bool wakeup = false;
+	ArchWakeupUnix* pollWakeup = NULL;
 	lockMutex(m_threadMutex);
 	if (!thread->m_exited && !thread->m_cancelling) {
 		thread->m_cancel = true;
-		wakeup = true;
+		wakeup     = true;
+		pollWakeup = thread->m_wakeup;
 	}
 	unlockMutex(m_threadMutex);
 
-	// force thread to exit system calls if wakeup is true
+	// force thread to exit system calls if wakeup is true.  the signal
+	// is lost if it arrives just before the thread enters poll() so
+	// also make its wakeup readable, which stays readable until the
+	// thread gets around to polling.
 	if (wakeup) {
 		pthread_kill(thread->m_thread, SIGWAKEUP);
+		if (pollWakeup != NULL) {
+			pollWakeup->signal();
+		}
 	}
 }
 
 void
-ArchMultithreadPosix::setPriorityOfThread(ArchThread thread, int /*n*/)
+ArchMultithreadPosix::setPriorityOfThread(ArchThread thread, int n)
+{
+	// nice values are levels from normal
+	setNiceOfThread(thread, n);
+}
+
+void
+ArchMultithreadPosix::setNiceOfThread(ArchThread thread, int n)
+{
+	assert(thread != NULL);
+
+	// pthreads has no portable per-thread priority for the normal
+	// scheduling class but on linux each thread has its own nice value.
+#if defined(__linux__)
+	lockMutex(m_threadMutex);
+	int tid = thread->m_tid;
+	unlockMutex(m_threadMutex);
+	if (tid == 0) {
+		return;
+	}
+
+	if (n < -20) {
+		n = -20;
+	}
+	else if (n > 19) {
+		n = 19;
+	}
+	if (setpriority(PRIO_PROCESS, tid, n) == 0 || n >= 0) {
+		return;
+	}
+
+	// raising the priority wasn't permitted.  use the best nice value
+	// RLIMIT_NICE allows, if that's any better than normal.
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NICE, &limit) == 0 && limit.rlim_cur > 20) {
+		int best = -20;
+		if (limit.rlim_cur < 40) {
+			best = 20 - static_cast<int>(limit.rlim_cur);
+		}
+		if (best < n) {
+			best = n;
+		}
+		setpriority(PRIO_PROCESS, tid, best);
+	}
+#else
+	(void)n;
+#endif
+}
+
+bool
+ArchMultithreadPosix::setRealtimePriorityOfThread(ArchThread thread,
+				int priority)
 {
 	assert(thread != NULL);
 
-	// FIXME
+	int minPriority = sched_get_priority_min(SCHED_FIFO);
+	int maxPriority = sched_get_priority_max(SCHED_FIFO);
+	if (minPriority == -1 || maxPriority == -1) {
+		return false;
+	}
+	if (priority < minPriority) {
+		priority = minPriority;
+	}
+	else if (priority > maxPriority) {
+		priority = maxPriority;
+	}
+
+	struct sched_param param;
+	param.sched_priority = priority;
+	return (pthread_setschedparam(thread->m_thread, SCHED_FIFO, &param) == 0);
+}
+
+bool
+ArchMultithreadPosix::setAffinityOfThread(ArchThread thread, int cpu)
+{
+	assert(thread != NULL);
+
+#if defined(__linux__)
+	if (cpu < 0 || cpu >= CPU_SETSIZE) {
+		return false;
+	}
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(cpu, &cpus);
+	return (pthread_setaffinity_np(thread->m_thread,
+							sizeof(cpus), &cpus) == 0);
+#else
+	(void)cpu;
+	return false;
+#endif
 }
 
 void
@@ -713,11 +859,13 @@ ArchMultithreadPosix::threadFunc(void* vrep)
 void
 ArchMultithreadPosix::doThreadFunc(ArchThread thread)
 {
-	// default priority is slightly below normal
-	setPriorityOfThread(thread, 1);
+	// new threads keep the default priority.  the input path runs on
+	// other threads (e.g. the socket multiplexer) so lowering them all
+	// would only add latency;  see App::initInputThreads().
 
 	// wait for parent to initialize this object
 	lockMutex(m_threadMutex);
+	thread->m_tid = getCurrentTID();
 	unlockMutex(m_threadMutex);
 
 	void* result = NULL;
@@ -25,6 +25,8 @@
 
 #define ARCH_MULTITHREAD ArchMultithreadPosix
 
+class ArchWakeupUnix;
+
 class ArchCondImpl {
 public:
 	pthread_cond_t		m_cond;
@@ -44,14 +46,18 @@ public:
 	//! @name manipulators
 	//@{
 
-	void				setNetworkDataForCurrentThread(void*);
+	//! Get the wakeup for a thread
+	/*!
+	Returns the descriptor \c thread polls alongside its sockets so
+	other threads can break it out of the poll, creating it on first
+	use.  The wakeup is destroyed with the thread.
+	*/
+	ArchWakeupUnix*		getWakeupForThread(ArchThread thread);
 
 	//@}
 	//! @name accessors
 	//@{
 
-	void*				getNetworkDataForThread(ArchThread);
-
 	static ArchMultithreadPosix*	getInstance();
 
 	//@}
@@ -72,6 +78,9 @@ public:
 	virtual void		closeThread(ArchThread);
 	virtual void		cancelThread(ArchThread);
 	virtual void		setPriorityOfThread(ArchThread, int n);
+	virtual void		setNiceOfThread(ArchThread, int nice);
+	virtual bool		setRealtimePriorityOfThread(ArchThread, int priority);
+	virtual bool		setAffinityOfThread(ArchThread, int cpu);
 	virtual void		testCancelThread();
 	virtual bool		wait(ArchThread, double timeout);
 	virtual bool		isSameThread(ArchThread, ArchThread);
@@ -19,6 +19,7 @@
 #include "arch/unix/ArchNetworkBSD.h"
 
 #include "arch/unix/ArchMultithreadPosix.h"
+#include "arch/unix/ArchWakeupUnix.h"
 #include "arch/unix/XArchUnix.h"
 #include "arch/Arch.h"
 
@@ -34,6 +35,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <string.h>
+#include <stddef.h>
 
 #if HAVE_POLL
 #	include <poll.h>
@@ -52,7 +54,8 @@
 
 static const int s_family[] = {
 	PF_UNSPEC,
-	PF_INET
+	PF_INET,
+	PF_UNIX
 };
 static const int s_type[] = {
 	SOCK_DGRAM,
@@ -122,6 +125,7 @@ ArchNetworkBSD::newSocket(EAddressFamily family, ESocketType type)
 	ArchSocketImpl* newSocket = new ArchSocketImpl;
 	newSocket->m_fd            = fd;
 	newSocket->m_refCount      = 1;
+	newSocket->m_family        = family;
 	return newSocket;
 }
 
@@ -201,8 +205,10 @@ ArchNetworkBSD::listenOnSocket(ArchSocket s)
 {
 	assert(s != NULL);
 
-	// hardcoding backlog
-	if (listen(s->m_fd, 3) == -1) {
+	// let the system queue as many connections as it allows so that a
+	// storm of reconnecting clients waits to be accepted rather than
+	// having its connection attempts dropped and retransmitted
+	if (listen(s->m_fd, SOMAXCONN) == -1) {
 		throwError(errno);
 	}
 }
@@ -251,6 +257,7 @@ ArchNetworkBSD::acceptSocket(ArchSocket s, ArchNetAddress* addr)
 	// initialize socket
 	newSocket->m_fd       = fd;
 	newSocket->m_refCount = 1;
+	newSocket->m_family   = s->m_family;
 
 	// discard address if not requested
 	if (addr == &dummy) {
@@ -309,10 +316,11 @@ ArchNetworkBSD::pollSocket(PollEntry pe[], int num, double timeout)
 	}
 	int n = num;
 
-	// add the unblock pipe
-	const int* unblockPipe = getUnblockPipe();
-	if (unblockPipe != NULL) {
-		pfd[n].fd     = unblockPipe[0];
+	// add the unblock wakeup
+	ArchWakeupUnix* unblock = getUnblockWakeup();
+	const int unblockFd     = unblock->getFd();
+	if (unblockFd != -1) {
+		pfd[n].fd     = unblockFd;
 		pfd[n].events = POLLIN;
 		++n;
 	}
@@ -323,17 +331,12 @@ ArchNetworkBSD::pollSocket(PollEntry pe[], int num, double timeout)
 	// do the poll
 	n = poll(pfd, n, t);
 
-	// reset the unblock pipe
-	if (n > 0 && unblockPipe != NULL && (pfd[num].revents & POLLIN) != 0) {
-		// the unblock event was signalled.  flush the pipe.
-		char dummy[100];
-		int ignore;
+	// reset the unblock wakeup
+	if (n > 0 && unblockFd != -1 && (pfd[num].revents & POLLIN) != 0) {
+		// the unblock event was signalled
+		unblock->reset();
 
-		do {
-			ignore = read(unblockPipe[0], dummy, sizeof(dummy));
-		} while (errno != EAGAIN);
-
-		// don't count this unblock pipe in return value
+		// don't count the unblock wakeup in return value
 		--n;
 	}
 
@@ -420,13 +423,14 @@ ArchNetworkBSD::pollSocket(PollEntry pe[], int num, double timeout)
 		}
 	}
 
-	// add the unblock pipe
-	const int* unblockPipe = getUnblockPipe();
-	if (unblockPipe != NULL) {
-		FD_SET(unblockPipe[0], &readSet);
+	// add the unblock wakeup
+	ArchWakeupUnix* unblock = getUnblockWakeup();
+	const int unblockFd     = unblock->getFd();
+	if (unblockFd != -1) {
+		FD_SET(unblockFd, &readSet);
 		readSetP = &readSet;
-		if (unblockPipe[0] > n) {
-			n = unblockPipe[0];
+		if (unblockFd > n) {
+			n = unblockFd;
 		}
 	}
 
@@ -455,13 +459,10 @@ ArchNetworkBSD::pollSocket(PollEntry pe[], int num, double timeout)
 				SELECT_TYPE_ARG234 errSetP,
 				SELECT_TYPE_ARG5   timeout2P);
 
-	// reset the unblock pipe
-	if (n > 0 && unblockPipe != NULL && FD_ISSET(unblockPipe[0], &readSet)) {
-		// the unblock event was signalled.  flush the pipe.
-		char dummy[100];
-		do {
-			read(unblockPipe[0], dummy, sizeof(dummy));
-		} while (errno != EAGAIN);
+	// reset the unblock wakeup
+	if (n > 0 && unblockFd != -1 && FD_ISSET(unblockFd, &readSet)) {
+		// the unblock event was signalled
+		unblock->reset();
 	}
 
 	// handle results
@@ -499,13 +500,7 @@ ArchNetworkBSD::pollSocket(PollEntry pe[], int num, double timeout)
 void
 ArchNetworkBSD::unblockPollSocket(ArchThread thread)
 {
-	const int* unblockPipe = getUnblockPipeForThread(thread);
-	if (unblockPipe != NULL) {
-		char dummy = 0;
-		int ignore;
-
-		ignore = write(unblockPipe[1], &dummy, 1);
-	}
+	ArchMultithreadPosix::getInstance()->getWakeupForThread(thread)->signal();
 }
 
 size_t
@@ -582,6 +577,11 @@ ArchNetworkBSD::setNoDelayOnSocket(ArchSocket s, bool noDelay)
 {
 	assert(s != NULL);
 
+	// only tcp has a nagle algorithm
+	if (s->m_family != kINET) {
+		return false;
+	}
+
 	// get old state
 	int oflag;
 	socklen_t size = (socklen_t)sizeof(oflag);
@@ -623,6 +623,37 @@ ArchNetworkBSD::setReuseAddrOnSocket(ArchSocket s, bool reuse)
 	return (oflag != 0);
 }
 
+bool
+ArchNetworkBSD::isPeerTrustedOnSocket(ArchSocket s)
+{
+	assert(s != NULL);
+
+	if (s->m_family != kUNIX) {
+		return false;
+	}
+
+	uid_t uid;
+#if defined(SO_PEERCRED)
+	struct ucred cred;
+	socklen_t size = (socklen_t)sizeof(cred);
+	if (getsockopt(s->m_fd, SOL_SOCKET, SO_PEERCRED,
+							(optval_t*)&cred, &size) == -1) {
+		return false;
+	}
+	uid = cred.uid;
+#elif defined(__APPLE__) || defined(__FreeBSD__) || \
+		defined(__OpenBSD__) || defined(__NetBSD__)
+	gid_t gid;
+	if (getpeereid(s->m_fd, &uid, &gid) == -1) {
+		return false;
+	}
+#else
+	return false;
+#endif
+
+	return (uid == geteuid() || uid == 0);
+}
+
 std::string
 ArchNetworkBSD::getHostName()
 {
@@ -662,6 +693,23 @@ ArchNetworkBSD::newAnyAddr(EAddressFamily family)
 	return addr;
 }
 
+ArchNetAddress
+ArchNetworkBSD::newUnixAddr(const std::string& path)
+{
+	ArchNetAddressImpl* addr = new ArchNetAddressImpl;
+	if (path.empty() || path.size() >= sizeof(addr->m_unixAddr.sun_path)) {
+		delete addr;
+		throw XArchNetworkName("unix socket path is too long");
+	}
+
+	memset(&addr->m_unixAddr, 0, sizeof(addr->m_unixAddr));
+	addr->m_unixAddr.sun_family = AF_UNIX;
+	memcpy(addr->m_unixAddr.sun_path, path.c_str(), path.size());
+	addr->m_len = (socklen_t)(offsetof(struct sockaddr_un, sun_path) +
+							path.size() + 1);
+	return addr;
+}
+
 ArchNetAddress
 ArchNetworkBSD::copyAddr(ArchNetAddress addr)
 {
@@ -769,6 +817,9 @@ ArchNetworkBSD::addrToString(ArchNetAddress addr)
 		return s;
 	}
 
+	case kUNIX:
+		return addr->m_unixAddr.sun_path;
+
 	default:
 		assert(0 && "unknown address family");
 		return "";
@@ -784,6 +835,9 @@ ArchNetworkBSD::getAddrFamily(ArchNetAddress addr)
 	case AF_INET:
 		return kINET;
 
+	case AF_UNIX:
+		return kUNIX;
+
 	default:
 		return kUNKNOWN;
 	}
@@ -802,6 +856,10 @@ ArchNetworkBSD::setAddrPort(ArchNetAddress addr, int port)
 		break;
 	}
 
+	case kUNIX:
+		// unix domain addresses have no port
+		break;
+
 	default:
 		assert(0 && "unknown address family");
 		break;
@@ -820,6 +878,9 @@ ArchNetworkBSD::getAddrPort(ArchNetAddress addr)
 		return ntohs(ipAddr->sin_port);
 	}
 
+	case kUNIX:
+		return 0;
+
 	default:
 		assert(0 && "unknown address family");
 		return 0;
@@ -839,6 +900,9 @@ ArchNetworkBSD::isAnyAddr(ArchNetAddress addr)
 				addr->m_len == (socklen_t)sizeof(struct sockaddr_in));
 	}
 
+	case kUNIX:
+		return false;
+
 	default:
 		assert(0 && "unknown address family");
 		return true;
@@ -852,39 +916,14 @@ ArchNetworkBSD::isEqualAddr(ArchNetAddress a, ArchNetAddress b)
 			memcmp(&a->m_addr, &b->m_addr, a->m_len) == 0);
 }
 
-const int*
-ArchNetworkBSD::getUnblockPipe()
+ArchWakeupUnix*
+ArchNetworkBSD::getUnblockWakeup()
 {
 	ArchMultithreadPosix* mt = ArchMultithreadPosix::getInstance();
 	ArchThread thread        = mt->newCurrentThread();
-	const int* p              = getUnblockPipeForThread(thread);
+	ArchWakeupUnix* wakeup   = mt->getWakeupForThread(thread);
 	ARCH->closeThread(thread);
-	return p;
-}
-
-const int*
-ArchNetworkBSD::getUnblockPipeForThread(ArchThread thread)
-{
-	ArchMultithreadPosix* mt = ArchMultithreadPosix::getInstance();
-	int* unblockPipe          = (int*)mt->getNetworkDataForThread(thread);
-	if (unblockPipe == NULL) {
-		unblockPipe = new int[2];
-		if (pipe(unblockPipe) != -1) {
-			try {
-				setBlockingOnSocket(unblockPipe[0], false);
-				mt->setNetworkDataForCurrentThread(unblockPipe);
-			}
-			catch (...) {
-				delete[] unblockPipe;
-				unblockPipe = NULL;
-			}
-		}
-		else {
-			delete[] unblockPipe;
-			unblockPipe = NULL;
-		}
-	}
-	return unblockPipe;
+	return wakeup;
 }
 
 void
@@ -27,6 +27,7 @@
 #if HAVE_SYS_SOCKET_H
 #	include <sys/socket.h>
 #endif
+#include <sys/un.h>
 
 #if !HAVE_SOCKLEN_T
 typedef int socklen_t;
@@ -39,18 +40,26 @@ typedef char optval_t;
 
 #define ARCH_NETWORK ArchNetworkBSD
 
+class ArchWakeupUnix;
+
 class ArchSocketImpl {
 public:
 	int					m_fd;
 	int					m_refCount;
+	IArchNetwork::EAddressFamily
+						m_family;
 };
 
 class ArchNetAddressImpl {
 public:
-	ArchNetAddressImpl() : m_len(sizeof(m_addr)) { }
+	ArchNetAddressImpl() : m_len(sizeof(m_unixAddr)) { }
 
 public:
-	struct sockaddr		m_addr;
+	// sockaddr is too small to hold a unix domain address
+	union {
+		struct sockaddr		m_addr;
+		struct sockaddr_un	m_unixAddr;
+	};
 	socklen_t			m_len;
 };
 
@@ -79,8 +88,10 @@ public:
 	virtual void		throwErrorOnSocket(ArchSocket);
 	virtual bool		setNoDelayOnSocket(ArchSocket, bool noDelay);
 	virtual bool		setReuseAddrOnSocket(ArchSocket, bool reuse);
+	virtual bool		isPeerTrustedOnSocket(ArchSocket);
 	virtual std::string		getHostName();
 	virtual ArchNetAddress	newAnyAddr(EAddressFamily);
+	virtual ArchNetAddress	newUnixAddr(const std::string& path);
 	virtual ArchNetAddress	copyAddr(ArchNetAddress);
 	virtual ArchNetAddress	nameToAddr(const std::string&);
 	virtual void			closeAddr(ArchNetAddress);
@@ -93,8 +104,7 @@ public:
 	virtual bool			isEqualAddr(ArchNetAddress, ArchNetAddress);
 
 private:
-	const int*			getUnblockPipe();
-	const int*			getUnblockPipeForThread(ArchThread);
+	ArchWakeupUnix*		getUnblockWakeup();
 	void				setBlockingOnSocket(int fd, bool blocking);
 	void				throwError(int);
 	void				throwNameError(int);
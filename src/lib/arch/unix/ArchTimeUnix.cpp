@@ -24,6 +24,7 @@
 #else
 #	if HAVE_SYS_TIME_H
 #		include <sys/time.h>
+#		include <time.h>
 #	else
 #		include <time.h>
 #	endif
@@ -46,6 +47,15 @@ ArchTimeUnix::~ArchTimeUnix()
 double
 ArchTimeUnix::time()
 {
+#if HAVE_CLOCK_GETTIME && defined(CLOCK_MONOTONIC)
+	// use the monotonic clock so that timers, timeouts and stopwatches
+	// aren't disturbed when the wall clock is stepped (NTP, user, etc).
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+		return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+	}
+#endif
+
 	struct timeval t;
 	gettimeofday(&t, NULL);
 	return (double)t.tv_sec + 1.0e-6 * (double)t.tv_usec;
@@ -0,0 +1,127 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "arch/unix/ArchWakeupUnix.h"
+
+#if HAVE_UNISTD_H
+#	include <unistd.h>
+#endif
+#if HAVE_SYS_EVENTFD_H
+#	include <sys/eventfd.h>
+#endif
+#include <fcntl.h>
+#include <errno.h>
+
+static
+void
+setNonBlocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL);
+	fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+	flags = fcntl(fd, F_GETFD);
+	fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+}
+
+//
+// ArchWakeupUnix
+//
+
+ArchWakeupUnix::ArchWakeupUnix() :
+	m_readFd(-1),
+	m_writeFd(-1),
+	m_pending(0)
+{
+#if HAVE_SYS_EVENTFD_H
+	// an eventfd is a single descriptor holding a counter so any
+	// number of writes collapse into one readable state
+	m_readFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_readFd != -1) {
+		m_writeFd = m_readFd;
+		return;
+	}
+#endif
+
+	int fds[2];
+	if (pipe(fds) != -1) {
+		setNonBlocking(fds[0]);
+		setNonBlocking(fds[1]);
+		m_readFd  = fds[0];
+		m_writeFd = fds[1];
+	}
+}
+
+ArchWakeupUnix::~ArchWakeupUnix()
+{
+	if (m_writeFd != m_readFd) {
+		close(m_writeFd);
+	}
+	if (m_readFd != -1) {
+		close(m_readFd);
+	}
+}
+
+void
+ArchWakeupUnix::signal()
+{
+	// only the thread that sets the pending flag writes
+	if (m_writeFd == -1 ||
+		!__sync_bool_compare_and_swap(&m_pending, 0, 1)) {
+		return;
+	}
+
+	ssize_t result;
+	do {
+#if HAVE_SYS_EVENTFD_H
+		if (m_writeFd == m_readFd) {
+			eventfd_t one = 1;
+			result = write(m_writeFd, &one, sizeof(one));
+			continue;
+		}
+#endif
+		char dummy = 0;
+		result = write(m_writeFd, &dummy, 1);
+	} while (result == -1 && errno == EINTR);
+}
+
+void
+ArchWakeupUnix::reset()
+{
+	if (m_readFd == -1) {
+		return;
+	}
+
+	// one read empties an eventfd.  a pipe holds at most a byte or two
+	// since only the signal() that sets the pending flag writes.
+	char buffer[16];
+	ssize_t result;
+	do {
+		result = read(m_readFd, buffer, sizeof(buffer));
+	} while (result == -1 && errno == EINTR);
+
+	// clear the flag after draining so a signal() that raced with us
+	// either wrote after the read, leaving the descriptor readable, or
+	// saw the flag still set and relies on our caller examining its
+	// state after this returns.  this is a full barrier.
+	__sync_fetch_and_and(&m_pending, 0);
+}
+
+int
+ArchWakeupUnix::getFd() const
+{
+	return m_readFd;
+}
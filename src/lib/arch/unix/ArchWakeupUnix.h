@@ -0,0 +1,72 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common/common.h"
+
+//! Unix wakeup descriptor
+/*!
+A file descriptor that one thread can include in a poll() or select()
+set and other threads can make readable to break it out of the wait.
+On Linux this is an eventfd, otherwise it's a non-blocking pipe.
+
+Wakeups are coalesced:  while a wakeup is pending, further calls to
+\c signal() return without making a system call, and \c reset() clears
+the pending state with a single read no matter how many times the
+wakeup was signalled.
+*/
+class ArchWakeupUnix {
+public:
+	ArchWakeupUnix();
+	~ArchWakeupUnix();
+
+	//! @name manipulators
+	//@{
+
+	//! Wake up the waiting thread
+	/*!
+	Makes the descriptor readable unless a wakeup is already pending.
+	This may be called from any thread.
+	*/
+	void				signal();
+
+	//! Consume a pending wakeup
+	/*!
+	Called by the waiting thread after the descriptor polled readable,
+	before it examines whatever state the wakeup was signalling.
+	*/
+	void				reset();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the descriptor to poll for reading
+	/*!
+	Returns -1 if the descriptor could not be created.
+	*/
+	int					getFd() const;
+
+	//@}
+
+private:
+	int					m_readFd;
+	int					m_writeFd;
+	volatile int		m_pending;
+};
@@ -435,6 +435,56 @@ ArchMultithreadWindows::setPriorityOfThread(ArchThread thread, int n)
 	SetThreadPriority(thread->m_thread, s_pClass[index].m_level);
 }
 
+void
+ArchMultithreadWindows::setNiceOfThread(ArchThread thread, int nice)
+{
+	assert(thread != NULL);
+
+	// there are no nice values so use the nearest thread priority.
+	// unlike setPriorityOfThread() this never changes the process's
+	// priority class.
+	int level;
+	if (nice <= -15) {
+		level = THREAD_PRIORITY_HIGHEST;
+	}
+	else if (nice <= -5) {
+		level = THREAD_PRIORITY_ABOVE_NORMAL;
+	}
+	else if (nice < 5) {
+		level = THREAD_PRIORITY_NORMAL;
+	}
+	else if (nice < 15) {
+		level = THREAD_PRIORITY_BELOW_NORMAL;
+	}
+	else {
+		level = THREAD_PRIORITY_LOWEST;
+	}
+	SetThreadPriority(thread->m_thread, level);
+}
+
+bool
+ArchMultithreadWindows::setRealtimePriorityOfThread(ArchThread thread, int)
+{
+	assert(thread != NULL);
+
+	// the real-time priority class applies to the whole process so
+	// just make this thread as urgent as its class allows.
+	return (SetThreadPriority(thread->m_thread,
+							THREAD_PRIORITY_TIME_CRITICAL) != 0);
+}
+
+bool
+ArchMultithreadWindows::setAffinityOfThread(ArchThread thread, int cpu)
+{
+	assert(thread != NULL);
+
+	if (cpu < 0 || cpu >= static_cast<int>(8 * sizeof(DWORD_PTR))) {
+		return false;
+	}
+	DWORD_PTR mask = static_cast<DWORD_PTR>(1) << cpu;
+	return (SetThreadAffinityMask(thread->m_thread, mask) != 0);
+}
+
 void
 ArchMultithreadWindows::testCancelThread()
 {
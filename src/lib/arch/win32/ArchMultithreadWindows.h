@@ -79,6 +79,9 @@ public:
 	virtual void		closeThread(ArchThread);
 	virtual void		cancelThread(ArchThread);
 	virtual void		setPriorityOfThread(ArchThread, int n);
+	virtual void		setNiceOfThread(ArchThread, int nice);
+	virtual bool		setRealtimePriorityOfThread(ArchThread, int priority);
+	virtual bool		setAffinityOfThread(ArchThread, int cpu);
 	virtual void		testCancelThread();
 	virtual bool		wait(ArchThread, double timeout);
 	virtual bool		isSameThread(ArchThread, ArchThread);
@@ -26,7 +26,8 @@
 
 static const int s_family[] = {
 	PF_UNSPEC,
-	PF_INET
+	PF_INET,
+	PF_UNSPEC	// unix domain sockets aren't supported
 };
 static const int s_type[] = {
 	SOCK_DGRAM,
@@ -304,8 +305,10 @@ ArchNetworkWinsock::listenOnSocket(ArchSocket s)
 {
 	assert(s != NULL);
 
-	// hardcoding backlog
-	if (listen_winsock(s->m_socket, 3) == SOCKET_ERROR) {
+	// let the system queue as many connections as it allows so that a
+	// storm of reconnecting clients waits to be accepted rather than
+	// having its connection attempts dropped and retransmitted
+	if (listen_winsock(s->m_socket, SOMAXCONN) == SOCKET_ERROR) {
 		throwError(getsockerror_winsock());
 	}
 }
@@ -654,6 +657,12 @@ ArchNetworkWinsock::setReuseAddrOnSocket(ArchSocket s, bool reuse)
 	return (oflag != 0);
 }
 
+bool
+ArchNetworkWinsock::isPeerTrustedOnSocket(ArchSocket)
+{
+	return false;
+}
+
 std::string
 ArchNetworkWinsock::getHostName()
 {
@@ -687,6 +696,12 @@ ArchNetworkWinsock::newAnyAddr(EAddressFamily family)
 	return addr;
 }
 
+ArchNetAddress
+ArchNetworkWinsock::newUnixAddr(const std::string&)
+{
+	throw XArchNetworkSupport("unix domain sockets are not supported");
+}
+
 ArchNetAddress
 ArchNetworkWinsock::copyAddr(ArchNetAddress addr)
 {
@@ -77,8 +77,10 @@ public:
 	virtual void		throwErrorOnSocket(ArchSocket);
 	virtual bool		setNoDelayOnSocket(ArchSocket, bool noDelay);
 	virtual bool		setReuseAddrOnSocket(ArchSocket, bool reuse);
+	virtual bool		isPeerTrustedOnSocket(ArchSocket);
 	virtual std::string		getHostName();
 	virtual ArchNetAddress	newAnyAddr(EAddressFamily);
+	virtual ArchNetAddress	newUnixAddr(const std::string& path);
 	virtual ArchNetAddress	copyAddr(ArchNetAddress);
 	virtual ArchNetAddress	nameToAddr(const std::string&);
 	virtual void			closeAddr(ArchNetAddress);
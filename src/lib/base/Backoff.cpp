@@ -0,0 +1,84 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/Backoff.h"
+
+#include "arch/Arch.h"
+
+#include <ctime>
+
+//
+// Backoff
+//
+
+Backoff::Backoff(double minDelay, double maxDelay) :
+	m_minDelay(minDelay),
+	m_maxDelay(maxDelay),
+	m_delay(0.0)
+{
+	assert(minDelay > 0.0 && minDelay <= maxDelay);
+
+	// mix in our address so backoffs created together still differ
+	setSeed(static_cast<UInt32>(time(NULL)) ^
+			static_cast<UInt32>(ARCH->time() * 1.0e6) ^
+			static_cast<UInt32>(reinterpret_cast<size_t>(this)));
+}
+
+void
+Backoff::reset()
+{
+	m_delay = 0.0;
+}
+
+double
+Backoff::next(double hint)
+{
+	if (m_delay < m_minDelay) {
+		m_delay = m_minDelay;
+	}
+	else if (m_delay < m_maxDelay) {
+		m_delay *= 2.0;
+		if (m_delay > m_maxDelay) {
+			m_delay = m_maxDelay;
+		}
+	}
+
+	double delay = m_delay;
+	if (hint > delay) {
+		delay = hint;
+	}
+	return delay * (1.0 + 0.5 * random());
+}
+
+void
+Backoff::setSeed(UInt32 seed)
+{
+	// xorshift gets stuck at zero
+	m_seed = (seed != 0) ? seed : 1;
+}
+
+double
+Backoff::random()
+{
+	// xorshift32 is plenty for spreading out retries and, unlike rand(),
+	// doesn't depend on (or disturb) anybody else's seed
+	m_seed ^= m_seed << 13;
+	m_seed ^= m_seed >> 17;
+	m_seed ^= m_seed << 5;
+	return static_cast<double>(m_seed) / 4294967296.0;
+}
@@ -0,0 +1,71 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common/basic_types.h"
+
+//! Jittered exponential backoff
+/*!
+Chooses how long to wait before retrying something that failed, such
+as connecting to a server.  The delay starts at a minimum and doubles
+with each failure up to a maximum, and each delay is stretched by a
+random amount of up to half again.  The jitter matters when many peers
+lose the same server at the same moment: without it they would all
+retry at the same moment too, every time.
+*/
+class Backoff {
+public:
+	Backoff(double minDelay, double maxDelay);
+
+	//! @name manipulators
+	//@{
+
+	//! Start over from the minimum delay
+	/*!
+	Call this once the operation has succeeded.
+	*/
+	void				reset();
+
+	//! Get the delay before the next retry
+	/*!
+	Returns the delay in seconds and doubles the delay for next time.
+	\p hint, if positive, is a delay requested by the other end (for
+	example, a server that is too busy) and the returned delay is at
+	least that long.
+	*/
+	double				next(double hint = 0.0);
+
+	//! Seed the jitter
+	/*!
+	The jitter is seeded from the clock by default.  Tests use this to
+	get repeatable delays.
+	*/
+	void				setSeed(UInt32 seed);
+
+	//@}
+
+private:
+	double				random();
+
+private:
+	double				m_minDelay;
+	double				m_maxDelay;
+	double				m_delay;
+	UInt32				m_seed;
+};
@@ -28,7 +28,8 @@ Event::Event() :
 	m_target(NULL),
 	m_data(NULL),
 	m_flags(0),
-	m_dataObject(nullptr)
+	m_dataObject(nullptr),
+	m_time(0.0)
 {
 	// do nothing
 }
@@ -38,7 +39,8 @@ Event::Event(Type type, void* target, void* data, Flags flags) :
 	m_target(target),
 	m_data(data),
 	m_flags(flags),
-	m_dataObject(nullptr)
+	m_dataObject(nullptr),
+	m_time(0.0)
 {
 	// do nothing
 }
@@ -73,6 +75,12 @@ Event::getFlags() const
 	return m_flags;
 }
 
+double
+Event::getTime() const
+{
+	return m_time;
+}
+
 void
 Event::deleteData(const Event& event)
 {
@@ -98,3 +106,9 @@ Event::setDataObject(EventData* dataObject)
 	assert(m_dataObject == nullptr);
 	m_dataObject = dataObject;
 }
+
+void
+Event::setTime(double time)
+{
+	m_time = time;
+}
@@ -79,6 +79,15 @@ public:
 	*/
 	void				setDataObject(EventData* dataObject);
 
+	//! Set input capture time
+	/*!
+	Sets the time, as reported by \c ARCH->time(), at which the input
+	the event reports was captured.  Screens stamp the input events
+	they send;  an event posted on behalf of another should copy its
+	time.
+	*/
+	void				setTime(double time);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -114,6 +123,12 @@ public:
 	Returns the event flags.
 	*/
 	Flags				getFlags() const;
+
+	//! Get input capture time
+	/*!
+	Returns the time set by \c setTime(), or 0 if it wasn't set.
+	*/
+	double				getTime() const;
 	
 	//@}
 
@@ -123,4 +138,5 @@ private:
 	void*				m_data;
 	Flags				m_flags;
 	EventData*			m_dataObject;
+	double				m_time;
 };
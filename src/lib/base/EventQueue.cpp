@@ -23,6 +23,8 @@
 #include "arch/Arch.h"
 #include "base/SimpleEventQueueBuffer.h"
 #include "base/Stopwatch.h"
+#include "base/Metrics.h"
+#include "base/Trace.h"
 #include "base/IEventJob.h"
 #include "base/EventTypes.h"
 #include "base/Log.h"
@@ -46,6 +48,7 @@ EVENT_TYPE_ACCESSOR(ServerApp)
 EVENT_TYPE_ACCESSOR(IKeyState)
 EVENT_TYPE_ACCESSOR(IPrimaryScreen)
 EVENT_TYPE_ACCESSOR(IScreen)
+EVENT_TYPE_ACCESSOR(ThreadPool)
 
 // interrupt handler.  this just adds a quit event to the queue.
 static
@@ -82,6 +85,7 @@ EventQueue::EventQueue() :
 	m_typesForIKeyState(NULL),
 	m_typesForIPrimaryScreen(NULL),
 	m_typesForIScreen(NULL),
+	m_typesForThreadPool(NULL),
 	m_readyMutex(new Mutex),
 	m_readyCondVar(new CondVar<bool>(m_readyMutex, false))
 {
@@ -89,6 +93,13 @@ EventQueue::EventQueue() :
 	ARCH->setSignalHandler(Arch::kINTERRUPT, &interrupt, this);
 	ARCH->setSignalHandler(Arch::kTERMINATE, &interrupt, this);
 	m_buffer = new SimpleEventQueueBuffer;
+
+	m_metricDispatched   = METRICS->counter("synergy_events_dispatched_total",
+							"Events dispatched by the event queue");
+	m_metricDispatchTime = METRICS->histogram("synergy_event_dispatch_microseconds",
+							"Time taken to dispatch an event");
+	m_metricQueueDepth   = METRICS->gauge("synergy_event_queue_depth",
+							"Events waiting to be dispatched");
 }
 
 EventQueue::~EventQueue()
@@ -106,6 +117,7 @@ void
 EventQueue::loop()
 {
 	m_buffer->init();
+	TRACE->setThreadName("event queue");
 	{
 		Lock lock(m_readyMutex);
 		*m_readyCondVar = true;
@@ -122,8 +134,16 @@ EventQueue::loop()
 	Event event;
 	getEvent(event);
 	while (event.getType() != Event::kQuit) {
+		double start = ARCH->time();
 		dispatchEvent(event);
 		Event::deleteData(event);
+		double end = ARCH->time();
+		m_metricDispatched->increment();
+		m_metricDispatchTime->observe(
+			static_cast<UInt32>(1.0e+6 * (end - start)));
+		if (Trace::isEnabled()) {
+			TRACE->record("event", getTypeName(event.getType()), start, end);
+		}
 		getEvent(event);
 	}
 }
@@ -157,7 +177,9 @@ EventQueue::getTypeName(Event::Type type)
 	case Event::kTimer:
 		return "timer";
 
-	default:
+	default: {
+		// types may be registered on other threads
+		ArchMutexLock lock(m_mutex);
 		TypeMap::const_iterator i = m_typeMap.find(type);
 		if (i == m_typeMap.end()) {
 			return "<unknown>";
@@ -166,6 +188,7 @@ EventQueue::getTypeName(Event::Type type)
 			return i->second;
 		}
 	}
+	}
 }
 
 void
@@ -179,6 +202,7 @@ EventQueue::adoptBuffer(IEventQueueBuffer* buffer)
 		// this can come as a nasty surprise to programmers expecting
 		// their events to be raised, only to have them deleted.
 		LOG((CLOG_DEBUG "discarding %d event(s)", m_events.size()));
+		m_metricQueueDepth->add(-static_cast<SInt64>(m_events.size()));
 	}
 
 	// discard old buffer and old events
@@ -459,6 +483,7 @@ EventQueue::saveEvent(const Event& event)
 
 	// save data
 	m_events[id] = event;
+	m_metricQueueDepth->add(1);
 	return id;
 }
 
@@ -474,6 +499,7 @@ EventQueue::removeEvent(UInt32 eventID)
 	// get data
 	Event event = index->second;
 	m_events.erase(index);
+	m_metricQueueDepth->add(-1);
 
 	// save old id for reuse
 	m_oldEventIDs.push_back(eventID);
@@ -541,6 +567,7 @@ EventQueue::getNextTimerTimeout() const
 Event::Type
 EventQueue::getRegisteredType(const String& name) const
 {
+	ArchMutexLock lock(m_mutex);
 	NameMap::const_iterator found = m_nameMap.find(name);
 	if (found != m_nameMap.end())
 		return found->second;
@@ -30,6 +30,9 @@
 #include <queue>
 
 class Mutex;
+class MetricCounter;
+class MetricGauge;
+class MetricHistogram;
 
 //! Event queue
 /*!
@@ -135,6 +138,11 @@ private:
 	// event handlers
 	HandlerTable		m_handlers;
 
+	// metrics
+	MetricCounter*		m_metricDispatched;
+	MetricHistogram*	m_metricDispatchTime;
+	MetricGauge*		m_metricQueueDepth;
+
 public:
 	//
 	// Event type providers.
@@ -157,6 +165,7 @@ public:
 	IKeyStateEvents&			forIKeyState();
 	IPrimaryScreenEvents&		forIPrimaryScreen();
 	IScreenEvents&				forIScreen();
+	ThreadPoolEvents&			forThreadPool();
 
 private:
 	ClientEvents*				m_typesForClient;
@@ -177,6 +186,7 @@ private:
 	IKeyStateEvents*			m_typesForIKeyState;
 	IPrimaryScreenEvents*		m_typesForIPrimaryScreen;
 	IScreenEvents*				m_typesForIScreen;
+	ThreadPoolEvents*			m_typesForThreadPool;
 	Mutex*						m_readyMutex;
 	CondVar<bool>*				m_readyCondVar;
 	std::queue<Event>			m_pending;
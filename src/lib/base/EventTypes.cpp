@@ -83,6 +83,7 @@ REGISTER_EVENT(IpcServerProxy, messageReceived)
 
 REGISTER_EVENT(IDataSocket, connected)
 REGISTER_EVENT(IDataSocket, connectionFailed)
+REGISTER_EVENT(IDataSocket, secureConnected)
 
 //
 // IListenSocket
@@ -186,3 +187,9 @@ REGISTER_EVENT(IScreen, fileRecieveCompleted)
 
 REGISTER_EVENT(IpcServer, clientConnected)
 REGISTER_EVENT(IpcServer, messageReceived)
+
+//
+// ThreadPool
+//
+
+REGISTER_EVENT(ThreadPool, completed)
@@ -230,7 +230,8 @@ class IDataSocketEvents : public EventTypes {
 public:
 	IDataSocketEvents() :
 		m_connected(Event::kUnknown),
-		m_connectionFailed(Event::kUnknown) { }
+		m_connectionFailed(Event::kUnknown),
+		m_secureConnected(Event::kUnknown) { }
 
 	//! @name accessors
 	//@{
@@ -250,11 +251,20 @@ public:
 	*/
 	Event::Type		connectionFailed();
 
+	//! Get secure connected event type
+	/*!
+	Returns the secure connected event type.  A secure socket sends
+	this event when its SSL handshake has completed and data can be
+	exchanged.
+	*/
+	Event::Type		secureConnected();
+
 	//@}
 
 private:
 	Event::Type		m_connected;
 	Event::Type		m_connectionFailed;
+	Event::Type		m_secureConnected;
 };
 
 class IListenSocketEvents : public EventTypes {
@@ -687,3 +697,24 @@ private:
 	Event::Type		m_fileChunkSending;
 	Event::Type		m_fileRecieveCompleted;
 };
+
+class ThreadPoolEvents : public EventTypes {
+public:
+	ThreadPoolEvents() :
+		m_completed(Event::kUnknown) { }
+
+	//! @name accessors
+	//@{
+
+	//! Get completed event type
+	/*!
+	Returns the completed event type.  This is sent to the target a job
+	was queued with once the job has run on a worker thread.
+	*/
+	Event::Type		completed();
+
+	//@}
+
+private:
+	Event::Type		m_completed;
+};
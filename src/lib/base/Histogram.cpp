@@ -0,0 +1,144 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Histogram.h"
+
+#include <cstring>
+
+//
+// Histogram
+//
+
+Histogram::Histogram()
+{
+	reset();
+}
+
+void
+Histogram::add(UInt32 value)
+{
+	++m_buckets[getBucketIndex(value)];
+	++m_count;
+	m_sum += static_cast<double>(value);
+	if (value > m_max) {
+		m_max = value;
+	}
+}
+
+void
+Histogram::merge(const Histogram& other)
+{
+	for (UInt32 i = 0; i < kNumBuckets; ++i) {
+		m_buckets[i] += other.m_buckets[i];
+	}
+	m_count += other.m_count;
+	m_sum   += other.m_sum;
+	if (other.m_max > m_max) {
+		m_max = other.m_max;
+	}
+}
+
+void
+Histogram::reset()
+{
+	memset(m_buckets, 0, sizeof(m_buckets));
+	m_count = 0;
+	m_max   = 0;
+	m_sum   = 0.0;
+}
+
+UInt32
+Histogram::getCount() const
+{
+	return m_count;
+}
+
+UInt32
+Histogram::getMax() const
+{
+	return m_max;
+}
+
+double
+Histogram::getMean() const
+{
+	if (m_count == 0) {
+		return 0.0;
+	}
+	return m_sum / static_cast<double>(m_count);
+}
+
+UInt32
+Histogram::getPercentile(double percent) const
+{
+	if (m_count == 0) {
+		return 0;
+	}
+
+	// find the bucket holding the sample with the requested rank
+	double rank = percent / 100.0 * static_cast<double>(m_count);
+	UInt32 target = static_cast<UInt32>(rank);
+	if (static_cast<double>(target) < rank || target == 0) {
+		++target;
+	}
+	if (target > m_count) {
+		target = m_count;
+	}
+
+	UInt32 seen = 0;
+	for (UInt32 i = 0; i < kNumBuckets; ++i) {
+		seen += m_buckets[i];
+		if (seen >= target) {
+			UInt32 bound = getBucketUpperBound(i);
+			return (bound < m_max) ? bound : m_max;
+		}
+	}
+	return m_max;
+}
+
+UInt32
+Histogram::getBucketCount(UInt32 index) const
+{
+	return (index < kNumBuckets) ? m_buckets[index] : 0;
+}
+
+UInt32
+Histogram::getBucketUpperBound(UInt32 index)
+{
+	if (index < 4) {
+		return index;
+	}
+	UInt32 shift = index / 4 - 1;
+	UInt32 lower = (4 + (index & 3)) << shift;
+	return lower + ((1u << shift) - 1);
+}
+
+UInt32
+Histogram::getBucketIndex(UInt32 value)
+{
+	if (value < 4) {
+		return value;
+	}
+
+	// find the highest set bit.  the two bits below it pick the
+	// sub-bucket.
+	UInt32 exponent = 2;
+	while (exponent < 31 && (value >> (exponent + 1)) != 0) {
+		++exponent;
+	}
+	return 4 * (exponent - 1) + ((value >> (exponent - 2)) & 3);
+}
@@ -0,0 +1,86 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/basic_types.h"
+
+//! Fixed bucket histogram
+/*!
+Records unsigned 32-bit samples into a fixed set of logarithmic buckets
+(four linear sub-buckets per power of two) so that recording is constant
+time and allocation free.  Percentiles are therefore approximate; they
+are reported as the upper bound of the bucket containing the requested
+rank, which is within 25% of the true value.
+*/
+class Histogram {
+public:
+	enum {
+		kNumBuckets = 124
+	};
+
+	Histogram();
+
+	//! @name manipulators
+	//@{
+
+	//! Record a sample
+	void				add(UInt32 value);
+
+	//! Add all samples in \p other
+	void				merge(const Histogram& other);
+
+	//! Discard all samples
+	void				reset();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the number of samples
+	UInt32				getCount() const;
+
+	//! Get the largest sample, 0 if there are none
+	UInt32				getMax() const;
+
+	//! Get the mean of the samples, 0 if there are none
+	double				getMean() const;
+
+	//! Get a percentile
+	/*!
+	Returns the approximate value below which \p percent (0 to 100) of
+	the samples fall.  Returns 0 if there are no samples.
+	*/
+	UInt32				getPercentile(double percent) const;
+
+	//! Get the sample count in bucket \p index
+	UInt32				getBucketCount(UInt32 index) const;
+
+	//! Get the largest value stored in bucket \p index
+	static UInt32		getBucketUpperBound(UInt32 index);
+
+	//! Get the bucket that \p value is recorded in
+	static UInt32		getBucketIndex(UInt32 value);
+
+	//@}
+
+private:
+	UInt32				m_buckets[kNumBuckets];
+	UInt32				m_count;
+	UInt32				m_max;
+	double				m_sum;
+};
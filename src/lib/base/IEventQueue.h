@@ -48,6 +48,7 @@ class ServerAppEvents;
 class IKeyStateEvents;
 class IPrimaryScreenEvents;
 class IScreenEvents;
+class ThreadPoolEvents;
 
 //! Event queue interface
 /*!
@@ -244,4 +245,5 @@ public:
 	virtual IKeyStateEvents&			forIKeyState() = 0;
 	virtual IPrimaryScreenEvents&		forIPrimaryScreen() = 0;
 	virtual IScreenEvents&				forIScreen() = 0;
+	virtual ThreadPoolEvents&			forThreadPool() = 0;
 };
@@ -0,0 +1,407 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Metrics.h"
+
+#include "arch/Arch.h"
+
+#if defined(_MSC_VER)
+#	define WIN32_LEAN_AND_MEAN
+#	include <Windows.h>
+#endif
+
+//
+// atomic helpers
+//
+
+static inline
+UInt64
+atomicAdd(volatile UInt64* value, UInt64 delta)
+{
+#if defined(_MSC_VER)
+	return static_cast<UInt64>(InterlockedExchangeAdd64(
+		reinterpret_cast<volatile LONGLONG*>(value),
+		static_cast<LONGLONG>(delta))) + delta;
+#else
+	return __sync_add_and_fetch(value, delta);
+#endif
+}
+
+static inline
+UInt32
+atomicAdd(volatile UInt32* value, UInt32 delta)
+{
+#if defined(_MSC_VER)
+	return static_cast<UInt32>(InterlockedExchangeAdd(
+		reinterpret_cast<volatile LONG*>(value),
+		static_cast<LONG>(delta))) + delta;
+#else
+	return __sync_add_and_fetch(value, delta);
+#endif
+}
+
+static inline
+void
+atomicStore(volatile UInt64* value, UInt64 newValue)
+{
+#if defined(_MSC_VER)
+	InterlockedExchange64(reinterpret_cast<volatile LONGLONG*>(value),
+		static_cast<LONGLONG>(newValue));
+#else
+	UInt64 old = *value;
+	UInt64 seen;
+	while ((seen = __sync_val_compare_and_swap(value, old, newValue)) != old) {
+		old = seen;
+	}
+#endif
+}
+
+// reads go through an atomic add so 64-bit values can't tear on
+// 32-bit platforms
+static inline
+UInt64
+atomicLoad(const volatile UInt64* value)
+{
+	return atomicAdd(const_cast<volatile UInt64*>(value), 0);
+}
+
+// largest bucket given its own le boundary when formatting histograms;
+// anything above falls in +Inf
+static const UInt32		kMaxFormattedBucket = 95;
+
+
+//
+// MetricCounter
+//
+
+MetricCounter::MetricCounter() :
+	m_value(0)
+{
+	// do nothing
+}
+
+void
+MetricCounter::increment(UInt64 n)
+{
+	atomicAdd(&m_value, n);
+}
+
+UInt64
+MetricCounter::getValue() const
+{
+	return atomicLoad(&m_value);
+}
+
+
+//
+// MetricGauge
+//
+
+MetricGauge::MetricGauge() :
+	m_value(0)
+{
+	// do nothing
+}
+
+void
+MetricGauge::add(SInt64 delta)
+{
+	atomicAdd(reinterpret_cast<volatile UInt64*>(&m_value),
+		static_cast<UInt64>(delta));
+}
+
+void
+MetricGauge::set(SInt64 value)
+{
+	atomicStore(reinterpret_cast<volatile UInt64*>(&m_value),
+		static_cast<UInt64>(value));
+}
+
+SInt64
+MetricGauge::getValue() const
+{
+	return static_cast<SInt64>(atomicLoad(
+		reinterpret_cast<const volatile UInt64*>(&m_value)));
+}
+
+
+//
+// MetricHistogram
+//
+
+MetricHistogram::MetricHistogram() :
+	m_count(0),
+	m_sum(0)
+{
+	for (UInt32 i = 0; i < Histogram::kNumBuckets; ++i) {
+		m_buckets[i] = 0;
+	}
+}
+
+void
+MetricHistogram::observe(UInt32 value)
+{
+	atomicAdd(&m_buckets[Histogram::getBucketIndex(value)], 1);
+	atomicAdd(&m_count, 1);
+	atomicAdd(&m_sum, value);
+}
+
+UInt32
+MetricHistogram::getBucketCount(UInt32 index) const
+{
+	if (index >= Histogram::kNumBuckets) {
+		return 0;
+	}
+	return m_buckets[index];
+}
+
+UInt64
+MetricHistogram::getCount() const
+{
+	return atomicLoad(&m_count);
+}
+
+UInt64
+MetricHistogram::getSum() const
+{
+	return atomicLoad(&m_sum);
+}
+
+
+//
+// Metrics
+//
+
+Metrics::Metrics() :
+	m_mutex(ARCH->newMutex())
+{
+	// do nothing
+}
+
+Metrics::~Metrics()
+{
+	// the registry is destroyed after main() returns when ARCH is gone,
+	// so the mutex is left for the OS to reclaim.
+	for (EntryMap::iterator i = m_entries.begin(); i != m_entries.end(); ++i) {
+		deleteMetric(i->second);
+	}
+}
+
+Metrics*
+Metrics::getInstance()
+{
+	static Metrics s_instance;
+	return &s_instance;
+}
+
+MetricCounter*
+Metrics::counter(const char* name, const char* help, const String& labels)
+{
+	return static_cast<MetricCounter*>(find(kCounter, name, help, labels));
+}
+
+MetricGauge*
+Metrics::gauge(const char* name, const char* help, const String& labels)
+{
+	return static_cast<MetricGauge*>(find(kGauge, name, help, labels));
+}
+
+MetricHistogram*
+Metrics::histogram(const char* name, const char* help, const String& labels)
+{
+	return static_cast<MetricHistogram*>(find(kHistogram, name, help, labels));
+}
+
+void
+Metrics::retain(const String& labels)
+{
+	ArchMutexLock lock(m_mutex);
+	++m_retained[labels];
+}
+
+void
+Metrics::release(const String& labels)
+{
+	ArchMutexLock lock(m_mutex);
+
+	RetainMap::iterator held = m_retained.find(labels);
+	assert(held != m_retained.end());
+	if (held == m_retained.end() || --held->second > 0) {
+		return;
+	}
+	m_retained.erase(held);
+
+	for (EntryMap::iterator i = m_entries.begin(); i != m_entries.end(); ) {
+		if (i->first.second == labels) {
+			deleteMetric(i->second);
+			m_entries.erase(i++);
+		}
+		else {
+			++i;
+		}
+	}
+}
+
+void*
+Metrics::find(EType type, const char* name, const char* help,
+				const String& labels)
+{
+	ArchMutexLock lock(m_mutex);
+
+	Key key(name, labels);
+	EntryMap::iterator i = m_entries.find(key);
+	if (i != m_entries.end()) {
+		assert(i->second.m_type == type);
+		return i->second.m_metric;
+	}
+
+	Entry& entry = m_entries[key];
+	entry.m_type = type;
+	entry.m_help = help;
+	switch (type) {
+	case kCounter:
+		entry.m_metric = new MetricCounter;
+		break;
+
+	case kGauge:
+		entry.m_metric = new MetricGauge;
+		break;
+
+	case kHistogram:
+		entry.m_metric = new MetricHistogram;
+		break;
+	}
+	return entry.m_metric;
+}
+
+void
+Metrics::deleteMetric(const Entry& entry)
+{
+	switch (entry.m_type) {
+	case kCounter:
+		delete static_cast<MetricCounter*>(entry.m_metric);
+		break;
+
+	case kGauge:
+		delete static_cast<MetricGauge*>(entry.m_metric);
+		break;
+
+	case kHistogram:
+		delete static_cast<MetricHistogram*>(entry.m_metric);
+		break;
+	}
+}
+
+String
+Metrics::format() const
+{
+	using synergy::string::sprintf;
+
+	ArchMutexLock lock(m_mutex);
+
+	String out;
+	String family;
+	for (EntryMap::const_iterator i = m_entries.begin();
+							i != m_entries.end(); ++i) {
+		const String& name   = i->first.first;
+		const String& labels = i->first.second;
+		const Entry& entry   = i->second;
+
+		// header once per family
+		if (name != family) {
+			family = name;
+			static const char* s_typeNames[] = {
+				"counter", "gauge", "histogram"
+			};
+			out += sprintf("# HELP %s %s\n", name.c_str(), entry.m_help.c_str());
+			out += sprintf("# TYPE %s %s\n", name.c_str(), s_typeNames[entry.m_type]);
+		}
+
+		String braced;
+		if (!labels.empty()) {
+			braced = "{" + labels + "}";
+		}
+
+		switch (entry.m_type) {
+		case kCounter: {
+			const MetricCounter* c = static_cast<const MetricCounter*>(entry.m_metric);
+			out += sprintf("%s%s %llu\n", name.c_str(), braced.c_str(),
+							c->getValue());
+			break;
+		}
+
+		case kGauge: {
+			const MetricGauge* g = static_cast<const MetricGauge*>(entry.m_metric);
+			out += sprintf("%s%s %lld\n", name.c_str(), braced.c_str(),
+							g->getValue());
+			break;
+		}
+
+		case kHistogram: {
+			const MetricHistogram* h = static_cast<const MetricHistogram*>(entry.m_metric);
+			String prefix = labels.empty() ? String() : labels + ",";
+
+			// cumulative buckets at each power of two boundary
+			UInt64 cumulative = 0;
+			for (UInt32 b = 0; b <= kMaxFormattedBucket; ++b) {
+				cumulative += h->getBucketCount(b);
+				if ((b & 3) == 3) {
+					out += sprintf("%s_bucket{%sle=\"%u\"} %llu\n",
+							name.c_str(), prefix.c_str(),
+							Histogram::getBucketUpperBound(b), cumulative);
+				}
+			}
+			UInt64 count = h->getCount();
+			out += sprintf("%s_bucket{%sle=\"+Inf\"} %llu\n",
+							name.c_str(), prefix.c_str(), count);
+			out += sprintf("%s_sum%s %llu\n", name.c_str(), braced.c_str(),
+							h->getSum());
+			out += sprintf("%s_count%s %llu\n", name.c_str(), braced.c_str(),
+							count);
+			break;
+		}
+		}
+	}
+	return out;
+}
+
+String
+Metrics::label(const char* name, const String& value)
+{
+	String escaped;
+	escaped.reserve(value.size());
+	for (String::const_iterator i = value.begin(); i != value.end(); ++i) {
+		switch (*i) {
+		case '\\':
+			escaped += "\\\\";
+			break;
+
+		case '"':
+			escaped += "\\\"";
+			break;
+
+		case '\n':
+			escaped += "\\n";
+			break;
+
+		default:
+			escaped += *i;
+			break;
+		}
+	}
+	return String(name) + "=\"" + escaped + "\"";
+}
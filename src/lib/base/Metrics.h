@@ -0,0 +1,196 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "arch/IArchMultithread.h"
+#include "base/Histogram.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stdmap.h"
+
+#define METRICS (Metrics::getInstance())
+
+//! Monotonically increasing counter metric
+/*!
+Updates are atomic so counters may be bumped from any thread without
+locking.
+*/
+class MetricCounter {
+public:
+	MetricCounter();
+
+	//! Add \p n to the counter
+	void				increment(UInt64 n = 1);
+
+	//! Get the current value
+	UInt64				getValue() const;
+
+private:
+	volatile UInt64		m_value;
+};
+
+//! Gauge metric
+/*!
+A value that can go up and down, such as a queue depth.  Updates are
+atomic.
+*/
+class MetricGauge {
+public:
+	MetricGauge();
+
+	//! Add \p delta (which may be negative) to the gauge
+	void				add(SInt64 delta);
+
+	//! Set the gauge to \p value
+	void				set(SInt64 value);
+
+	//! Get the current value
+	SInt64				getValue() const;
+
+private:
+	volatile SInt64		m_value;
+};
+
+//! Histogram metric
+/*!
+Records samples into the same logarithmic buckets as \c Histogram
+using atomic updates so observing a sample never takes a lock.
+*/
+class MetricHistogram {
+public:
+	MetricHistogram();
+
+	//! Record a sample
+	void				observe(UInt32 value);
+
+	//! Get the number of samples in bucket \p index
+	UInt32				getBucketCount(UInt32 index) const;
+
+	//! Get the number of samples
+	UInt64				getCount() const;
+
+	//! Get the sum of the samples
+	UInt64				getSum() const;
+
+private:
+	volatile UInt32		m_buckets[Histogram::kNumBuckets];
+	volatile UInt64		m_count;
+	volatile UInt64		m_sum;
+};
+
+//! Metrics registry
+/*!
+A process wide registry of named counters, gauges and histograms.
+Metrics are created on first use and live until the process exits, so
+callers typically look a metric up once and keep the pointer.  The same
+name and labels always return the same metric.  The exception is series
+whose labels are held with \c retain(), which are removed when the last
+hold is released.
+
+The registry can be rendered in the Prometheus text exposition format.
+*/
+class Metrics {
+public:
+	//! @name manipulators
+	//@{
+
+	//! Get or create a counter
+	/*!
+	\p labels is either empty or a comma separated list of label pairs
+	as produced by \c label().
+	*/
+	MetricCounter*		counter(const char* name, const char* help,
+							const String& labels = String());
+
+	//! Get or create a gauge
+	MetricGauge*		gauge(const char* name, const char* help,
+							const String& labels = String());
+
+	//! Get or create a histogram
+	MetricHistogram*	histogram(const char* name, const char* help,
+							const String& labels = String());
+
+	//! Hold the series with \p labels
+	/*!
+	Holds nest.  Use this for series that belong to something that goes
+	away, such as a client, so they don't accumulate.
+	*/
+	void				retain(const String& labels);
+
+	//! Release the series with \p labels
+	/*!
+	Undoes one \c retain().  When the last hold is released every series
+	with exactly \p labels is removed and freed, so pointers to those
+	metrics must not be used afterwards.
+	*/
+	void				release(const String& labels);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Format all metrics
+	/*!
+	Returns all metrics in the Prometheus text exposition format.
+	*/
+	String				format() const;
+
+	//! Format a label pair
+	/*!
+	Returns \c name="value" with \p value escaped as required.
+	*/
+	static String		label(const char* name, const String& value);
+
+	//! Get the singleton instance
+	/*!
+	The registry is created on first use, which must be after \c Arch
+	has been initialized.
+	*/
+	static Metrics*		getInstance();
+
+	//@}
+
+private:
+	Metrics();
+	~Metrics();
+
+	enum EType { kCounter, kGauge, kHistogram };
+
+	class Entry {
+	public:
+		EType			m_type;
+		String			m_help;
+		void*			m_metric;
+	};
+
+	// ordered by name then labels so each family is contiguous
+	typedef std::pair<String, String> Key;
+	typedef std::map<Key, Entry> EntryMap;
+
+	// holds per label set
+	typedef std::map<String, UInt32> RetainMap;
+
+	void*				find(EType, const char* name, const char* help,
+							const String& labels);
+	static void			deleteMetric(const Entry&);
+
+private:
+	ArchMutex			m_mutex;
+	EntryMap			m_entries;
+	RetainMap			m_retained;
+};
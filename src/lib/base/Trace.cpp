@@ -0,0 +1,252 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Trace.h"
+
+#include "arch/Arch.h"
+#include "base/String.h"
+
+#include <fstream>
+#include <stdio.h>
+
+#if defined(_MSC_VER)
+#	include <windows.h>
+#	define TRACE_THREAD_LOCAL __declspec(thread)
+#	define TRACE_MEMORY_BARRIER() MemoryBarrier()
+#else
+#	define TRACE_THREAD_LOCAL __thread
+#	define TRACE_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+// the calling thread's buffer and name.  the buffer is a Trace::ThreadBuffer
+// owned by the Trace instance.
+static TRACE_THREAD_LOCAL void*			s_threadBuffer = NULL;
+static TRACE_THREAD_LOCAL const char*	s_threadName   = NULL;
+
+static
+String
+escapeJson(const char* s)
+{
+	String escaped;
+	for (; *s != '\0'; ++s) {
+		switch (*s) {
+		case '"':
+			escaped += "\\\"";
+			break;
+
+		case '\\':
+			escaped += "\\\\";
+			break;
+
+		default:
+			if (static_cast<unsigned char>(*s) < 0x20) {
+				escaped += ' ';
+			}
+			else {
+				escaped += *s;
+			}
+			break;
+		}
+	}
+	return escaped;
+}
+
+//
+// Trace
+//
+
+volatile bool			Trace::s_enabled = false;
+
+Trace::Trace() :
+	m_mutex(ARCH->newMutex()),
+	m_startTime(0.0)
+{
+}
+
+Trace::~Trace()
+{
+	// like Metrics, this may run after Arch has gone away so the mutex
+	// and buffers are left for the system to reclaim
+}
+
+Trace*
+Trace::getInstance()
+{
+	static Trace s_instance;
+	return &s_instance;
+}
+
+void
+Trace::start()
+{
+	ArchMutexLock lock(m_mutex);
+	if (m_startTime == 0.0) {
+		m_startTime = ARCH->time();
+	}
+	s_enabled = true;
+}
+
+void
+Trace::stop()
+{
+	ArchMutexLock lock(m_mutex);
+	pause();
+}
+
+void
+Trace::setThreadName(const char* name)
+{
+	s_threadName = name;
+	ThreadBuffer* buffer = static_cast<ThreadBuffer*>(s_threadBuffer);
+	if (buffer != NULL) {
+		buffer->m_name = name;
+	}
+}
+
+void
+Trace::record(const char* category, const char* name, double start, double end)
+{
+	ThreadBuffer* buffer = getThreadBuffer();
+
+	// only this thread writes to its buffer so no locking is needed.
+	// but pause() must be able to tell when we're done, so flag the
+	// write and only then check that recording is still on.  the
+	// barriers pair with the one in pause().
+	buffer->m_recording = true;
+	TRACE_MEMORY_BARRIER();
+	if (s_enabled) {
+		Span& span      = buffer->m_spans[buffer->m_next % kThreadCapacity];
+		span.m_category = category;
+		span.m_name     = name;
+		span.m_start    = start;
+		span.m_end      = end;
+		buffer->m_next  = buffer->m_next + 1;
+	}
+	TRACE_MEMORY_BARRIER();
+	buffer->m_recording = false;
+}
+
+Trace::ThreadBuffer*
+Trace::getThreadBuffer()
+{
+	ThreadBuffer* buffer = static_cast<ThreadBuffer*>(s_threadBuffer);
+	if (buffer == NULL) {
+		buffer           = new ThreadBuffer;
+		buffer->m_name   = s_threadName;
+		buffer->m_spans  = new Span[kThreadCapacity];
+		buffer->m_next   = 0;
+		buffer->m_recording = false;
+
+		ArchMutexLock lock(m_mutex);
+		buffer->m_id     = static_cast<UInt32>(m_buffers.size()) + 1;
+		m_buffers.push_back(buffer);
+		s_threadBuffer   = buffer;
+	}
+	return buffer;
+}
+
+bool
+Trace::write(const char* filename) const
+{
+	std::ofstream out(filename, std::ios::out | std::ios::trunc);
+	if (!out.is_open()) {
+		return false;
+	}
+
+	// copy the spans with recording paused so no thread is writing the
+	// ring we're reading, then carry on recording while we format
+	std::vector<ThreadSnapshot> snapshots;
+	{
+		ArchMutexLock lock(m_mutex);
+		bool wasEnabled = pause();
+		snapshots.resize(m_buffers.size());
+		for (size_t b = 0; b < m_buffers.size(); ++b) {
+			const ThreadBuffer* buffer = m_buffers[b];
+			ThreadSnapshot& snapshot   = snapshots[b];
+			snapshot.m_id   = buffer->m_id;
+			snapshot.m_name = buffer->m_name;
+
+			// once the ring has wrapped, the oldest span is the next
+			// one to be overwritten
+			UInt32 next  = buffer->m_next;
+			UInt32 count = (next < kThreadCapacity) ? next : kThreadCapacity;
+			snapshot.m_spans.reserve(count);
+			for (UInt32 i = next - count; i != next; ++i) {
+				snapshot.m_spans.push_back(buffer->m_spans[i % kThreadCapacity]);
+			}
+		}
+		s_enabled = wasEnabled;
+	}
+
+	char line[128];
+	const char* separator = "";
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (size_t b = 0; b < snapshots.size(); ++b) {
+		const ThreadSnapshot& snapshot = snapshots[b];
+
+		if (snapshot.m_name != NULL) {
+			sprintf(line, "\"ph\":\"M\",\"pid\":1,\"tid\":%u,", snapshot.m_id);
+			out << separator << "\n{" << line
+				<< "\"name\":\"thread_name\",\"args\":{\"name\":\""
+				<< escapeJson(snapshot.m_name) << "\"}}";
+			separator = ",";
+		}
+
+		for (size_t i = 0; i < snapshot.m_spans.size(); ++i) {
+			const Span& span = snapshot.m_spans[i];
+			sprintf(line,
+				"\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,",
+				snapshot.m_id,
+				1.0e+6 * (span.m_start - m_startTime),
+				1.0e+6 * (span.m_end - span.m_start));
+			out << separator << "\n{" << line
+				<< "\"cat\":\"" << escapeJson(span.m_category)
+				<< "\",\"name\":\"" << escapeJson(span.m_name) << "\"}";
+			separator = ",";
+		}
+	}
+	out << "\n]}\n";
+
+	return out.good();
+}
+
+bool
+Trace::pause() const
+{
+	bool wasEnabled = s_enabled;
+	s_enabled = false;
+	TRACE_MEMORY_BARRIER();
+
+	// a thread that flagged a write before seeing the change may still
+	// be writing.  spans are a few stores so this is brief.
+	for (size_t b = 0; b < m_buffers.size(); ++b) {
+		while (m_buffers[b]->m_recording) {
+			ARCH->sleep(0.0);
+		}
+	}
+	return wasEnabled;
+}
+
+//
+// TraceSpan
+//
+
+double
+TraceSpan::now()
+{
+	return ARCH->time();
+}
@@ -0,0 +1,161 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "arch/IArchMultithread.h"
+#include "common/basic_types.h"
+#include "common/stdvector.h"
+
+#define TRACE (Trace::getInstance())
+
+//! Event loop tracer
+/*!
+Records timestamped spans for offline analysis of where the time goes
+between input arriving and being injected.  Each thread records into
+its own ring buffer without locking; the buffers are only read when
+the trace is written, with recording briefly paused.  Recording is off
+unless \c start() has been called, in which case a span costs two
+clock reads.
+
+The trace is written in the Chrome trace event JSON format, which can
+be loaded by chrome://tracing and the Perfetto UI.
+*/
+class Trace {
+public:
+	//! @name manipulators
+	//@{
+
+	//! Start recording spans
+	void				start();
+
+	//! Stop recording spans
+	/*!
+	Returns once no thread is still recording a span.
+	*/
+	void				stop();
+
+	//! Name the calling thread
+	/*!
+	The name is shown for the thread's track in the trace.  It may be
+	set before recording starts.  \p name must remain valid for the life
+	of the process.
+	*/
+	void				setThreadName(const char* name);
+
+	//! Record a span on the calling thread
+	/*!
+	\p category and \p name must remain valid for the life of the
+	process; string literals and registered event type names are.
+	\p start and \p end are \c ARCH->time() values.
+	*/
+	void				record(const char* category, const char* name,
+							double start, double end);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Write the trace
+	/*!
+	Writes all recorded spans to \p filename as Chrome trace JSON.
+	Recording is paused while the spans are copied so this is safe to
+	call while recording.  Returns false if the file can't be written.
+	*/
+	bool				write(const char* filename) const;
+
+	//! Check if spans are being recorded
+	static bool			isEnabled() { return s_enabled; }
+
+	//! Get the singleton instance
+	static Trace*		getInstance();
+
+	//@}
+
+	enum {
+		//! Spans kept per thread; older spans are overwritten
+		kThreadCapacity = 65536
+	};
+
+private:
+	Trace();
+	~Trace();
+
+	class Span {
+	public:
+		const char*		m_category;
+		const char*		m_name;
+		double			m_start;
+		double			m_end;
+	};
+
+	class ThreadBuffer {
+	public:
+		UInt32			m_id;
+		const char*		m_name;
+		Span*			m_spans;
+		volatile UInt32	m_next;
+		volatile bool	m_recording;
+	};
+
+	class ThreadSnapshot {
+	public:
+		UInt32			m_id;
+		const char*		m_name;
+		std::vector<Span>	m_spans;
+	};
+
+	ThreadBuffer*		getThreadBuffer();
+
+	// stop recording and wait for spans being written to finish.  the
+	// caller must hold m_mutex.  returns true if recording was on.
+	bool				pause() const;
+
+private:
+	ArchMutex			m_mutex;
+	std::vector<ThreadBuffer*>	m_buffers;
+	double				m_startTime;
+
+	static volatile bool s_enabled;
+};
+
+//! Scoped trace span
+/*!
+Records a span covering its own lifetime on the calling thread when
+tracing is enabled, and does nothing otherwise.
+*/
+class TraceSpan {
+public:
+	TraceSpan(const char* category, const char* name) :
+		m_category(category),
+		m_name(name),
+		m_start(Trace::isEnabled() ? now() : 0.0) { }
+	~TraceSpan()
+	{
+		if (m_start != 0.0) {
+			TRACE->record(m_category, m_name, m_start, now());
+		}
+	}
+
+private:
+	static double		now();
+
+private:
+	const char*			m_category;
+	const char*			m_name;
+	double				m_start;
+};
@@ -29,7 +29,7 @@
 #include "synergy/XSynergy.h"
 #include "synergy/FileChunker.h"
 #include "synergy/IPlatformScreen.h"
-#include "mt/Thread.h"
+#include "mt/ThreadPool.h"
 #include "net/TCPSocket.h"
 #include "net/IDataSocket.h"
 #include "net/ISocketFactory.h"
@@ -75,8 +75,6 @@ Client::Client(
 	m_suspended(false),
 	m_connectOnResume(false),
 	m_events(events),
-	m_sendFileThread(NULL),
-	m_writeToDropDirThread(NULL),
 	m_enableDragDrop(enableDragDrop),
 	m_socket(NULL),
 	m_useSecureNetwork(false)
@@ -185,7 +183,7 @@ Client::connect()
 }
 
 void
-Client::disconnect(const char* msg)
+Client::disconnect(const char* msg, double retryAfter)
 {
 	m_connectOnResume = false;
 	cleanupTimer();
@@ -193,7 +191,7 @@ Client::disconnect(const char* msg)
 	cleanupConnecting();
 	cleanupConnection();
 	if (msg != NULL) {
-		sendConnectionFailedEvent(msg);
+		sendConnectionFailedEvent(msg, retryAfter);
 	}
 	else {
 		sendEvent(m_events->forClient().disconnected(), NULL);
@@ -412,10 +410,11 @@ Client::sendEvent(Event::Type type, void* data)
 }
 
 void
-Client::sendConnectionFailedEvent(const char* msg)
+Client::sendConnectionFailedEvent(const char* msg, double retryAfter)
 {
-	FailInfo* info = new FailInfo(msg);
-	info->m_retry = true;
+	FailInfo* info     = new FailInfo(msg);
+	info->m_retry      = true;
+	info->m_retryAfter = retryAfter;
 	Event event(m_events->forClient().connectionFailed(), getEventTarget(), info, Event::kDontFreeData);
 	m_events->addEvent(event);
 }
@@ -675,18 +674,22 @@ Client::handleHello(const Event&, void*)
 	// check versions
 	LOG((CLOG_DEBUG1 "got hello version %d.%d", major, minor));
 	if (major < kProtocolMajorVersion ||
-		(major == kProtocolMajorVersion && minor < kProtocolMinorVersion)) {
+		(major == kProtocolMajorVersion && minor < kProtocolMinimumMinorVersion)) {
 		sendConnectionFailedEvent(XIncompatibleClient(major, minor).what());
 		cleanupTimer();
 		cleanupConnection();
 		return;
 	}
 
-	// say hello back
-	LOG((CLOG_DEBUG1 "say hello version %d.%d", kProtocolMajorVersion, kProtocolMinorVersion));
+	// say hello back with the highest version we have in common
+	SInt16 helloMinor = kProtocolMinorVersion;
+	if (major == kProtocolMajorVersion && minor < helloMinor) {
+		helloMinor = minor;
+	}
+	LOG((CLOG_DEBUG1 "say hello version %d.%d", kProtocolMajorVersion, helloMinor));
 	ProtocolUtil::writef(m_stream, kMsgHelloBack,
 							kProtocolMajorVersion,
-							kProtocolMinorVersion, &m_name);
+							helloMinor, &m_name);
 
 	// now connected but waiting to complete handshake
 	setupScreen();
@@ -738,7 +741,7 @@ void
 Client::onFileRecieveCompleted()
 {
 	if (isReceivedFileSizeValid()) {
-		m_writeToDropDirThread = new Thread(
+		ThreadPool::getInstance()->run(
 			new TMethodJob<Client>(
 				this, &Client::writeToDropDirThread));
 	}
@@ -799,7 +802,7 @@ Client::isReceivedFileSizeValid()
 void
 Client::sendFileToServer(const char* filename)
 {
-	m_sendFileThread = new Thread(
+	ThreadPool::getInstance()->run(
 		new TMethodJob<Client>(
 			this, &Client::sendFileThread,
 			reinterpret_cast<void*>(const_cast<char*>(filename))));
@@ -815,8 +818,6 @@ Client::sendFileThread(void* filename)
 	catch (std::runtime_error error) {
 		LOG((CLOG_ERR "failed sending file chunks: %s", error.what()));
 	}
-
-	m_sendFileThread = NULL;
 }
 
 void
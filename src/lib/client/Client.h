@@ -33,7 +33,6 @@ class IDataSocket;
 class ISocketFactory;
 namespace synergy { class IStream; }
 class IEventQueue;
-class Thread;
 class TCPSocket;
 
 //! Synergy client
@@ -44,8 +43,9 @@ class Client : public IClient, public INode {
 public:
 	class FailInfo {
 	public:
-		FailInfo(const char* what) : m_retry(false), m_what(what) { }
+		FailInfo(const char* what) : m_retry(false), m_retryAfter(0.0), m_what(what) { }
 		bool			m_retry;
+		double			m_retryAfter;
 		String			m_what;
 	};
 
@@ -80,8 +80,10 @@ public:
 	//! Disconnect
 	/*!
 	Disconnects from the server with an optional error message.
+	\p retryAfter is the number of seconds the server asked us to wait
+	before connecting again, if it did.
 	*/
-	void				disconnect(const char* msg);
+	void				disconnect(const char* msg, double retryAfter = 0.0);
 
 	//! Notify of handshake complete
 	/*!
@@ -171,7 +173,8 @@ public:
 private:
 	void				sendClipboard(ClipboardID);
 	void				sendEvent(Event::Type, void*);
-	void				sendConnectionFailedEvent(const char* msg);
+	void				sendConnectionFailedEvent(const char* msg,
+							double retryAfter = 0.0);
 	void				sendFileChunk(const void* data);
 	void				sendFileThread(void*);
 	void				writeToDropDirThread(void*);
@@ -222,8 +225,6 @@ private:
 	String				m_receivedFileData;
 	DragFileList		m_dragFileList;
 	String				m_dragFileExt;
-	Thread*				m_sendFileThread;
-	Thread*				m_writeToDropDirThread;
 	bool				m_enableDragDrop;
 	TCPSocket*			m_socket;
 	bool				m_useSecureNetwork;
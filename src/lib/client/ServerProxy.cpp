@@ -36,6 +36,7 @@
 //
 
 const UInt16 ServerProxy::m_intervalThreshold = 1;
+const double ServerProxy::s_latencyReportInterval = 60.0;
 
 ServerProxy::ServerProxy(Client* client, synergy::IStream* stream, IEventQueue* events) :
 	m_client(client),
@@ -54,7 +55,12 @@ ServerProxy::ServerProxy(Client* client, synergy::IStream* stream, IEventQueue*
 	m_events(events),
 	m_stopwatch(true),
 	m_elapsedTime(0),
-	m_receivedDataSize(0)
+	m_receivedDataSize(0),
+	m_measureLatency(false),
+	m_inputTimePending(false),
+	m_inputCaptureTime(0),
+	m_inputSendTime(0),
+	m_inputReceiveTime(0)
 {
 	assert(m_client != NULL);
 	assert(m_stream != NULL);
@@ -206,6 +212,14 @@ ServerProxy::parseHandshakeMessage(const UInt8* code)
 		m_client->disconnect("server reported a protocol error");
 		return kDisconnect;
 	}
+
+	else if (memcmp(code, kMsgERetry, 4) == 0) {
+		SInt32 retryAfter;
+		ProtocolUtil::readf(m_stream, kMsgERetry + 4, &retryAfter);
+		LOG((CLOG_NOTE "server is busy, retry in %.1f seconds", retryAfter / 1000.0));
+		m_client->disconnect("server is busy", retryAfter / 1000.0);
+		return kDisconnect;
+	}
 	else {
 		return kUnknown;
 	}
@@ -216,7 +230,14 @@ ServerProxy::parseHandshakeMessage(const UInt8* code)
 ServerProxy::EResult
 ServerProxy::parseMessage(const UInt8* code)
 {
-	if (memcmp(code, kMsgDMouseMove, 4) == 0) {
+	if (memcmp(code, kMsgDInputTime, 4) == 0) {
+		// timestamps for the input message that follows.  no reply
+		// since that message gets one.
+		inputTime();
+		return kOkay;
+	}
+
+	else if (memcmp(code, kMsgDMouseMove, 4) == 0) {
 		mouseMove();
 	}
 
@@ -252,6 +273,11 @@ ServerProxy::parseMessage(const UInt8* code)
 		// echo keep alives and reset alarm
 		ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
 		resetKeepAliveAlarm();
+		sendClockSync();
+	}
+
+	else if (memcmp(code, kMsgCClockSync, 4) == 0) {
+		clockSync();
 	}
 
 	else if (memcmp(code, kMsgCNoop, 4) == 0) {
@@ -316,6 +342,11 @@ ServerProxy::parseMessage(const UInt8* code)
 		return kUnknown;
 	}
 
+	// the input the last timestamps referred to has been injected
+	if (m_inputTimePending) {
+		recordInputTime();
+	}
+
 	// send a reply.  this is intended to work around a delay when
 	// running a linux server and an OS X (any BSD?) client.  the
 	// client waits to send an ACK (if the system control flag
@@ -335,6 +366,37 @@ ServerProxy::handleKeepAliveAlarm(const Event&, void*)
 	m_client->disconnect("server is not responding");
 }
 
+void
+ServerProxy::sendClockSync()
+{
+	if (m_measureLatency) {
+		ProtocolUtil::writef(m_stream, kMsgCClockSync,
+							InputLatency::now(), 0, 0);
+	}
+}
+
+void
+ServerProxy::recordInputTime()
+{
+	m_inputTimePending = false;
+	m_latency.addInput(m_inputCaptureTime, m_inputSendTime,
+							m_inputReceiveTime, InputLatency::now());
+}
+
+void
+ServerProxy::reportInputLatency()
+{
+	if (m_latencyReportTimer.getTime() < s_latencyReportInterval) {
+		return;
+	}
+	m_latencyReportTimer.reset();
+
+	if (m_latency.getCaptureToSend().getCount() != 0) {
+		LOG((CLOG_INFO "input latency: %s", m_latency.format().c_str()));
+		m_latency.resetInputs();
+	}
+}
+
 void
 ServerProxy::onInfoChanged()
 {
@@ -782,6 +844,10 @@ ServerProxy::resetOptions()
 	// reset keep alive
 	setKeepAliveRate(kKeepAliveRate);
 
+	// stop measuring input latency
+	m_measureLatency   = false;
+	m_inputTimePending = false;
+
 	// reset modifier translation table
 	for (KeyModifierID id = 0; id < kKeyModifierIDLast; ++id) {
 		m_modifierTranslationTable[id] = id;
@@ -824,6 +890,12 @@ ServerProxy::setOptions()
 			// update keep alive
 			setKeepAliveRate(1.0e-3 * static_cast<double>(options[i + 1]));
 		}
+		else if (options[i] == kOptionInputLatency) {
+			m_measureLatency = (options[i + 1] != 0);
+			if (m_measureLatency) {
+				m_latencyReportTimer.reset();
+			}
+		}
 		if (id != kKeyModifierIDNull) {
 			m_modifierTranslationTable[id] =
 				static_cast<KeyModifierID>(options[i + 1]);
@@ -909,6 +981,32 @@ ServerProxy::dragInfoReceived()
 	m_client->dragInfoReceived(fileNum, content);
 }
 
+void
+ServerProxy::inputTime()
+{
+	m_inputReceiveTime = InputLatency::now();
+	if (ProtocolUtil::readf(m_stream, kMsgDInputTime + 4,
+							&m_inputCaptureTime, &m_inputSendTime)) {
+		m_inputTimePending = m_measureLatency;
+	}
+}
+
+void
+ServerProxy::clockSync()
+{
+	UInt32 received = InputLatency::now();
+	UInt32 sent, serverReceived, serverSent;
+	if (!ProtocolUtil::readf(m_stream, kMsgCClockSync + 4,
+							&sent, &serverReceived, &serverSent)) {
+		return;
+	}
+	m_latency.addClockSample(sent, serverReceived, serverSent, received);
+	LOG((CLOG_DEBUG1 "clock offset %+dus rtt %uus",
+		m_latency.getClockOffset(), m_latency.getRoundTrip()));
+
+	reportInputLatency();
+}
+
 void
 ServerProxy::fileChunkSending(UInt8 mark, char* data, size_t dataSize)
 {
@@ -937,3 +1035,4 @@ ServerProxy::sendDragInfo(UInt32 fileCount, const char* info, size_t size)
 	String data(info, size);
 	ProtocolUtil::writef(m_stream, kMsgDDragInfo, fileCount, &data);
 }
+
@@ -20,6 +20,7 @@
 
 #include "synergy/clipboard_types.h"
 #include "synergy/key_types.h"
+#include "synergy/InputLatency.h"
 #include "base/Event.h"
 #include "base/Stopwatch.h"
 #include "base/String.h"
@@ -78,6 +79,11 @@ private:
 	void				resetKeepAliveAlarm();
 	void				setKeepAliveRate(double);
 
+	// input latency measurement
+	void				sendClockSync();
+	void				recordInputTime();
+	void				reportInputLatency();
+
 	// modifier key translation
 	KeyID				translateKey(KeyID) const;
 	KeyModifierMask			translateModifierMask(KeyModifierMask) const;
@@ -106,6 +112,8 @@ private:
 	void				infoAcknowledgment();
 	void				fileChunkReceived();
 	void				dragInfoReceived();
+	void				inputTime();
+	void				clockSync();
 
 private:
 	typedef EResult (ServerProxy::*MessageParser)(const UInt8*);
@@ -134,4 +142,14 @@ private:
 	double				m_elapsedTime;
 	size_t				m_receivedDataSize;
 	static const UInt16	m_intervalThreshold;
+
+	// input latency measurement
+	bool				m_measureLatency;
+	bool				m_inputTimePending;
+	UInt32				m_inputCaptureTime;
+	UInt32				m_inputSendTime;
+	UInt32				m_inputReceiveTime;
+	InputLatency		m_latency;
+	Stopwatch			m_latencyReportTimer;
+	static const double	s_latencyReportInterval;
 };
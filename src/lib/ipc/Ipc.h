@@ -21,11 +21,17 @@
 #define IPC_HOST "127.0.0.1"
 #define IPC_PORT 24801
 
+// where unix domain sockets are supported ipc uses this socket in the
+// profile directory instead of IPC_PORT.
+#define IPC_SOCKET_NAME "ipc.sock"
+
 enum EIpcMessage {
 	kIpcHello,
 	kIpcLogLine,
 	kIpcCommand,
 	kIpcShutdown,
+	kIpcMetrics,
+	kIpcLogBatch,
 };
 
 enum EIpcClientType {
@@ -50,3 +56,13 @@ extern const char*		kIpcMsgCommand;
 // shutdown: daemon -> node
 // the daemon tells synergys/c to shut down gracefully.
 extern const char*		kIpcMsgShutdown;
+
+// metrics: node -> daemon -> gui
+// $1 = the node's metrics in the prometheus text format.
+extern const char*		kIpcMsgMetrics;
+
+// log batch: daemon -> gui
+// $1 = number of log lines dropped before this batch because the buffer
+// was full. $2 = log lines, each a 4 byte big endian length followed by
+// the line.
+extern const char*		kIpcMsgLogBatch;
@@ -18,6 +18,7 @@
 
 #include "ipc/IpcClient.h"
 #include "ipc/Ipc.h"
+#include "ipc/IpcServer.h"
 #include "ipc/IpcServerProxy.h"
 #include "ipc/IpcMessage.h"
 #include "base/TMethodEventJob.h"
@@ -27,8 +28,9 @@
 //
 
 IpcClient::IpcClient(IEventQueue* events, SocketMultiplexer* socketMultiplexer) :
-	m_serverAddress(NetworkAddress(IPC_HOST, IPC_PORT)),
-	m_socket(events, socketMultiplexer),
+	m_serverAddress(IpcServer::getDefaultAddress()),
+	m_socket(events, socketMultiplexer, m_serverAddress.isUnix() ?
+				IArchNetwork::kUNIX : IArchNetwork::kINET),
 	m_server(nullptr),
 	m_events(events)
 {
@@ -44,6 +46,17 @@ IpcClient::IpcClient(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
 	init();
 }
 
+IpcClient::IpcClient(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+				const NetworkAddress& address) :
+	m_serverAddress(address),
+	m_socket(events, socketMultiplexer, m_serverAddress.isUnix() ?
+				IArchNetwork::kUNIX : IArchNetwork::kINET),
+	m_server(nullptr),
+	m_events(events)
+{
+	init();
+}
+
 void
 IpcClient::init()
 {
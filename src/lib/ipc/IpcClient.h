@@ -35,12 +35,14 @@ class IpcClient {
 public:
 	IpcClient(IEventQueue* events, SocketMultiplexer* socketMultiplexer);
 	IpcClient(IEventQueue* events, SocketMultiplexer* socketMultiplexer, int port);
+	IpcClient(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+							const NetworkAddress& address);
 	virtual ~IpcClient();
 
 	//! @name manipulators
 	//@{
 
-	//! Connects to the IPC server at localhost.
+	//! Connects to the IPC server on this host.
 	void				connect();
 	
 	//! Disconnects from the IPC server.
@@ -117,6 +117,9 @@ IpcClientProxy::handleData(const Event&, void*)
 		else if (memcmp(code, kIpcMsgCommand, 4) == 0) {
 			m = parseCommand();
 		}
+		else if (memcmp(code, kIpcMsgMetrics, 4) == 0) {
+			m = parseMetrics();
+		}
 		else {
 			LOG((CLOG_ERR "invalid ipc message"));
 			disconnect();
@@ -151,10 +154,24 @@ IpcClientProxy::send(const IpcMessage& message)
 		break;
 	}
 			
+	case kIpcLogBatch: {
+		const IpcLogBatchMessage& lbm = static_cast<const IpcLogBatchMessage&>(message);
+		ProtocolUtil::writef(&m_stream, kIpcMsgLogBatch,
+							lbm.dropped(), &lbm.frames());
+		break;
+	}
+
 	case kIpcShutdown:
 		ProtocolUtil::writef(&m_stream, kIpcMsgShutdown);
 		break;
 
+	case kIpcMetrics: {
+		const IpcMetricsMessage& mm = static_cast<const IpcMetricsMessage&>(message);
+		String metrics = mm.metrics();
+		ProtocolUtil::writef(&m_stream, kIpcMsgMetrics, &metrics);
+		break;
+	}
+
 	default:
 		LOG((CLOG_ERR "ipc message not supported: %d", message.type()));
 		break;
@@ -184,6 +201,16 @@ IpcClientProxy::parseCommand()
 	return new IpcCommandMessage(command, elevate != 0);
 }
 
+IpcMetricsMessage*
+IpcClientProxy::parseMetrics()
+{
+	String metrics;
+	ProtocolUtil::readf(&m_stream, kIpcMsgMetrics + 4, &metrics);
+
+	// must be deleted by event handler.
+	return new IpcMetricsMessage(metrics);
+}
+
 void
 IpcClientProxy::disconnect()
 {
@@ -27,6 +27,7 @@ namespace synergy { class IStream; }
 class IpcMessage;
 class IpcCommandMessage;
 class IpcHelloMessage;
+class IpcMetricsMessage;
 class IEventQueue;
 
 class IpcClientProxy {
@@ -43,6 +44,7 @@ private:
 	void				handleWriteError(const Event&, void*);
 	IpcHelloMessage*	parseHello();
 	IpcCommandMessage*	parseCommand();
+	IpcMetricsMessage*	parseMetrics();
 	void				disconnect();
 	
 private:
@@ -0,0 +1,176 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ipc/IpcLogBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+
+static const UInt32		kFrameHeaderSize = 4;
+
+//
+// IpcLogBuffer
+//
+
+IpcLogBuffer::IpcLogBuffer(UInt32 capacity) :
+	m_ring(capacity),
+	m_head(0),
+	m_size(0),
+	m_numLines(0),
+	m_dropped(0)
+{
+	assert(capacity > kFrameHeaderSize);
+}
+
+void
+IpcLogBuffer::append(const char* text, UInt32 size)
+{
+	const UInt32 capacity = static_cast<UInt32>(m_ring.size());
+	if (size > capacity - kFrameHeaderSize) {
+		size = capacity - kFrameHeaderSize;
+	}
+
+	while (capacity - m_size < kFrameHeaderSize + size) {
+		dropOldest();
+	}
+
+	UInt8 header[kFrameHeaderSize];
+	header[0] = static_cast<UInt8>((size >> 24) & 0xff);
+	header[1] = static_cast<UInt8>((size >> 16) & 0xff);
+	header[2] = static_cast<UInt8>((size >>  8) & 0xff);
+	header[3] = static_cast<UInt8>( size        & 0xff);
+	write(header, kFrameHeaderSize);
+	write(reinterpret_cast<const UInt8*>(text), size);
+	++m_numLines;
+}
+
+UInt32
+IpcLogBuffer::take(String& frames, UInt32 maxSize)
+{
+	const UInt32 capacity = static_cast<UInt32>(m_ring.size());
+
+	UInt32 count = 0;
+	UInt32 taken = 0;
+	while (m_numLines > 0) {
+		UInt32 frameSize = kFrameHeaderSize + peekSize();
+		if (count > 0 && taken + frameSize > maxSize) {
+			break;
+		}
+
+		// copy the frame in at most two pieces
+		UInt32 first = std::min(frameSize, capacity - m_head);
+		frames.append(reinterpret_cast<const char*>(&m_ring[m_head]), first);
+		if (first < frameSize) {
+			frames.append(reinterpret_cast<const char*>(&m_ring[0]),
+							frameSize - first);
+		}
+
+		m_head  = (m_head + frameSize) % capacity;
+		m_size -= frameSize;
+		--m_numLines;
+		taken  += frameSize;
+		++count;
+	}
+	return count;
+}
+
+UInt32
+IpcLogBuffer::takeDropped()
+{
+	UInt32 dropped = m_dropped;
+	m_dropped      = 0;
+	return dropped;
+}
+
+UInt32
+IpcLogBuffer::getNumLines() const
+{
+	return m_numLines;
+}
+
+UInt32
+IpcLogBuffer::getSize() const
+{
+	return m_size;
+}
+
+bool
+IpcLogBuffer::unframe(const String& frames, std::vector<String>& lines)
+{
+	const UInt8* data = reinterpret_cast<const UInt8*>(frames.data());
+	size_t offset     = 0;
+	while (offset < frames.size()) {
+		if (frames.size() - offset < kFrameHeaderSize) {
+			return false;
+		}
+		UInt32 size = (static_cast<UInt32>(data[offset + 0]) << 24) |
+					  (static_cast<UInt32>(data[offset + 1]) << 16) |
+					  (static_cast<UInt32>(data[offset + 2]) <<  8) |
+					   static_cast<UInt32>(data[offset + 3]);
+		offset += kFrameHeaderSize;
+		if (frames.size() - offset < size) {
+			return false;
+		}
+		lines.push_back(frames.substr(offset, size));
+		offset += size;
+	}
+	return true;
+}
+
+UInt32
+IpcLogBuffer::peekSize() const
+{
+	UInt8 header[kFrameHeaderSize];
+	read(m_head, header, kFrameHeaderSize);
+	return (static_cast<UInt32>(header[0]) << 24) |
+		   (static_cast<UInt32>(header[1]) << 16) |
+		   (static_cast<UInt32>(header[2]) <<  8) |
+			static_cast<UInt32>(header[3]);
+}
+
+void
+IpcLogBuffer::read(UInt32 offset, UInt8* data, UInt32 size) const
+{
+	const UInt32 capacity = static_cast<UInt32>(m_ring.size());
+	for (UInt32 i = 0; i < size; ++i) {
+		data[i] = m_ring[(offset + i) % capacity];
+	}
+}
+
+void
+IpcLogBuffer::write(const UInt8* data, UInt32 size)
+{
+	const UInt32 capacity = static_cast<UInt32>(m_ring.size());
+	UInt32 tail  = (m_head + m_size) % capacity;
+	UInt32 first = std::min(size, capacity - tail);
+	std::copy(data, data + first, m_ring.begin() + tail);
+	std::copy(data + first, data + size, m_ring.begin());
+	m_size += size;
+}
+
+void
+IpcLogBuffer::dropOldest()
+{
+	assert(m_numLines > 0);
+
+	UInt32 frameSize = kFrameHeaderSize + peekSize();
+	m_head  = (m_head + frameSize) % static_cast<UInt32>(m_ring.size());
+	m_size -= frameSize;
+	--m_numLines;
+	++m_dropped;
+}
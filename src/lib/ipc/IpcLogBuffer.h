@@ -0,0 +1,97 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stdvector.h"
+
+//! Fixed size buffer of log lines
+/*!
+Holds log lines waiting to be sent to the GUI in a ring of bytes that
+is allocated once.  Each line is stored framed as it is sent: a 4 byte
+big endian length followed by the text, so a batch of lines is taken
+with a copy and no reformatting.  When the ring is full the oldest
+lines are dropped to make room and counted.
+
+This class is not thread safe.
+*/
+class IpcLogBuffer {
+public:
+	//! Create a buffer holding up to \p capacity bytes of framed lines
+	IpcLogBuffer(UInt32 capacity);
+
+	//! @name manipulators
+	//@{
+
+	//! Add a line
+	/*!
+	Drops the oldest lines if there isn't room.  A line too long to
+	fit in the buffer at all is truncated.
+	*/
+	void				append(const char* text, UInt32 size);
+
+	//! Take lines
+	/*!
+	Removes framed lines from the front of the buffer and appends them
+	to \p frames, stopping before \p maxSize bytes would be exceeded
+	(though at least one line is taken if there is one).  Returns the
+	number of lines taken.
+	*/
+	UInt32				take(String& frames, UInt32 maxSize);
+
+	//! Take the dropped line count
+	/*!
+	Returns the number of lines dropped since the last call.
+	*/
+	UInt32				takeDropped();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the number of lines in the buffer
+	UInt32				getNumLines() const;
+
+	//! Get the number of bytes of framed lines in the buffer
+	UInt32				getSize() const;
+
+	//! Split framed lines
+	/*!
+	Appends each line in \p frames, as returned by \c take(), to
+	\p lines.  Returns false if \p frames is malformed.
+	*/
+	static bool			unframe(const String& frames,
+							std::vector<String>& lines);
+
+	//@}
+
+private:
+	UInt32				peekSize() const;
+	void				read(UInt32 offset, UInt8* data, UInt32 size) const;
+	void				write(const UInt8* data, UInt32 size);
+	void				dropOldest();
+
+private:
+	std::vector<UInt8>	m_ring;
+	UInt32				m_head;
+	UInt32				m_size;
+	UInt32				m_numLines;
+	UInt32				m_dropped;
+};
@@ -30,17 +30,24 @@
 #include "base/TMethodEventJob.h"
 #include "base/TMethodJob.h"
 
-// limit number of log lines sent in one message.
-#define MAX_SEND 100
+// bytes of log lines held for the gui; about 10,000 typical lines.
+static const UInt32		kBufferSize = 1024 * 1024;
+
+// limit size of log lines sent in one message.
+static const UInt32		kMaxBatchSize = 64 * 1024;
+
+// collect log lines for this long before sending them.
+static const double		kBatchInterval = 0.05;
 
 IpcLogOutputter::IpcLogOutputter(IpcServer& ipcServer) :
 m_ipcServer(ipcServer),
+m_buffer(kBufferSize),
 m_bufferMutex(ARCH->newMutex()),
 m_sending(false),
 m_running(true),
 m_notifyCond(ARCH->newCondVar()),
 m_notifyMutex(ARCH->newMutex()),
-m_bufferWaiting(false)
+m_notified(false)
 {
 	m_bufferThread = new Thread(new TMethodJob<IpcLogOutputter>(
 		this, &IpcLogOutputter::bufferThread));
@@ -99,43 +106,56 @@ IpcLogOutputter::write(ELevel, const char* text, bool force)
 	}
 
 	appendBuffer(text);
-	notifyBuffer();
 	return true;
 }
 
 void
-IpcLogOutputter::appendBuffer(const String& text)
+IpcLogOutputter::appendBuffer(const char* text)
 {
-	ArchMutexLock lock(m_bufferMutex);
-	m_buffer.push(text);
+	bool notify;
+	{
+		ArchMutexLock lock(m_bufferMutex);
+		m_buffer.append(text, static_cast<UInt32>(strlen(text)));
+
+		// only the first line since the buffer thread last woke needs
+		// to wake it again.
+		notify     = !m_notified;
+		m_notified = true;
+	}
+
+	if (notify) {
+		ArchMutexLock lock(m_notifyMutex);
+		ARCH->broadcastCondVar(m_notifyCond);
+	}
 }
 
 void
 IpcLogOutputter::bufferThread(void*)
 {
-	ArchMutexLock lock(m_notifyMutex);
 	m_bufferThreadId = m_bufferThread->getID();
 
 	try {
+		double lastSendTime = 0.0;
 		while (m_running) {
+			waitForNotify();
 
-			if (m_ipcServer.hasClients(kIpcClientGui)) {
-
-				// buffer is sent in chunks, so keep sending until it's
-				// empty (or the program has stopped in the meantime).
-				while (m_running && !m_buffer.empty()) {
-					sendBuffer();
-				}
-			}
-
-			// program may be stopping while we were in the send loop.
+			// program may be stopping while we were waiting.
 			if (!m_running) {
 				break;
 			}
 
-			m_bufferWaiting = true;
-			ARCH->waitCondVar(m_notifyCond, m_notifyMutex, -1);
-			m_bufferWaiting = false;
+			// let lines collect so they go in as few messages as
+			// possible, and so a busy log wakes us once per interval
+			// rather than once per line.
+			double wait = lastSendTime + kBatchInterval - ARCH->time();
+			if (wait > 0.0) {
+				ARCH->sleep(wait);
+			}
+			lastSendTime = ARCH->time();
+
+			if (m_ipcServer.hasClients(kIpcClientGui)) {
+				sendBuffer();
+			}
 		}
 	}
 	catch (XArch& e) {
@@ -146,39 +166,56 @@ IpcLogOutputter::bufferThread(void*)
 }
 
 void
-IpcLogOutputter::notifyBuffer()
+IpcLogOutputter::waitForNotify()
 {
-	if (!m_bufferWaiting) {
-		return;
-	}
 	ArchMutexLock lock(m_notifyMutex);
-	ARCH->broadcastCondVar(m_notifyCond);
+	while (m_running) {
+		{
+			ArchMutexLock bufferLock(m_bufferMutex);
+			if (m_notified) {
+				m_notified = false;
+				return;
+			}
+		}
+
+		// writers broadcast with the notify mutex held, so a line
+		// written after the check above can't be missed here.
+		ARCH->waitCondVar(m_notifyCond, m_notifyMutex, -1);
+	}
 }
 
-String
-IpcLogOutputter::getChunk(size_t count)
+void
+IpcLogOutputter::notifyBuffer()
 {
-	ArchMutexLock lock(m_bufferMutex);
-
-	if (m_buffer.size() < count) {
-		count = m_buffer.size();
+	{
+		ArchMutexLock lock(m_bufferMutex);
+		m_notified = true;
 	}
 
-	String chunk;
-	for (size_t i = 0; i < count; i++) {
-		chunk.append(m_buffer.front());
-		chunk.append("\n");
-		m_buffer.pop();
-	}
-	return chunk;
+	ArchMutexLock lock(m_notifyMutex);
+	ARCH->broadcastCondVar(m_notifyCond);
 }
 
 void
 IpcLogOutputter::sendBuffer()
 {
-	IpcLogLineMessage message(getChunk(MAX_SEND));
+	// buffer is sent in batches, so keep sending until it's empty (or
+	// the program has stopped in the meantime).
+	while (m_running) {
+		String frames;
+		UInt32 dropped;
+		{
+			ArchMutexLock lock(m_bufferMutex);
+			if (m_buffer.take(frames, kMaxBatchSize) == 0) {
+				break;
+			}
+			dropped = m_buffer.takeDropped();
+		}
 
-	m_sending = true;
-	m_ipcServer.send(message, kIpcClientGui);
-	m_sending = false;
+		IpcLogBatchMessage message(frames, dropped);
+
+		m_sending = true;
+		m_ipcServer.send(message, kIpcClientGui);
+		m_sending = false;
+	}
 }
@@ -18,19 +18,22 @@
 
 #pragma once
 
+#include "ipc/IpcLogBuffer.h"
 #include "arch/Arch.h"
 #include "arch/IArchMultithread.h"
 #include "base/ILogOutputter.h"
 
-#include <queue>
-
 class IpcServer;
 class Event;
 class IpcClientProxy;
 
 //! Write log to GUI over IPC
 /*!
-This outputter writes output to the GUI via IPC.
+This outputter writes output to the GUI via IPC.  Lines are kept in a
+fixed size \c IpcLogBuffer, dropping the oldest if the GUI can't keep
+up (or isn't connected), and sent by a separate thread in batches.  The
+thread is woken at most once per batch interval however fast lines are
+written.
 */
 class IpcLogOutputter : public ILogOutputter {
 public:
@@ -51,22 +54,20 @@ public:
 
 private:
 	void				bufferThread(void*);
-	String				getChunk(size_t count);
+	void				waitForNotify();
 	void				sendBuffer();
-	void				appendBuffer(const String& text);
+	void				appendBuffer(const char* text);
 
 private:
-	typedef std::queue<String> Buffer;
-
 	IpcServer&			m_ipcServer;
-	Buffer				m_buffer;
+	IpcLogBuffer		m_buffer;
 	ArchMutex			m_bufferMutex;
 	bool				m_sending;
 	Thread*			m_bufferThread;
 	bool				m_running;
 	ArchCond			m_notifyCond;
 	ArchMutex			m_notifyMutex;
-	bool				m_bufferWaiting;
+	bool				m_notified;
 	IArchMultithread::ThreadID
 						m_bufferThreadId;
 };
@@ -57,6 +57,17 @@ IpcLogLineMessage::~IpcLogLineMessage()
 {
 }
 
+IpcLogBatchMessage::IpcLogBatchMessage(const String& frames, UInt32 dropped) :
+IpcMessage(kIpcLogBatch),
+m_frames(frames),
+m_dropped(dropped)
+{
+}
+
+IpcLogBatchMessage::~IpcLogBatchMessage()
+{
+}
+
 IpcCommandMessage::IpcCommandMessage(const String& command, bool elevate) :
 IpcMessage(kIpcCommand),
 m_command(command),
@@ -67,3 +78,13 @@ m_elevate(elevate)
 IpcCommandMessage::~IpcCommandMessage()
 {
 }
+
+IpcMetricsMessage::IpcMetricsMessage(const String& metrics) :
+IpcMessage(kIpcMetrics),
+m_metrics(metrics)
+{
+}
+
+IpcMetricsMessage::~IpcMetricsMessage()
+{
+}
@@ -68,6 +68,22 @@ private:
 	String				m_logLine;
 };
 
+class IpcLogBatchMessage : public IpcMessage {
+public:
+	IpcLogBatchMessage(const String& frames, UInt32 dropped);
+	virtual ~IpcLogBatchMessage();
+
+	//! Gets the log lines, framed as by \c IpcLogBuffer.
+	const String&		frames() const { return m_frames; }
+
+	//! Gets the number of lines dropped before this batch.
+	UInt32				dropped() const { return m_dropped; }
+
+private:
+	String				m_frames;
+	UInt32				m_dropped;
+};
+
 class IpcCommandMessage : public IpcMessage {
 public:
 	IpcCommandMessage(const String& command, bool elevate);
@@ -83,3 +99,15 @@ private:
 	String				m_command;
 	bool				m_elevate;
 };
+
+class IpcMetricsMessage : public IpcMessage {
+public:
+	IpcMetricsMessage(const String& metrics);
+	virtual ~IpcMetricsMessage();
+
+	//! Gets the metrics in the Prometheus text format.
+	String				metrics() const { return m_metrics; }
+
+private:
+	String				m_metrics;
+};
@@ -27,22 +27,38 @@
 #include "base/TMethodEventJob.h"
 #include "base/Event.h"
 #include "base/Log.h"
+#include "base/String.h"
+
+#if SYSAPI_UNIX
+#	include <sys/stat.h>
+#endif
 
 //
 // IpcServer
 //
 
 IpcServer::IpcServer(IEventQueue* events, SocketMultiplexer* socketMultiplexer) :
-	m_socket(events, socketMultiplexer),
-	m_address(NetworkAddress(IPC_HOST, IPC_PORT)),
+	m_address(getDefaultAddress()),
+	m_socket(events, socketMultiplexer, m_address.isUnix() ?
+				IArchNetwork::kUNIX : IArchNetwork::kINET),
 	m_events(events)
 {
 	init();
 }
 
 IpcServer::IpcServer(IEventQueue* events, SocketMultiplexer* socketMultiplexer, int port) :
-	m_socket(events, socketMultiplexer),
 	m_address(NetworkAddress(IPC_HOST, port)),
+	m_socket(events, socketMultiplexer),
+	m_events(events)
+{
+	init();
+}
+
+IpcServer::IpcServer(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+				const NetworkAddress& address) :
+	m_address(address),
+	m_socket(events, socketMultiplexer, m_address.isUnix() ?
+				IArchNetwork::kUNIX : IArchNetwork::kINET),
 	m_events(events)
 {
 	init();
@@ -77,6 +93,13 @@ IpcServer::~IpcServer()
 void
 IpcServer::listen()
 {
+#if SYSAPI_UNIX
+	// the socket goes in the profile directory, which may not exist yet
+	if (m_address.isUnix()) {
+		mkdir(ARCH->getProfileDirectory().c_str(), 0700);
+	}
+#endif
+
 	m_socket.bind(m_address);
 }
 
@@ -137,6 +160,18 @@ IpcServer::deleteClient(IpcClientProxy* proxy)
 	delete proxy;
 }
 
+NetworkAddress
+IpcServer::getDefaultAddress()
+{
+#if SYSAPI_UNIX
+	return NetworkAddress(synergy::string::sprintf("unix:%s/%s",
+							ARCH->getProfileDirectory().c_str(),
+							IPC_SOCKET_NAME), 0);
+#else
+	return NetworkAddress(IPC_HOST, IPC_PORT);
+#endif
+}
+
 bool
 IpcServer::hasClients(EIpcClientType clientType) const
 {
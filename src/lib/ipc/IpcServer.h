@@ -38,17 +38,23 @@ The IPC server listens on localhost. The IPC client runs on both the
 client/server process or the GUI. The IPC server runs on the daemon process.
 This allows the GUI to send config changes to the daemon and client/server,
 and allows the daemon and client/server to send log data to the GUI.
+
+By default the server listens on a unix domain socket in the profile
+directory, which only the same user can connect to, where the platform
+supports it.  Otherwise it listens on a localhost TCP port.
 */
 class IpcServer {
 public:
 	IpcServer(IEventQueue* events, SocketMultiplexer* socketMultiplexer);
 	IpcServer(IEventQueue* events, SocketMultiplexer* socketMultiplexer, int port);
+	IpcServer(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+							const NetworkAddress& address);
 	virtual ~IpcServer();
 
 	//! @name manipulators
 	//@{
 
-	//! Opens a TCP socket only allowing local connections.
+	//! Opens a socket only allowing local connections.
 	void				listen();
 
 	//! Send a message to all clients matching the filter type.
@@ -61,6 +67,10 @@ public:
 	//! Returns true when there are clients of the specified type connected.
 	bool				hasClients(EIpcClientType clientType) const;
 
+	//! Returns the address the daemon's IPC server listens on.
+	static NetworkAddress
+						getDefaultAddress();
+
 	//@}
 
 private:
@@ -73,8 +83,8 @@ private:
 private:
 	typedef std::list<IpcClientProxy*> ClientList;
 
-	TCPListenSocket		m_socket;
 	NetworkAddress		m_address;
+	TCPListenSocket		m_socket;
 	ClientList			m_clients;
 	ArchMutex			m_clientsMutex;
 	IEventQueue*		m_events;
@@ -61,6 +61,9 @@ IpcServerProxy::handleData(const Event&, void*)
 		if (memcmp(code, kIpcMsgLogLine, 4) == 0) {
 			m = parseLogLine();
 		}
+		else if (memcmp(code, kIpcMsgLogBatch, 4) == 0) {
+			m = parseLogBatch();
+		}
 		else if (memcmp(code, kIpcMsgShutdown, 4) == 0) {
 			m = new IpcShutdownMessage();
 		}
@@ -99,6 +102,13 @@ IpcServerProxy::send(const IpcMessage& message)
 		break;
 	}
 
+	case kIpcMetrics: {
+		const IpcMetricsMessage& mm = static_cast<const IpcMetricsMessage&>(message);
+		String metrics = mm.metrics();
+		ProtocolUtil::writef(&m_stream, kIpcMsgMetrics, &metrics);
+		break;
+	}
+
 	default:
 		LOG((CLOG_ERR "ipc message not supported: %d", message.type()));
 		break;
@@ -115,6 +125,17 @@ IpcServerProxy::parseLogLine()
 	return new IpcLogLineMessage(logLine);
 }
 
+IpcLogBatchMessage*
+IpcServerProxy::parseLogBatch()
+{
+	UInt32 dropped;
+	String frames;
+	ProtocolUtil::readf(&m_stream, kIpcMsgLogBatch + 4, &dropped, &frames);
+
+	// must be deleted by event handler.
+	return new IpcLogBatchMessage(frames, dropped);
+}
+
 void
 IpcServerProxy::disconnect()
 {
@@ -24,6 +24,7 @@
 namespace synergy { class IStream; }
 class IpcMessage;
 class IpcLogLineMessage;
+class IpcLogBatchMessage;
 class IEventQueue;
 
 class IpcServerProxy {
@@ -38,6 +39,7 @@ private:
 
 	void				handleData(const Event&, void*);
 	IpcLogLineMessage*	parseLogLine();
+	IpcLogBatchMessage*	parseLogBatch();
 	void				disconnect();
 
 private:
@@ -85,6 +85,24 @@ Thread::setPriority(int n)
 	ARCH->setPriorityOfThread(m_thread, n);
 }
 
+void
+Thread::setNice(int nice)
+{
+	ARCH->setNiceOfThread(m_thread, nice);
+}
+
+bool
+Thread::setRealtimePriority(int priority)
+{
+	return ARCH->setRealtimePriorityOfThread(m_thread, priority);
+}
+
+bool
+Thread::setAffinity(int cpu)
+{
+	return ARCH->setAffinityOfThread(m_thread, cpu);
+}
+
 void
 Thread::unblockPollSocket()
 {
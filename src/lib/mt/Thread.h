@@ -126,6 +126,30 @@ public:
 	*/
 	void				setPriority(int n);
 
+	//! Set niceness
+	/*!
+	Set the thread's niceness, from -20 (most favored) to 19 (least
+	favored) with 0 normal, without leaving the normal scheduling
+	class.  Boosting may not be permitted and is then limited to what
+	is.
+	*/
+	void				setNice(int nice);
+
+	//! Use real-time scheduling
+	/*!
+	Switch the thread to real-time scheduling at \c priority, where 1
+	is the lowest real-time priority.  Returns false if that's not
+	supported or not permitted, leaving the thread unchanged.
+	*/
+	bool				setRealtimePriority(int priority);
+
+	//! Bind thread to a CPU
+	/*!
+	Only run the thread on CPU number \c cpu.  Returns false if that's
+	not supported or there's no such CPU.
+	*/
+	bool				setAffinity(int cpu);
+
 	//! Force pollSocket() to return
 	/*!
 	Forces a currently blocked pollSocket() in the thread to return
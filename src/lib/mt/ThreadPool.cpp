@@ -0,0 +1,153 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "mt/ThreadPool.h"
+
+#include "mt/Lock.h"
+#include "mt/Thread.h"
+#include "mt/XThread.h"
+#include "base/IEventQueue.h"
+#include "base/EventTypes.h"
+#include "base/IJob.h"
+#include "base/Log.h"
+#include "base/TMethodJob.h"
+
+#include <exception>
+
+//
+// ThreadPool
+//
+
+ThreadPool*				ThreadPool::s_instance = NULL;
+
+ThreadPool::ThreadPool(IEventQueue* events, UInt32 maxThreads) :
+	m_events(events),
+	m_maxThreads(maxThreads),
+	m_queued(&m_mutex, false),
+	m_idle(0)
+{
+	assert(s_instance == NULL);
+	assert(m_maxThreads > 0);
+	s_instance = this;
+}
+
+ThreadPool::~ThreadPool()
+{
+	for (Threads::iterator i = m_threads.begin(); i != m_threads.end(); ++i) {
+		(*i)->cancel();
+	}
+	for (Threads::iterator i = m_threads.begin(); i != m_threads.end(); ++i) {
+		(*i)->wait();
+		delete *i;
+	}
+
+	// discard jobs that never got to run
+	for (Tasks::iterator i = m_tasks.begin(); i != m_tasks.end(); ++i) {
+		delete i->m_job;
+	}
+
+	s_instance = NULL;
+}
+
+void
+ThreadPool::run(IJob* job, void* target)
+{
+	assert(job != NULL);
+
+	Lock lock(&m_mutex);
+
+	Task task;
+	task.m_job    = job;
+	task.m_target = target;
+	m_tasks.push_back(task);
+
+	// only start a worker if the idle ones can't take every queued job
+	if (m_tasks.size() > m_idle && m_threads.size() < m_maxThreads) {
+		LOG((CLOG_DEBUG1 "starting worker thread %d", (int)m_threads.size()));
+		m_threads.push_back(new Thread(new TMethodJob<ThreadPool>(
+								this, &ThreadPool::workerThread)));
+	}
+	m_queued.signal();
+}
+
+UInt32
+ThreadPool::getNumThreads() const
+{
+	Lock lock(&m_mutex);
+	return (UInt32)m_threads.size();
+}
+
+UInt32
+ThreadPool::getNumQueued() const
+{
+	Lock lock(&m_mutex);
+	return (UInt32)m_tasks.size();
+}
+
+ThreadPool*
+ThreadPool::getInstance()
+{
+	assert(s_instance != NULL);
+	return s_instance;
+}
+
+void
+ThreadPool::workerThread(void*)
+{
+	for (;;) {
+		Task task;
+		{
+			Lock lock(&m_mutex);
+			++m_idle;
+			while (m_tasks.empty()) {
+				try {
+					m_queued.wait();
+				}
+				catch (...) {
+					--m_idle;
+					throw;
+				}
+			}
+			--m_idle;
+			task = m_tasks.front();
+			m_tasks.pop_front();
+		}
+
+		try {
+			task.m_job->run();
+		}
+		catch (XThread&) {
+			delete task.m_job;
+			throw;
+		}
+		catch (std::exception& e) {
+			LOG((CLOG_ERR "worker thread job failed: %s", e.what()));
+		}
+		catch (...) {
+			// keep the worker and still post completion so nobody
+			// waits forever for this task
+			LOG((CLOG_ERR "worker thread job failed: unknown exception"));
+		}
+		delete task.m_job;
+
+		if (task.m_target != NULL) {
+			m_events->addEvent(Event(m_events->forThreadPool().completed(),
+								task.m_target));
+		}
+	}
+}
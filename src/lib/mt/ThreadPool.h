@@ -0,0 +1,100 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "mt/CondVar.h"
+#include "mt/Mutex.h"
+#include "common/basic_types.h"
+#include "common/stddeque.h"
+#include "common/stdvector.h"
+
+class IEventQueue;
+class IJob;
+class Thread;
+
+//! Shared worker thread pool
+/*!
+Runs background jobs, such as sending a file or writing a dropped file
+to disk, on a small set of long lived worker threads instead of
+creating a thread for each one.  Workers are started as jobs need them,
+up to a fixed limit, and then reused; jobs queued while every worker
+is busy run in order as workers free up.
+
+A job can ask for a \c ThreadPoolEvents::completed() event to be posted
+to a target once it has run, so whoever queued it can pick up the
+result on the event loop's thread.
+
+There is one pool per process.  The app creates it before the server
+or client and destroys it after them.
+*/
+class ThreadPool {
+public:
+	enum { kDefaultThreads = 4 };
+
+	ThreadPool(IEventQueue* events, UInt32 maxThreads = kDefaultThreads);
+	~ThreadPool();
+
+	//! @name manipulators
+	//@{
+
+	//! Queue a job
+	/*!
+	Queues \c job to run on the next free worker and takes ownership of
+	it.  If \c target isn't NULL then a completed event is posted to it
+	once the job has run.
+	*/
+	void				run(IJob* job, void* target = NULL);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the number of worker threads started so far
+	UInt32				getNumThreads() const;
+
+	//! Get the number of jobs waiting for a worker
+	UInt32				getNumQueued() const;
+
+	//! Get the instance
+	static ThreadPool*	getInstance();
+
+	//@}
+
+private:
+	class Task {
+	public:
+		IJob*			m_job;
+		void*			m_target;
+	};
+	typedef std::deque<Task> Tasks;
+	typedef std::vector<Thread*> Threads;
+
+	void				workerThread(void*);
+
+private:
+	IEventQueue*		m_events;
+	UInt32				m_maxThreads;
+	Mutex				m_mutex;
+	CondVar<bool>		m_queued;
+	Tasks				m_tasks;
+	Threads				m_threads;
+	UInt32				m_idle;
+
+	static ThreadPool*	s_instance;
+};
@@ -48,6 +48,17 @@ public:
 	virtual ISocketMultiplexerJob*
 						run(bool readable, bool writable, bool error) = 0;
 
+	//! Change interest
+	/*!
+	Sets whether the job wants to be run when the socket becomes
+	readable and when it becomes writable.  \c run() may change the
+	interest of its own job and return the job itself;  the multiplexer
+	notices the change.  Other threads must use
+	\c SocketMultiplexer::updateJob() instead.  Callers must serialize
+	changes to the same job.
+	*/
+	virtual void		setInterest(bool readable, bool writable) = 0;
+
 	//@}
 	//! @name accessors
 	//@{
@@ -24,6 +24,9 @@
 
 #include <cstdlib>
 
+static const char		kUnixPrefix[] = "unix:";
+static const size_t		kUnixPrefixLength = sizeof(kUnixPrefix) - 1;
+
 //
 // NetworkAddress
 //
@@ -62,6 +65,12 @@ NetworkAddress::NetworkAddress(const String& hostname, int port) :
 	m_hostname(hostname),
 	m_port(port)
 {
+	// a unix domain address has no port
+	if (isUnix()) {
+		m_port = 0;
+		return;
+	}
+
 	// check for port suffix
 	String::size_type i = m_hostname.rfind(':');
 	if (i != String::npos && i + 1 < m_hostname.size()) {
@@ -147,6 +156,10 @@ NetworkAddress::resolve()
 		if (m_hostname.empty()) {
 			m_address = ARCH->newAnyAddr(IArchNetwork::kINET);
 		}
+		else if (isUnix()) {
+			m_address = ARCH->newUnixAddr(
+							m_hostname.substr(kUnixPrefixLength));
+		}
 		else {
 			m_address = ARCH->nameToAddr(m_hostname);
 		}
@@ -163,6 +176,9 @@ NetworkAddress::resolve()
 	catch (XArchNetworkName&) {
 		throw XSocketAddress(XSocketAddress::kUnknown, m_hostname, m_port);
 	}
+	catch (XArchNetworkSupport&) {
+		throw XSocketAddress(XSocketAddress::kUnsupported, m_hostname, m_port);
+	}
 
 	// set port in address
 	ARCH->setAddrPort(m_address, m_port);
@@ -186,6 +202,12 @@ NetworkAddress::isValid() const
 	return (m_address != NULL);
 }
 
+bool
+NetworkAddress::isUnix() const
+{
+	return (m_hostname.compare(0, kUnixPrefixLength, kUnixPrefix) == 0);
+}
+
 const ArchNetAddress&
 NetworkAddress::getAddress() const
 {
@@ -48,6 +48,9 @@ public:
 	port number (zero is not a valid port number) otherwise \c XSocketAddress
 	is thrown with an error of \c XSocketAddress::kBadPort.  The hostname
 	is not resolved by the c'tor;  use \c resolve to do that.
+
+	If \c hostname is of the form "unix:<path>" then the address is the
+	unix domain socket at path and \c port is ignored.
 	*/
 	NetworkAddress(const String& hostname, int port);
 
@@ -91,6 +94,12 @@ public:
 	*/
 	bool				isValid() const;
 
+	//! Check for a unix domain address
+	/*!
+	Returns true if this is the address of a unix domain socket.
+	*/
+	bool				isUnix() const;
+
 	//! Get address
 	/*!
 	Returns the address in the platform's native network address
@@ -107,7 +116,8 @@ public:
 
 	//! Get hostname
 	/*!
-	Returns the hostname passed to the c'tor sans any port suffix.
+	Returns the hostname passed to the c'tor sans any port suffix.  For
+	a unix domain address this includes the "unix:" prefix.
 	*/
 	String				getHostname() const;
 
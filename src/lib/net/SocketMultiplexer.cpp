@@ -27,6 +27,7 @@
 #include "arch/XArch.h"
 #include "base/Log.h"
 #include "base/TMethodJob.h"
+#include "base/Trace.h"
 #include "common/stdvector.h"
 
 //
@@ -41,7 +42,8 @@ SocketMultiplexer::SocketMultiplexer() :
 	m_jobListLock(new CondVar<bool>(m_mutex, false)),
 	m_jobListLockLocked(new CondVar<bool>(m_mutex, false)),
 	m_jobListLocker(NULL),
-	m_jobListLockLocker(NULL)
+	m_jobListLockLocker(NULL),
+	m_numSockets(0)
 {
 	// this pointer just has to be unique and not NULL.  it will
 	// never be dereferenced.  it's used to identify cursor nodes
@@ -55,6 +57,8 @@ SocketMultiplexer::SocketMultiplexer() :
 
 SocketMultiplexer::~SocketMultiplexer()
 {
+	setIOThreads(0);
+
 	m_thread->cancel();
 	m_thread->unblockPollSocket();
 	m_thread->wait();
@@ -95,11 +99,15 @@ SocketMultiplexer::addSocket(ISocket* socket, ISocketMultiplexerJob* job)
 		// the list continue to match the order of jobs in pfds in
 		// serviceThread().
 		JobCursor j = m_socketJobs.insert(m_socketJobs.end(), job);
-		m_update     = true;
 		m_socketJobMap.insert(std::make_pair(socket, j));
+
+		Lock lock(m_mutex);
+		m_update = true;
+		++m_numSockets;
 	}
 	else {
 		JobCursor j = i->second;
+		Lock lock(m_mutex);
 		if (*j != job) {
 			delete *j;
 			*j = job;
@@ -131,6 +139,7 @@ SocketMultiplexer::removeSocket(ISocket* socket)
 	SocketJobMap::iterator i = m_socketJobMap.find(socket);
 	if (i != m_socketJobMap.end()) {
 		if (*(i->second) != NULL) {
+			Lock lock(m_mutex);
 			delete *(i->second);
 			*(i->second) = NULL;
 			m_update     = true;
@@ -141,12 +150,115 @@ SocketMultiplexer::removeSocket(ISocket* socket)
 	unlockJobList();
 }
 
+void
+SocketMultiplexer::updateJob(ISocketMultiplexerJob* job,
+				bool readable, bool writable)
+{
+	assert(job != NULL);
+
+	{
+		Lock lock(m_mutex);
+		if (job->isReadable() == readable && job->isWritable() == writable) {
+			return;
+		}
+		job->setInterest(readable, writable);
+		m_update = true;
+	}
+
+	// break thread out of poll so it picks up the new interest.  this
+	// costs nothing if a wakeup is already pending.
+	m_thread->unblockPollSocket();
+}
+
+void
+SocketMultiplexer::setIOThreads(UInt32 count)
+{
+	while (m_ioMultiplexers.size() > count) {
+		delete m_ioMultiplexers.back();
+		m_ioMultiplexers.pop_back();
+	}
+	while (m_ioMultiplexers.size() < count) {
+		m_ioMultiplexers.push_back(new SocketMultiplexer);
+	}
+}
+
+SocketMultiplexer*
+SocketMultiplexer::getIOMultiplexer()
+{
+	SocketMultiplexer* best = this;
+	UInt32 bestSockets      = 0;
+	for (IOMultiplexers::const_iterator i = m_ioMultiplexers.begin();
+							i != m_ioMultiplexers.end(); ++i) {
+		UInt32 n = (*i)->getNumSockets();
+		if (best == this || n < bestSockets) {
+			best        = *i;
+			bestSockets = n;
+		}
+	}
+	return best;
+}
+
+Thread&
+SocketMultiplexer::getServiceThread() const
+{
+	return *m_thread;
+}
+
+UInt32
+SocketMultiplexer::getNumIOThreads() const
+{
+	return (UInt32)m_ioMultiplexers.size();
+}
+
+Thread&
+SocketMultiplexer::getIOThread(UInt32 index) const
+{
+	assert(index < m_ioMultiplexers.size());
+	return m_ioMultiplexers[index]->getServiceThread();
+}
+
+UInt32
+SocketMultiplexer::getNumSockets() const
+{
+	Lock lock(m_mutex);
+	return m_numSockets;
+}
+
+ISocketMultiplexerJob*
+SocketMultiplexer::getJob(ISocket* socket)
+{
+	assert(socket != NULL);
+
+	// prevent other threads from locking the job list
+	lockJobListLock();
+
+	// break thread out of poll
+	m_thread->unblockPollSocket();
+
+	// lock the job list
+	lockJobList();
+
+	ISocketMultiplexerJob* job = NULL;
+	SocketJobMap::iterator i = m_socketJobMap.find(socket);
+	if (i != m_socketJobMap.end()) {
+		Lock lock(m_mutex);
+		job = *(i->second);
+	}
+
+	// unlock the job list
+	unlockJobList();
+
+	return job;
+}
+
 void
 SocketMultiplexer::serviceThread(void*)
 {
 	std::vector<IArchNetwork::PollEntry> pfds;
 	IArchNetwork::PollEntry pfd;
 
+	TRACE->setThreadName("socket multiplexer");
+
 	// service the connections
 	for (;;) {
 		Thread::testCancel();
@@ -164,8 +276,13 @@ SocketMultiplexer::serviceThread(void*)
 		lockJobList();
 
 		// collect poll entries
-		if (m_update) {
+		bool update;
+		{
+			Lock lock(m_mutex);
+			update   = m_update;
 			m_update = false;
+		}
+		if (update) {
 			pfds.clear();
 			pfds.reserve(m_socketJobMap.size());
 
@@ -174,6 +291,7 @@ SocketMultiplexer::serviceThread(void*)
 			while (jobCursor != m_socketJobs.end()) {
 				ISocketMultiplexerJob* job = *jobCursor;
 				if (job != NULL) {
+					Lock lock(m_mutex);
 					pfd.m_socket = job->getSocket();
 					pfd.m_events = 0;
 					if (job->isReadable()) {
@@ -211,9 +329,13 @@ SocketMultiplexer::serviceThread(void*)
 			JobCursor cursor    = newCursor();
 			JobCursor jobCursor = nextCursor(cursor);
 			while (i < pfds.size() && jobCursor != m_socketJobs.end()) {
+				// get poll state.  skip jobs whose socket has nothing
+				// to report.
+				unsigned short revents = 0;
 				if (*jobCursor != NULL) {
-					// get poll state
-					unsigned short revents = pfds[i].m_revents;
+					revents = pfds[i++].m_revents;
+				}
+				if (revents != 0) {
 					bool read  = ((revents & IArchNetwork::kPOLLIN) != 0);
 					bool write = ((revents & IArchNetwork::kPOLLOUT) != 0);
 					bool error = ((revents & (IArchNetwork::kPOLLERR |
@@ -221,16 +343,28 @@ SocketMultiplexer::serviceThread(void*)
 
 					// run job
 					ISocketMultiplexerJob* job    = *jobCursor;
-					ISocketMultiplexerJob* newJob = job->run(read, write, error);
+					ISocketMultiplexerJob* newJob;
+					{
+						TraceSpan span("socket", "run job");
+						newJob = job->run(read, write, error);
+					}
 
-					// save job, if different
+					// save job, if different.  if it's the same job it
+					// may have changed its interest in place.
+					Lock lock(m_mutex);
 					if (newJob != job) {
-						Lock lock(m_mutex);
 						delete job;
 						*jobCursor = newJob;
 						m_update   = true;
 					}
-					++i;
+					else if (job->isReadable() !=
+								((pfds[i - 1].m_events &
+									IArchNetwork::kPOLLIN) != 0) ||
+							job->isWritable() !=
+								((pfds[i - 1].m_events &
+									IArchNetwork::kPOLLOUT) != 0)) {
+						m_update = true;
+					}
 				}
 
 				// next job
@@ -244,7 +378,10 @@ SocketMultiplexer::serviceThread(void*)
 							i != m_socketJobMap.end();) {
 			if (*(i->second) == NULL) {
 				m_socketJobMap.erase(i++);
+
+				Lock lock(m_mutex);
 				m_update = true;
+				--m_numSockets;
 			}
 			else {
 				++i;
@@ -19,8 +19,10 @@
 #pragma once
 
 #include "arch/IArchNetwork.h"
+#include "common/basic_types.h"
 #include "common/stdlist.h"
 #include "common/stdmap.h"
+#include "common/stdvector.h"
 
 template <class T>
 class CondVar;
@@ -32,6 +34,12 @@ class ISocketMultiplexerJob;
 //! Socket multiplexer
 /*!
 A socket multiplexer services multiple sockets simultaneously.
+
+A multiplexer can also own a set of I/O multiplexers, each with its own
+service thread, that connections accepted by its listen sockets are
+spread across.  Sending, receiving and encrypting then happen on the
+connection's own I/O thread, so a slow client only holds up the clients
+that share its thread.
 */
 class SocketMultiplexer {
 public:
@@ -45,10 +53,68 @@ public:
 
 	void				removeSocket(ISocket*);
 
+	//! Change a job's interest in place
+	/*!
+	Sets which events \p job, the current job for one of this
+	multiplexer's sockets, waits for.  Unlike replacing the job with
+	\c addSocket() this neither allocates nor waits for the service
+	thread to stop polling;  the service thread is woken and rebuilds
+	its poll set.  The caller must ensure \p job isn't replaced or
+	removed during the call.
+	*/
+	void				updateJob(ISocketMultiplexerJob* job,
+							bool readable, bool writable);
+
+	//! Set the number of I/O threads
+	/*!
+	Starts \p count I/O multiplexers for accepted connections.  Zero,
+	the default, services every socket on this multiplexer's thread.
+	This must be called before any connection is accepted.
+	*/
+	void				setIOThreads(UInt32 count);
+
+	//! Get a multiplexer for a new connection
+	/*!
+	Returns the I/O multiplexer currently servicing the fewest sockets,
+	or this multiplexer if there are no I/O threads.
+	*/
+	SocketMultiplexer*	getIOMultiplexer();
+
 	//@}
 	//! @name accessors
 	//@{
 
+	//! Get service thread
+	/*!
+	Returns the thread that polls the sockets and runs their jobs.
+	*/
+	Thread&				getServiceThread() const;
+
+	//! Get the number of I/O threads
+	UInt32				getNumIOThreads() const;
+
+	//! Get an I/O thread
+	/*!
+	Returns the service thread of I/O multiplexer \p index.
+	*/
+	Thread&				getIOThread(UInt32 index) const;
+
+	//! Get the number of sockets
+	/*!
+	Returns the number of sockets this multiplexer is servicing, not
+	counting those on its I/O multiplexers.
+	*/
+	UInt32				getNumSockets() const;
+
+	//! Get a socket's job
+	/*!
+	Returns the job servicing \p socket, or NULL if there isn't one.
+	Like \c addSocket() this wakes the service thread to get at the
+	job list, so it's meant for diagnostics and tests.
+	*/
+	ISocketMultiplexerJob*
+						getJob(ISocket* socket);
+
 	// maybe belongs on ISocketMultiplexer
 	static SocketMultiplexer*
 						getInstance();
@@ -61,11 +127,12 @@ private:
 	typedef std::list<ISocketMultiplexerJob*> SocketJobs;
 	typedef SocketJobs::iterator JobCursor;
 	typedef std::map<ISocket*, JobCursor> SocketJobMap;
+	typedef std::vector<SocketMultiplexer*> IOMultiplexers;
 
-	// service sockets.  the service thread will only access m_sockets
-	// and m_update while m_pollable and m_polling are true.  all other
-	// threads must only modify these when m_pollable and m_polling are
-	// false.  only the service thread sets m_polling.
+	// service sockets.  the service thread only accesses the job list
+	// while it holds the job list lock.  m_update and the interest of
+	// jobs in the list are guarded by m_mutex so they can change while
+	// the service thread is polling.
 	void				serviceThread(void*);
 
 	// create, iterate, and destroy a cursor.  a cursor is used to
@@ -108,4 +175,7 @@ private:
 	SocketJobMap		m_socketJobMap;
 	ISocketMultiplexerJob*
 						m_cursorMark;
+	UInt32				m_numSockets;
+
+	IOMultiplexers		m_ioMultiplexers;
 };
@@ -28,19 +28,30 @@
 #include "mt/Mutex.h"
 #include "arch/Arch.h"
 #include "arch/XArch.h"
+#include "base/Log.h"
 #include "base/IEventQueue.h"
 
+#if SYSAPI_UNIX
+#	include <sys/types.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
 //
 // TCPListenSocket
 //
 
-TCPListenSocket::TCPListenSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer) :
+TCPListenSocket::TCPListenSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+				IArchNetwork::EAddressFamily family) :
 	m_events(events),
-	m_socketMultiplexer(socketMultiplexer)
+	m_socketMultiplexer(socketMultiplexer),
+	m_family(family),
+	m_unixDevice(0),
+	m_unixInode(0)
 {
 	m_mutex = new Mutex;
 	try {
-		m_socket = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kSTREAM);
+		m_socket = ARCH->newSocket(family, IArchNetwork::kSTREAM);
 	}
 	catch (XArchNetwork& e) {
 		throw XSocketCreate(e.what());
@@ -53,6 +64,7 @@ TCPListenSocket::~TCPListenSocket()
 		if (m_socket != NULL) {
 			m_socketMultiplexer->removeSocket(this);
 			ARCH->closeSocket(m_socket);
+			removeUnixSocket();
 		}
 	}
 	catch (...) {
@@ -66,8 +78,23 @@ TCPListenSocket::bind(const NetworkAddress& addr)
 {
 	try {
 		Lock lock(m_mutex);
-		ARCH->setReuseAddrOnSocket(m_socket, true);
+		if (m_family == IArchNetwork::kUNIX) {
+			removeStaleUnixSocket(addr);
+		}
+		else {
+			ARCH->setReuseAddrOnSocket(m_socket, true);
+		}
 		ARCH->bindSocket(m_socket, addr.getAddress());
+		if (m_family == IArchNetwork::kUNIX) {
+			m_unixPath = ARCH->addrToString(addr.getAddress());
+#if SYSAPI_UNIX
+			struct stat info;
+			if (lstat(m_unixPath.c_str(), &info) == 0) {
+				m_unixDevice = static_cast<UInt64>(info.st_dev);
+				m_unixInode  = static_cast<UInt64>(info.st_ino);
+			}
+#endif
+		}
 		ARCH->listenOnSocket(m_socket);
 		m_socketMultiplexer->addSocket(this,
 							new TSocketMultiplexerMethodJob<TCPListenSocket>(
@@ -93,6 +120,7 @@ TCPListenSocket::close()
 		m_socketMultiplexer->removeSocket(this);
 		ARCH->closeSocket(m_socket);
 		m_socket = NULL;
+		removeUnixSocket();
 	}
 	catch (XArchNetwork& e) {
 		throw XSocketIOClose(e.what());
@@ -110,7 +138,21 @@ TCPListenSocket::accept()
 {
 	IDataSocket* socket = NULL;
 	try {
-		socket = new TCPSocket(m_events, m_socketMultiplexer, ARCH->acceptSocket(m_socket, NULL));
+		ArchSocket archSocket = ARCH->acceptSocket(m_socket, NULL);
+		if (archSocket != NULL && m_family == IArchNetwork::kUNIX &&
+				!ARCH->isPeerTrustedOnSocket(archSocket)) {
+			LOG((CLOG_WARN "rejected connection on %s from another user",
+				m_unixPath.c_str()));
+			ARCH->closeSocket(archSocket);
+			m_socketMultiplexer->addSocket(this,
+							new TSocketMultiplexerMethodJob<TCPListenSocket>(
+								this, &TCPListenSocket::serviceListening,
+								m_socket, true, false));
+			return NULL;
+		}
+
+		socket = new TCPSocket(m_events,
+							m_socketMultiplexer->getIOMultiplexer(), archSocket);
 		if (socket != NULL) {
 			m_socketMultiplexer->addSocket(this,
 							new TSocketMultiplexerMethodJob<TCPListenSocket>(
@@ -148,3 +190,58 @@ TCPListenSocket::serviceListening(ISocketMultiplexerJob* job,
 	}
 	return job;
 }
+
+void
+TCPListenSocket::removeStaleUnixSocket(const NetworkAddress& addr)
+{
+#if SYSAPI_UNIX
+	// a server that exited without closing leaves its socket file
+	// behind, which would make bind() fail.  only remove it if it is a
+	// socket and connecting to it is refused, which means nothing is
+	// listening.  anything else at the path is left for bind() to fail
+	// on, or reported here.
+	String path = ARCH->addrToString(addr.getAddress());
+	struct stat info;
+	if (lstat(path.c_str(), &info) == -1) {
+		return;
+	}
+	if (!S_ISSOCK(info.st_mode)) {
+		throw XSocketBind(path + " exists and is not a socket");
+	}
+
+	ArchSocket probe = ARCH->newSocket(IArchNetwork::kUNIX,
+							IArchNetwork::kSTREAM);
+	try {
+		ARCH->connectSocket(probe, addr.getAddress());
+		ARCH->closeSocket(probe);
+	}
+	catch (XArchNetworkConnectionRefused&) {
+		ARCH->closeSocket(probe);
+		LOG((CLOG_DEBUG "removing stale socket %s", path.c_str()));
+		unlink(path.c_str());
+	}
+	catch (XArchNetwork& e) {
+		ARCH->closeSocket(probe);
+		throw XSocketBind(e.what());
+	}
+#endif
+}
+
+void
+TCPListenSocket::removeUnixSocket()
+{
+	if (m_unixPath.empty()) {
+		return;
+	}
+
+#if SYSAPI_UNIX
+	// another server may have replaced our socket file since we bound
+	struct stat info;
+	if (lstat(m_unixPath.c_str(), &info) == 0 &&
+			static_cast<UInt64>(info.st_dev) == m_unixDevice &&
+			static_cast<UInt64>(info.st_ino) == m_unixInode) {
+		unlink(m_unixPath.c_str());
+	}
+#endif
+	m_unixPath.clear();
+}
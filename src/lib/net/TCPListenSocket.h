@@ -20,6 +20,7 @@
 
 #include "net/IListenSocket.h"
 #include "arch/IArchNetwork.h"
+#include "base/String.h"
 
 class Mutex;
 class ISocketMultiplexerJob;
@@ -28,11 +29,16 @@ class SocketMultiplexer;
 
 //! TCP listen socket
 /*!
-A listen socket using TCP.
+A listen socket using TCP, or a unix domain stream socket if created
+with the \c IArchNetwork::kUNIX family.  A unix domain socket only
+accepts connections from processes running as the same user (or the
+superuser), and replaces the socket file of a server that has exited.
 */
 class TCPListenSocket : public IListenSocket {
 public:
-	TCPListenSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer);
+	TCPListenSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+							IArchNetwork::EAddressFamily family =
+								IArchNetwork::kINET);
 	virtual ~TCPListenSocket();
 
 	// ISocket overrides
@@ -50,9 +56,23 @@ public:
 						serviceListening(ISocketMultiplexerJob*,
 							bool, bool, bool);
 
+private:
+	void				removeStaleUnixSocket(const NetworkAddress&);
+	void				removeUnixSocket();
+
 protected:
 	ArchSocket			m_socket;
 	Mutex*				m_mutex;
 	IEventQueue*		m_events;
 	SocketMultiplexer*	m_socketMultiplexer;
+
+private:
+	IArchNetwork::EAddressFamily
+						m_family;
+	String				m_unixPath;
+
+	// identity of the socket file we created, so we only remove it if
+	// it hasn't since been replaced
+	UInt64				m_unixDevice;
+	UInt64				m_unixInode;
 };
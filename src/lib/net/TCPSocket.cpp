@@ -28,6 +28,8 @@
 #include "base/Log.h"
 #include "base/IEventQueue.h"
 #include "base/IEventJob.h"
+#include "base/Metrics.h"
+#include "base/Trace.h"
 
 #include <cstring>
 #include <cstdlib>
@@ -37,7 +39,8 @@
 // TCPSocket
 //
 
-TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer) :
+TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+				IArchNetwork::EAddressFamily family) :
 	IDataSocket(events),
 	m_mutex(),
 	m_flushed(&m_mutex, true),
@@ -45,7 +48,7 @@ TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer)
 	m_socketMultiplexer(socketMultiplexer)
 {
 	try {
-		m_socket = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kSTREAM);
+		m_socket = ARCH->newSocket(family, IArchNetwork::kSTREAM);
 	}
 	catch (XArchNetwork& e) {
 		throw XSocketCreate(e.what());
@@ -70,6 +73,25 @@ TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
 	setJob(newJob());
 }
 
+TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+				ArchSocket socket, bool service) :
+	IDataSocket(events),
+	m_mutex(),
+	m_socket(socket),
+	m_flushed(&m_mutex, true),
+	m_events(events),
+	m_socketMultiplexer(socketMultiplexer)
+{
+	assert(m_socket != NULL);
+
+	// socket starts in connected state
+	init();
+	onConnected();
+	if (service) {
+		setJob(newJob());
+	}
+}
+
 TCPSocket::~TCPSocket()
 {
 	try {
@@ -154,7 +176,7 @@ TCPSocket::read(void* buffer, UInt32 n)
 void
 TCPSocket::write(const void* buffer, UInt32 n)
 {
-	bool wasEmpty;
+	ISocketMultiplexerJob* job;
 	{
 		Lock lock(&m_mutex);
 
@@ -169,18 +191,58 @@ TCPSocket::write(const void* buffer, UInt32 n)
 			return;
 		}
 
-		// copy data to the output buffer
-		wasEmpty = (m_outputBuffer.getSize() == 0);
-		m_outputBuffer.write(buffer, n);
+		// if nothing is queued then try sending on this thread right
+		// away instead of waking the multiplexer thread to do it, and
+		// only queue what the socket won't take.  secure sockets always
+		// go through the multiplexer since an ssl write that must be
+		// retried has to be retried with the same buffer.
+		bool wasEmpty = (m_outputBuffer.getSize() == 0);
+		if (wasEmpty && m_connected && !isSecure()) {
+			UInt32 sent = 0;
+			try {
+				sent = (UInt32)ARCH->writeSocket(m_socket, buffer, n);
+			}
+			catch (XArchNetwork&) {
+				// queue the data.  the multiplexer will get the same
+				// error when it tries to send and handle it.
+			}
+			if (sent > 0) {
+				m_metricBytesOut->increment(sent);
+			}
+			buffer = static_cast<const UInt8*>(buffer) + sent;
+			n     -= sent;
+
+			// have the multiplexer send outputFlushed.  sending it here
+			// would send one per write() where queueing sends just one
+			// when the buffer drains.
+			if (n == 0) {
+				if (m_flushPending) {
+					return;
+				}
+				m_flushPending = true;
+			}
+		}
 
-		// there's data to write
-		m_flushed = false;
-	}
+		if (n > 0) {
+			// copy data to the output buffer
+			m_outputBuffer.write(buffer, n);
+			m_metricOutputQueued->add(n);
 
-	// make sure we're waiting to write
-	if (wasEmpty) {
-		setJob(newJob());
+			// there's data to write
+			m_flushed = false;
+		}
+
+		// make sure we're waiting to write
+		if (!wasEmpty) {
+			return;
+		}
+		if (m_job != NULL) {
+			m_socketMultiplexer->updateJob(m_job, m_readable, true);
+			return;
+		}
+		job = newJob();
 	}
+	setJob(job);
 }
 
 void
@@ -196,6 +258,7 @@ void
 TCPSocket::shutdownInput()
 {
 	bool useNewJob = false;
+	ISocketMultiplexerJob* job = NULL;
 	{
 		Lock lock(&m_mutex);
 
@@ -211,11 +274,12 @@ TCPSocket::shutdownInput()
 		if (m_readable) {
 			sendEvent(m_events->forIStream().inputShutdown());
 			onInputShutdown();
+			job       = newJob();
 			useNewJob = true;
 		}
 	}
 	if (useNewJob) {
-		setJob(newJob());
+		setJob(job);
 	}
 }
 
@@ -223,6 +287,7 @@ void
 TCPSocket::shutdownOutput()
 {
 	bool useNewJob = false;
+	ISocketMultiplexerJob* job = NULL;
 	{
 		Lock lock(&m_mutex);
 
@@ -238,11 +303,12 @@ TCPSocket::shutdownOutput()
 		if (m_writable) {
 			sendEvent(m_events->forIStream().outputShutdown());
 			onOutputShutdown();
+			job       = newJob();
 			useNewJob = true;
 		}
 	}
 	if (useNewJob) {
-		setJob(newJob());
+		setJob(job);
 	}
 }
 
@@ -263,6 +329,7 @@ TCPSocket::getSize() const
 void
 TCPSocket::connect(const NetworkAddress& addr)
 {
+	ISocketMultiplexerJob* job;
 	{
 		Lock lock(&m_mutex);
 
@@ -285,17 +352,27 @@ TCPSocket::connect(const NetworkAddress& addr)
 		catch (XArchNetwork& e) {
 			throw XSocketConnect(e.what());
 		}
+		job = newJob();
 	}
-	setJob(newJob());
+	setJob(job);
 }
 
 void
 TCPSocket::init()
 {
 	// default state
-	m_connected = false;
-	m_readable  = false;
-	m_writable  = false;
+	m_connected    = false;
+	m_readable     = false;
+	m_writable     = false;
+	m_flushPending = false;
+	m_job          = NULL;
+
+	m_metricBytesIn      = METRICS->counter("synergy_socket_received_bytes_total",
+							"Bytes received on TCP sockets");
+	m_metricBytesOut     = METRICS->counter("synergy_socket_sent_bytes_total",
+							"Bytes sent on TCP sockets");
+	m_metricOutputQueued = METRICS->gauge("synergy_socket_output_queue_bytes",
+							"Bytes queued for sending on TCP sockets");
 
 	try {
 		// turn off Nagle algorithm.  we send lots of very short messages
@@ -318,6 +395,15 @@ TCPSocket::init()
 void
 TCPSocket::setJob(ISocketMultiplexerJob* job)
 {
+	// forget the current job unless it's the one being set, before the
+	// multiplexer deletes it
+	{
+		Lock lock(&m_mutex);
+		if (job != m_job) {
+			m_job = NULL;
+		}
+	}
+
 	// multiplexer will delete the old job
 	if (job == NULL) {
 		m_socketMultiplexer->removeSocket(this);
@@ -332,6 +418,7 @@ TCPSocket::newJob()
 {
 	// note -- must have m_mutex locked on entry
 
+	m_job = NULL;
 	if (m_socket == NULL) {
 		return NULL;
 	}
@@ -345,13 +432,15 @@ TCPSocket::newJob()
 								m_socket, m_readable, m_writable);
 	}
 	else {
-		if (!(m_readable || (m_writable && (m_outputBuffer.getSize() > 0)))) {
+		bool write = (m_writable &&
+						(m_outputBuffer.getSize() > 0 || m_flushPending));
+		if (!(m_readable || write)) {
 			return NULL;
 		}
-		return new TSocketMultiplexerMethodJob<TCPSocket>(
+		m_job = new TSocketMultiplexerMethodJob<TCPSocket>(
 								this, &TCPSocket::serviceConnected,
-								m_socket, m_readable,
-								m_writable && (m_outputBuffer.getSize() > 0));
+								m_socket, m_readable, write);
+		return m_job;
 	}
 }
 
@@ -387,8 +476,10 @@ TCPSocket::onInputShutdown()
 void
 TCPSocket::onOutputShutdown()
 {
+	m_metricOutputQueued->add(-static_cast<SInt64>(m_outputBuffer.getSize()));
 	m_outputBuffer.pop(m_outputBuffer.getSize());
-	m_writable = false;
+	m_writable     = false;
+	m_flushPending = false;
 
 	// we're now flushed
 	m_flushed = true;
@@ -460,9 +551,19 @@ TCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 		return newJob();
 	}
 
-	bool needNewJob = false;
+	bool needNewJob  = false;
+	bool stopWriting = false;
 
-	if (write) {
+	if (write && m_outputBuffer.getSize() == 0) {
+		// nothing queued.  report what write() sent directly.
+		if (m_flushPending) {
+			m_flushPending = false;
+			sendEvent(m_events->forIStream().outputFlushed());
+		}
+		stopWriting = true;
+	}
+	else if (write) {
+		TraceSpan span("socket", "write");
 		try {
 			// write data
 			UInt32 n = m_outputBuffer.getSize();
@@ -482,11 +583,14 @@ TCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 			// discard written data
 			if (n > 0) {
 				m_outputBuffer.pop(n);
+				m_metricBytesOut->increment(n);
+				m_metricOutputQueued->add(-static_cast<SInt64>(n));
 				if (m_outputBuffer.getSize() == 0) {
+					m_flushPending = false;
 					sendEvent(m_events->forIStream().outputFlushed());
 					m_flushed = true;
 					m_flushed.broadcast();
-					needNewJob = true;
+					stopWriting = true;
 				}
 			}
 		}
@@ -518,13 +622,15 @@ TCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 	}
 
 	if (read && m_readable) {
+		TraceSpan span("socket", "read");
 		try {
 			UInt8 buffer[4096];
 			size_t n = 0;
+			bool retry = false;
 
 			if (isSecure()) {
 				if (isSecureReady()) {
-					n = secureRead(buffer, sizeof(buffer));
+					n = secureRead(buffer, sizeof(buffer), retry);
 				}
 				else {
 					return job;
@@ -540,9 +646,10 @@ TCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 				// slurp up as much as possible
 				do {
 					m_inputBuffer.write(buffer, (UInt32)n);
+					m_metricBytesIn->increment(n);
 
 					if (isSecure() && isSecureReady()) {
-						n = secureRead(buffer, sizeof(buffer));
+						n = secureRead(buffer, sizeof(buffer), retry);
 					}
 					else {
 						n = ARCH->readSocket(m_socket, buffer, sizeof(buffer));
@@ -555,7 +662,7 @@ TCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 					sendEvent(m_events->forIStream().inputReady());
 				}
 			}
-			else {
+			else if (!retry) {
 				// remote write end of stream hungup.  our input side
 				// has therefore shutdown but don't flush our buffer
 				// since there's still data to be read.
@@ -580,5 +687,17 @@ TCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 		}
 	}
 
-	return needNewJob ? newJob() : job;
+	if (needNewJob) {
+		return newJob();
+	}
+
+	// stop waiting for writability.  the job is updated in place while
+	// there's still something to wait for.
+	if (stopWriting) {
+		if (job != m_job || !m_readable) {
+			return newJob();
+		}
+		job->setInterest(true, false);
+	}
+	return job;
 }
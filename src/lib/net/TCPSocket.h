@@ -29,14 +29,19 @@ class Thread;
 class ISocketMultiplexerJob;
 class IEventQueue;
 class SocketMultiplexer;
+class MetricCounter;
+class MetricGauge;
 
 //! TCP data socket
 /*!
-A data socket using TCP.
+A data socket using TCP, or a unix domain stream socket if created with
+the \c IArchNetwork::kUNIX family.
 */
 class TCPSocket : public IDataSocket {
 public:
-	TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer);
+	TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+							IArchNetwork::EAddressFamily family =
+								IArchNetwork::kINET);
 	TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer, ArchSocket socket);
 	virtual ~TCPSocket();
 
@@ -61,11 +66,29 @@ public:
 	virtual void		secureAccept() {}
 
 protected:
+	//! Wrap an accepted socket
+	/*!
+	Like the public constructor but the socket isn't serviced until the
+	subclass calls \c setJob().  A subclass that must see its own data
+	first (such as a secure handshake) uses this so the multiplexer
+	can't read from the socket while only the base is constructed.
+	*/
+	TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+							ArchSocket socket, bool service);
+
 	ArchSocket			getSocket() { return m_socket; }
 	IEventQueue*		getEvents() { return m_events; }
 	virtual bool		isSecureReady() { return false; }
 	virtual bool		isSecure() { return false; }
-	virtual UInt32		secureRead(void* buffer, UInt32) { return 0; }
+	//! Read decrypted data
+	/*!
+	Returns the number of bytes read.  Zero means the stream ended
+	unless \c retry is set, which means no application data is ready
+	yet (e.g. only a handshake message arrived) and the read should be
+	tried again when the socket is next readable.
+	*/
+	virtual UInt32		secureRead(void* buffer, UInt32, bool& retry)
+							{ retry = false; return 0; }
 	virtual UInt32		secureWrite(const void*, UInt32) { return 0; }
 
 	void				setJob(ISocketMultiplexerJob*);
@@ -103,6 +126,20 @@ private:
 	bool				m_connected;
 	bool				m_readable;
 	bool				m_writable;
+
+	// true if write() sent data directly that hasn't been reported with
+	// outputFlushed yet.  the multiplexer reports it, once for however
+	// many writes were sent before it got to run.
+	bool				m_flushPending;
 	IEventQueue*		m_events;
 	SocketMultiplexer*	m_socketMultiplexer;
+
+	// the multiplexer's current job for a connected socket, or NULL if
+	// it's some other job or unknown.  while set, changing interest
+	// updates this job in place instead of replacing it.
+	ISocketMultiplexerJob*
+						m_job;
+	MetricCounter*		m_metricBytesIn;
+	MetricCounter*		m_metricBytesOut;
+	MetricGauge*		m_metricOutputQueued;
 };
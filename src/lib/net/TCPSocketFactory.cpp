@@ -82,3 +82,9 @@ TCPSocketFactory::createListen(bool secure) const
 
 	return socket;
 }
+
+bool
+TCPSocketFactory::isSecureAvailable()
+{
+	return ARCH->plugin().exists(s_networkSecurity);
+}
@@ -35,6 +35,13 @@ public:
 	virtual IListenSocket*
 						createListen(bool secure) const;
 
+	//! Test for secure sockets
+	/*!
+	Returns true iff the network security plugin is loaded, so that
+	create() and createListen() can make secure sockets.
+	*/
+	static bool			isSecureAvailable();
+
 private:
 	IEventQueue*		m_events;
 	SocketMultiplexer*	m_socketMultiplexer;
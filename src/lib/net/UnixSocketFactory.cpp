@@ -0,0 +1,57 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "net/UnixSocketFactory.h"
+
+#include "net/TCPSocket.h"
+#include "net/TCPListenSocket.h"
+#include "net/XSocket.h"
+
+//
+// UnixSocketFactory
+//
+
+UnixSocketFactory::UnixSocketFactory(IEventQueue* events, SocketMultiplexer* socketMultiplexer) :
+	m_events(events),
+	m_socketMultiplexer(socketMultiplexer)
+{
+	// do nothing
+}
+
+UnixSocketFactory::~UnixSocketFactory()
+{
+	// do nothing
+}
+
+IDataSocket*
+UnixSocketFactory::create(bool secure) const
+{
+	if (secure) {
+		throw XSocketCreate("encryption is not supported on unix sockets");
+	}
+	return new TCPSocket(m_events, m_socketMultiplexer, IArchNetwork::kUNIX);
+}
+
+IListenSocket*
+UnixSocketFactory::createListen(bool secure) const
+{
+	if (secure) {
+		throw XSocketCreate("encryption is not supported on unix sockets");
+	}
+	return new TCPListenSocket(m_events, m_socketMultiplexer, IArchNetwork::kUNIX);
+}
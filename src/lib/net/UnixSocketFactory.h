@@ -0,0 +1,47 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "net/ISocketFactory.h"
+
+class IEventQueue;
+class SocketMultiplexer;
+
+//! Socket factory for unix domain sockets
+/*!
+Creates stream sockets for addresses of the form "unix:<path>", for a
+client and server on the same host.  Secure sockets are not supported;
+the socket file's permissions and the peer check on accept protect a
+local link instead.
+*/
+class UnixSocketFactory : public ISocketFactory {
+public:
+	UnixSocketFactory(IEventQueue* events, SocketMultiplexer* socketMultiplexer);
+	virtual ~UnixSocketFactory();
+
+	// ISocketFactory overrides
+	virtual IDataSocket*
+						create(bool secure) const;
+	virtual IListenSocket*
+						createListen(bool secure) const;
+
+private:
+	IEventQueue*		m_events;
+	SocketMultiplexer*	m_socketMultiplexer;
+};
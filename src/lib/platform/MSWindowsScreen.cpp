@@ -33,6 +33,7 @@
 #include "synergy/ClientApp.h"
 #include "mt/Lock.h"
 #include "mt/Thread.h"
+#include "mt/ThreadPool.h"
 #include "arch/win32/ArchMiscWindows.h"
 #include "arch/Arch.h"
 #include "base/FunctionJob.h"
@@ -369,7 +370,7 @@ MSWindowsScreen::leave()
 	forceShowCursor();
 
 	if (isDraggingStarted() && !m_isPrimary) {
-		m_sendDragThread = new Thread(
+		ThreadPool::getInstance()->run(
 			new TMethodJob<MSWindowsScreen>(
 				this,
 				&MSWindowsScreen::sendDragThread));
@@ -916,7 +917,10 @@ MSWindowsScreen::destroyWindow(HWND hwnd) const
 void
 MSWindowsScreen::sendEvent(Event::Type type, void* data)
 {
-	m_events->addEvent(Event(type, getEventTarget(), data));
+	// stamp input with when it was captured to measure its latency
+	Event event(type, getEventTarget(), data);
+	event.setTime(ARCH->time());
+	m_events->addEvent(event);
 }
 
 void
@@ -1284,8 +1288,7 @@ MSWindowsScreen::onHotKey(WPARAM wParam, LPARAM lParam)
 	}
 
 	// generate event
-	m_events->addEvent(Event(type, getEventTarget(),
-							HotKeyInfo::alloc(i->second)));
+	sendEvent(type, HotKeyInfo::alloc(i->second));
 
 	return true;
 }
@@ -338,7 +338,5 @@ private:
 	HWND				m_dropWindow;
 	const int			m_dropWindowSize;
 
-	Thread*			m_sendDragThread;
-
 	PrimaryKeyDownList	m_primaryKeyDownList;
 };
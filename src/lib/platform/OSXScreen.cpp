@@ -33,6 +33,7 @@
 #include "mt/Lock.h"
 #include "mt/Mutex.h"
 #include "mt/Thread.h"
+#include "mt/ThreadPool.h"
 #include "arch/XArch.h"
 #include "base/Log.h"
 #include "base/IEventQueue.h"
@@ -110,8 +111,7 @@ OSXScreen::OSXScreen(IEventQueue* events, bool isPrimary, bool autoShowHideCurso
 	m_lastSingleClickXCursor(0),
 	m_lastSingleClickYCursor(0),
 	m_autoShowHideCursor(autoShowHideCursor),
-	m_events(events),
-	m_getDropTargetThread(NULL)
+	m_events(events)
 {
 	try {
 		m_displayID   = CGMainDisplayID();
@@ -602,7 +602,7 @@ OSXScreen::fakeMouseButton(ButtonID id, bool press)
     
 	if (!press && (id == kButtonLeft)) {
 		if (m_fakeDraggingStarted) {
-			m_getDropTargetThread = new Thread(new TMethodJob<OSXScreen>(
+			ThreadPool::getInstance()->run(new TMethodJob<OSXScreen>(
 				this, &OSXScreen::getDropTargetThread));
 		}
 		
@@ -1002,7 +1002,10 @@ OSXScreen::isPrimary() const
 void
 OSXScreen::sendEvent(Event::Type type, void* data) const
 {
-	m_events->addEvent(Event(type, getEventTarget(), data));
+	// stamp input with when it was captured to measure its latency
+	Event event(type, getEventTarget(), data);
+	event.setTime(ARCH->time());
+	m_events->addEvent(event);
 }
 
 void
@@ -1197,8 +1200,8 @@ OSXScreen::onMouseButton(bool pressed, UInt16 macButton)
 		}
 		else {
 			if (m_fakeDraggingStarted) {
-				m_getDropTargetThread = new Thread(new TMethodJob<OSXScreen>(
-																			   this, &OSXScreen::getDropTargetThread));
+				ThreadPool::getInstance()->run(new TMethodJob<OSXScreen>(
+					this, &OSXScreen::getDropTargetThread));
 			}
 			
 			m_draggingStarted = false;
@@ -1304,9 +1307,8 @@ OSXScreen::onKey(CGEventRef event)
 			if (m_modifierHotKeys.count(newMask) > 0) {
 				m_activeModifierHotKey     = m_modifierHotKeys[newMask];
 				m_activeModifierHotKeyMask = newMask;
-				m_events->addEvent(Event(m_events->forIPrimaryScreen().hotKeyDown(),
-								getEventTarget(),
-								HotKeyInfo::alloc(m_activeModifierHotKey)));
+				sendEvent(m_events->forIPrimaryScreen().hotKeyDown(),
+								HotKeyInfo::alloc(m_activeModifierHotKey));
 			}
 		}
 
@@ -1315,9 +1317,8 @@ OSXScreen::onKey(CGEventRef event)
 		else if (m_activeModifierHotKey != 0) {
 			KeyModifierMask mask = (newMask & m_activeModifierHotKeyMask);
 			if (mask != m_activeModifierHotKeyMask) {
-				m_events->addEvent(Event(m_events->forIPrimaryScreen().hotKeyUp(),
-								getEventTarget(),
-								HotKeyInfo::alloc(m_activeModifierHotKey)));
+				sendEvent(m_events->forIPrimaryScreen().hotKeyUp(),
+								HotKeyInfo::alloc(m_activeModifierHotKey));
 				m_activeModifierHotKey     = 0;
 				m_activeModifierHotKeyMask = 0;
 			}
@@ -1351,8 +1352,7 @@ OSXScreen::onKey(CGEventRef event)
 				return false;
 			}
 	
-			m_events->addEvent(Event(type, getEventTarget(),
-										HotKeyInfo::alloc(id)));
+			sendEvent(type, HotKeyInfo::alloc(id));
 		
 			return true;
 		}
@@ -1424,8 +1424,7 @@ OSXScreen::onHotKey(EventRef event) const
 		return false;
 	}
 
-	m_events->addEvent(Event(type, getEventTarget(),
-								HotKeyInfo::alloc(id)));
+	sendEvent(type, HotKeyInfo::alloc(id));
 
 	return true;
 }
@@ -345,7 +345,6 @@ private:
 
 	IEventQueue*			m_events;
 	
-	Thread*				m_getDropTargetThread;
 	String					m_dropTarget;
 	
 #if defined(MAC_OS_X_VERSION_10_7)
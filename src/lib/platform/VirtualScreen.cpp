@@ -0,0 +1,537 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform/VirtualScreen.h"
+
+#include "synergy/IPrimaryScreen.h"
+#include "arch/Arch.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+
+#include <stdlib.h>
+
+//
+// VirtualScreen
+//
+
+VirtualScreen::VirtualScreen(IEventQueue* events, bool isPrimary,
+				SInt32 width, SInt32 height) :
+	PlatformScreen(events),
+	m_isPrimary(isPrimary),
+	m_isOnScreen(isPrimary),
+	m_w(width),
+	m_h(height),
+	m_xCursor(width / 2),
+	m_yCursor(height / 2),
+	m_sequenceNumber(0),
+	m_lastHotKeyID(0),
+	m_events(events)
+{
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		m_clipboardTime[id]     = 0.0;
+		m_clipboardGrabTime[id] = 0.0;
+	}
+
+	LOG((CLOG_DEBUG "opened virtual %s screen %dx%d",
+		m_isPrimary ? "primary" : "secondary", m_w, m_h));
+}
+
+VirtualScreen::~VirtualScreen()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::simulateMouseMove(SInt32 dx, SInt32 dy)
+{
+	assert(m_isPrimary);
+
+	if (m_isOnScreen) {
+		m_xCursor += dx;
+		m_yCursor += dy;
+		if (m_xCursor < 0) {
+			m_xCursor = 0;
+		}
+		else if (m_xCursor >= m_w) {
+			m_xCursor = m_w - 1;
+		}
+		if (m_yCursor < 0) {
+			m_yCursor = 0;
+		}
+		else if (m_yCursor >= m_h) {
+			m_yCursor = m_h - 1;
+		}
+		sendEvent(m_events->forIPrimaryScreen().motionOnPrimary(),
+			MotionInfo::alloc(m_xCursor, m_yCursor));
+	}
+	else {
+		// like the real screens, the cursor stays put while the deltas
+		// are applied to the active secondary screen
+		sendEvent(m_events->forIPrimaryScreen().motionOnSecondary(),
+			MotionInfo::alloc(dx, dy));
+	}
+}
+
+void
+VirtualScreen::simulateMouseButton(ButtonID id, bool press)
+{
+	assert(m_isPrimary);
+
+	if (press) {
+		m_buttons.insert(id);
+		sendEvent(m_events->forIPrimaryScreen().buttonDown(),
+			ButtonInfo::alloc(id, 0));
+	}
+	else {
+		m_buttons.erase(id);
+		sendEvent(m_events->forIPrimaryScreen().buttonUp(),
+			ButtonInfo::alloc(id, 0));
+	}
+}
+
+void
+VirtualScreen::simulateMouseWheel(SInt32 xDelta, SInt32 yDelta)
+{
+	assert(m_isPrimary);
+	sendEvent(m_events->forIPrimaryScreen().wheel(),
+		WheelInfo::alloc(xDelta, yDelta));
+}
+
+void
+VirtualScreen::simulateKeyDown(KeyID id, KeyModifierMask mask, KeyButton button)
+{
+	assert(m_isPrimary);
+	m_keys.insert(button);
+	sendEvent(m_events->forIKeyState().keyDown(),
+		KeyInfo::alloc(id, mask, button, 1));
+}
+
+void
+VirtualScreen::simulateKeyUp(KeyID id, KeyModifierMask mask, KeyButton button)
+{
+	assert(m_isPrimary);
+	m_keys.erase(button);
+	sendEvent(m_events->forIKeyState().keyUp(),
+		KeyInfo::alloc(id, mask, button, 1));
+}
+
+void
+VirtualScreen::simulateCopy(ClipboardID id, const String& text)
+{
+	assert(id < kClipboardEnd);
+
+	Clipboard& clipboard = m_clipboard[id];
+	clipboard.open(0);
+	clipboard.empty();
+	clipboard.add(IClipboard::kText, text);
+	clipboard.close();
+
+	ClipboardInfo* info    = (ClipboardInfo*)malloc(sizeof(ClipboardInfo));
+	info->m_id             = id;
+	info->m_sequenceNumber = m_sequenceNumber;
+	sendEvent(m_events->forIScreen().clipboardGrabbed(), info);
+}
+
+void
+VirtualScreen::clearInjectedInput()
+{
+	m_injected.clear();
+}
+
+const VirtualScreen::InputList&
+VirtualScreen::getInjectedInput() const
+{
+	return m_injected;
+}
+
+bool
+VirtualScreen::isOnScreen() const
+{
+	return m_isOnScreen;
+}
+
+double
+VirtualScreen::getClipboardTime(ClipboardID id) const
+{
+	assert(id < kClipboardEnd);
+	return m_clipboardTime[id];
+}
+
+double
+VirtualScreen::getClipboardGrabTime(ClipboardID id) const
+{
+	assert(id < kClipboardEnd);
+	return m_clipboardGrabTime[id];
+}
+
+void*
+VirtualScreen::getEventTarget() const
+{
+	return const_cast<VirtualScreen*>(this);
+}
+
+bool
+VirtualScreen::getClipboard(ClipboardID id, IClipboard* clipboard) const
+{
+	assert(id < kClipboardEnd);
+	return Clipboard::copy(clipboard, &m_clipboard[id]);
+}
+
+void
+VirtualScreen::getShape(SInt32& x, SInt32& y, SInt32& w, SInt32& h) const
+{
+	x = 0;
+	y = 0;
+	w = m_w;
+	h = m_h;
+}
+
+void
+VirtualScreen::getCursorPos(SInt32& x, SInt32& y) const
+{
+	x = m_xCursor;
+	y = m_yCursor;
+}
+
+void
+VirtualScreen::reconfigure(UInt32)
+{
+	// do nothing
+}
+
+void
+VirtualScreen::warpCursor(SInt32 x, SInt32 y)
+{
+	m_xCursor = x;
+	m_yCursor = y;
+}
+
+UInt32
+VirtualScreen::registerHotKey(KeyID, KeyModifierMask)
+{
+	// hot keys are never pressed but pretend to register them so the
+	// server doesn't complain
+	return ++m_lastHotKeyID;
+}
+
+void
+VirtualScreen::unregisterHotKey(UInt32)
+{
+	// do nothing
+}
+
+void
+VirtualScreen::fakeInputBegin()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::fakeInputEnd()
+{
+	// do nothing
+}
+
+SInt32
+VirtualScreen::getJumpZoneSize() const
+{
+	return 1;
+}
+
+bool
+VirtualScreen::isAnyMouseButtonDown(UInt32& buttonID) const
+{
+	if (m_buttons.empty()) {
+		return false;
+	}
+	buttonID = *m_buttons.begin();
+	return true;
+}
+
+void
+VirtualScreen::getCursorCenter(SInt32& x, SInt32& y) const
+{
+	x = m_w / 2;
+	y = m_h / 2;
+}
+
+void
+VirtualScreen::fakeMouseButton(ButtonID id, bool press)
+{
+	if (press) {
+		m_buttons.insert(id);
+	}
+	else {
+		m_buttons.erase(id);
+	}
+	record(press ? Input::kMouseDown : Input::kMouseUp, id, 0, 0, 0);
+}
+
+void
+VirtualScreen::fakeMouseMove(SInt32 x, SInt32 y)
+{
+	m_xCursor = x;
+	m_yCursor = y;
+	record(Input::kMouseMove, 0, 0, x, y);
+}
+
+void
+VirtualScreen::fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const
+{
+	m_xCursor += dx;
+	m_yCursor += dy;
+	record(Input::kMouseRelativeMove, 0, 0, dx, dy);
+}
+
+void
+VirtualScreen::fakeMouseWheel(SInt32 xDelta, SInt32 yDelta) const
+{
+	record(Input::kMouseWheel, 0, 0, xDelta, yDelta);
+}
+
+void
+VirtualScreen::updateKeyMap()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::updateKeyState()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::setHalfDuplexMask(KeyModifierMask)
+{
+	// do nothing
+}
+
+void
+VirtualScreen::fakeKeyDown(KeyID id, KeyModifierMask, KeyButton button)
+{
+	m_keys.insert(button);
+	record(Input::kKeyDown, id, button, 0, 0);
+}
+
+bool
+VirtualScreen::fakeKeyRepeat(KeyID id, KeyModifierMask,
+				SInt32 count, KeyButton button)
+{
+	record(Input::kKeyRepeat, id, button, count, 0);
+	return true;
+}
+
+bool
+VirtualScreen::fakeKeyUp(KeyButton button)
+{
+	if (m_keys.erase(button) == 0) {
+		return false;
+	}
+	record(Input::kKeyUp, kKeyNone, button, 0, 0);
+	return true;
+}
+
+void
+VirtualScreen::fakeAllKeysUp()
+{
+	for (KeyButtonSet::const_iterator i = m_keys.begin(); i != m_keys.end(); ++i) {
+		record(Input::kKeyUp, kKeyNone, *i, 0, 0);
+	}
+	m_keys.clear();
+}
+
+bool
+VirtualScreen::fakeCtrlAltDel()
+{
+	return false;
+}
+
+bool
+VirtualScreen::isKeyDown(KeyButton button) const
+{
+	return (m_keys.count(button) != 0);
+}
+
+KeyModifierMask
+VirtualScreen::getActiveModifiers() const
+{
+	return 0;
+}
+
+KeyModifierMask
+VirtualScreen::pollActiveModifiers() const
+{
+	return 0;
+}
+
+SInt32
+VirtualScreen::pollActiveGroup() const
+{
+	return 0;
+}
+
+void
+VirtualScreen::pollPressedKeys(KeyButtonSet& pressedKeys) const
+{
+	pressedKeys = m_keys;
+}
+
+void
+VirtualScreen::enable()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::disable()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::enter()
+{
+	m_isOnScreen = true;
+}
+
+bool
+VirtualScreen::leave()
+{
+	m_isOnScreen = false;
+	return true;
+}
+
+bool
+VirtualScreen::setClipboard(ClipboardID id, const IClipboard* clipboard)
+{
+	assert(id < kClipboardEnd);
+
+	if (clipboard == NULL) {
+		// take ownership, as when another screen grabs the clipboard
+		m_clipboard[id].open(0);
+		m_clipboard[id].empty();
+		m_clipboard[id].close();
+		m_clipboardGrabTime[id] = ARCH->time();
+		return true;
+	}
+	m_clipboardTime[id] = ARCH->time();
+	return Clipboard::copy(&m_clipboard[id], clipboard);
+}
+
+void
+VirtualScreen::checkClipboards()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::openScreensaver(bool)
+{
+	// do nothing
+}
+
+void
+VirtualScreen::closeScreensaver()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::screensaver(bool)
+{
+	// do nothing
+}
+
+void
+VirtualScreen::resetOptions()
+{
+	// do nothing
+}
+
+void
+VirtualScreen::setOptions(const OptionsList&)
+{
+	// do nothing
+}
+
+void
+VirtualScreen::setSequenceNumber(UInt32 seqNum)
+{
+	m_sequenceNumber = seqNum;
+}
+
+bool
+VirtualScreen::isPrimary() const
+{
+	return m_isPrimary;
+}
+
+const String&
+VirtualScreen::getDropTarget() const
+{
+	return m_dropTarget;
+}
+
+bool
+VirtualScreen::isDraggingStarted()
+{
+	// nothing is ever dragged on a virtual screen
+	return false;
+}
+
+void
+VirtualScreen::handleSystemEvent(const Event&, void*)
+{
+	// do nothing
+}
+
+void
+VirtualScreen::updateButtons()
+{
+	// do nothing
+}
+
+IKeyState*
+VirtualScreen::getKeyState() const
+{
+	// the IKeyState methods are implemented directly
+	return NULL;
+}
+
+void
+VirtualScreen::record(Input::EType type, UInt32 id, KeyButton button,
+				SInt32 x, SInt32 y) const
+{
+	Input input;
+	input.m_type   = type;
+	input.m_id     = id;
+	input.m_button = button;
+	input.m_x      = x;
+	input.m_y      = y;
+	input.m_time   = ARCH->time();
+	m_injected.push_back(input);
+}
+
+void
+VirtualScreen::sendEvent(Event::Type type, void* data)
+{
+	// stamp input with when it was captured to measure its latency
+	Event event(type, getEventTarget(), data);
+	event.setTime(ARCH->time());
+	m_events->addEvent(event);
+}
@@ -0,0 +1,222 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/PlatformScreen.h"
+#include "synergy/Clipboard.h"
+#include "common/stdset.h"
+#include "common/stdvector.h"
+
+//! Headless implementation of IPlatformScreen
+/*!
+A screen with no display behind it, for benchmarks and load tests that
+run servers and clients on machines without (or with many more screens
+than) a real display.
+
+As a secondary screen it records the input injected into it along with
+the time each was injected.  As a primary screen the \c simulate*()
+methods generate input as if a user were operating it.  Clipboards are
+kept in memory.
+*/
+class VirtualScreen : public PlatformScreen {
+public:
+	//! Injected input
+	class Input {
+	public:
+		enum EType {
+			kKeyDown,
+			kKeyRepeat,
+			kKeyUp,
+			kMouseDown,
+			kMouseUp,
+			kMouseMove,
+			kMouseRelativeMove,
+			kMouseWheel
+		};
+
+		EType			m_type;
+		//! The KeyID or ButtonID
+		UInt32			m_id;
+		//! The KeyButton for key events
+		KeyButton		m_button;
+		//! Position, delta or (in \c m_x) repeat count
+		SInt32			m_x;
+		SInt32			m_y;
+		//! \c ARCH->time() when injected
+		double			m_time;
+	};
+	typedef std::vector<Input> InputList;
+
+	VirtualScreen(IEventQueue* events, bool isPrimary,
+							SInt32 width, SInt32 height);
+	virtual ~VirtualScreen();
+
+	//! @name manipulators
+	//@{
+
+	//! Simulate moving the mouse
+	/*!
+	While the cursor is on this screen it's moved by the given delta and
+	clamped to the screen.  Otherwise the delta is reported for the
+	server to apply to the active secondary screen.  Primary only.
+	*/
+	void				simulateMouseMove(SInt32 dx, SInt32 dy);
+
+	//! Simulate pressing or releasing a mouse button
+	void				simulateMouseButton(ButtonID id, bool press);
+
+	//! Simulate turning the mouse wheel
+	void				simulateMouseWheel(SInt32 xDelta, SInt32 yDelta);
+
+	//! Simulate pressing a key
+	void				simulateKeyDown(KeyID id, KeyModifierMask mask,
+							KeyButton button);
+
+	//! Simulate releasing a key
+	void				simulateKeyUp(KeyID id, KeyModifierMask mask,
+							KeyButton button);
+
+	//! Simulate copying text
+	/*!
+	Replaces clipboard \p id with \p text and grabs it, as a user copying
+	to the clipboard would.
+	*/
+	void				simulateCopy(ClipboardID id, const String& text);
+
+	//! Discard the recorded input
+	void				clearInjectedInput();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the recorded input
+	/*!
+	Returns the input injected into this screen, oldest first.
+	*/
+	const InputList&	getInjectedInput() const;
+
+	//! Check if the cursor is on this screen
+	bool				isOnScreen() const;
+
+	//! Get the time the clipboard was last set
+	/*!
+	Returns the \c ARCH->time() at which clipboard \p id was last set by
+	the client or server, or 0 if it never has been.
+	*/
+	double				getClipboardTime(ClipboardID id) const;
+
+	//! Get the time the clipboard was last grabbed
+	/*!
+	Returns the \c ARCH->time() at which another screen last took
+	ownership of clipboard \p id, or 0 if none ever has.
+	*/
+	double				getClipboardGrabTime(ClipboardID id) const;
+
+	//@}
+
+	// IScreen overrides
+	virtual void*		getEventTarget() const;
+	virtual bool		getClipboard(ClipboardID id, IClipboard*) const;
+	virtual void		getShape(SInt32& x, SInt32& y,
+							SInt32& width, SInt32& height) const;
+	virtual void		getCursorPos(SInt32& x, SInt32& y) const;
+
+	// IPrimaryScreen overrides
+	virtual void		reconfigure(UInt32 activeSides);
+	virtual void		warpCursor(SInt32 x, SInt32 y);
+	virtual UInt32		registerHotKey(KeyID key, KeyModifierMask mask);
+	virtual void		unregisterHotKey(UInt32 id);
+	virtual void		fakeInputBegin();
+	virtual void		fakeInputEnd();
+	virtual SInt32		getJumpZoneSize() const;
+	virtual bool		isAnyMouseButtonDown(UInt32& buttonID) const;
+	virtual void		getCursorCenter(SInt32& x, SInt32& y) const;
+
+	// ISecondaryScreen overrides
+	virtual void		fakeMouseButton(ButtonID id, bool press);
+	virtual void		fakeMouseMove(SInt32 x, SInt32 y);
+	virtual void		fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const;
+	virtual void		fakeMouseWheel(SInt32 xDelta, SInt32 yDelta) const;
+
+	// IKeyState overrides
+	virtual void		updateKeyMap();
+	virtual void		updateKeyState();
+	virtual void		setHalfDuplexMask(KeyModifierMask);
+	virtual void		fakeKeyDown(KeyID id, KeyModifierMask mask,
+							KeyButton button);
+	virtual bool		fakeKeyRepeat(KeyID id, KeyModifierMask mask,
+							SInt32 count, KeyButton button);
+	virtual bool		fakeKeyUp(KeyButton button);
+	virtual void		fakeAllKeysUp();
+	virtual bool		fakeCtrlAltDel();
+	virtual bool		isKeyDown(KeyButton) const;
+	virtual KeyModifierMask
+						getActiveModifiers() const;
+	virtual KeyModifierMask
+						pollActiveModifiers() const;
+	virtual SInt32		pollActiveGroup() const;
+	virtual void		pollPressedKeys(KeyButtonSet& pressedKeys) const;
+
+	// IPlatformScreen overrides
+	virtual void		enable();
+	virtual void		disable();
+	virtual void		enter();
+	virtual bool		leave();
+	virtual bool		setClipboard(ClipboardID, const IClipboard*);
+	virtual void		checkClipboards();
+	virtual void		openScreensaver(bool notify);
+	virtual void		closeScreensaver();
+	virtual void		screensaver(bool activate);
+	virtual void		resetOptions();
+	virtual void		setOptions(const OptionsList& options);
+	virtual void		setSequenceNumber(UInt32);
+	virtual bool		isPrimary() const;
+	virtual const String&
+						getDropTarget() const;
+	virtual bool		isDraggingStarted();
+
+protected:
+	// IPlatformScreen overrides
+	virtual void		handleSystemEvent(const Event&, void*);
+	virtual void		updateButtons();
+	virtual IKeyState*	getKeyState() const;
+
+private:
+	void				record(Input::EType, UInt32 id, KeyButton button,
+							SInt32 x, SInt32 y) const;
+	void				sendEvent(Event::Type, void* = NULL);
+
+private:
+	typedef std::set<ButtonID> ButtonSet;
+
+	bool				m_isPrimary;
+	bool				m_isOnScreen;
+	SInt32				m_w, m_h;
+	mutable SInt32		m_xCursor, m_yCursor;
+	UInt32				m_sequenceNumber;
+	UInt32				m_lastHotKeyID;
+	Clipboard			m_clipboard[kClipboardEnd];
+	double				m_clipboardTime[kClipboardEnd];
+	double				m_clipboardGrabTime[kClipboardEnd];
+	KeyButtonSet		m_keys;
+	ButtonSet			m_buttons;
+	mutable InputList	m_injected;
+	String				m_dropTarget;
+	IEventQueue*		m_events;
+};
@@ -23,10 +23,6 @@
 #include "base/Event.h"
 #include "base/IEventQueue.h"
 
-#include <fcntl.h>
-#if HAVE_UNISTD_H
-#	include <unistd.h>
-#endif
 #if HAVE_POLL
 #	include <poll.h>
 #else
@@ -63,22 +59,11 @@ XWindowsEventQueueBuffer::XWindowsEventQueueBuffer(
 	assert(m_window  != None);
 
 	m_userEvent = XInternAtom(m_display, "SYNERGY_USER_EVENT", False);
-	// set up for pipe hack
-	int result = pipe(m_pipefd);
-	assert(result == 0);
-
-	int pipeflags;
-	pipeflags = fcntl(m_pipefd[0], F_GETFL);
-	fcntl(m_pipefd[0], F_SETFL, pipeflags | O_NONBLOCK);
-	pipeflags = fcntl(m_pipefd[1], F_GETFL);
-	fcntl(m_pipefd[1], F_SETFL, pipeflags | O_NONBLOCK);
 }
 
 XWindowsEventQueueBuffer::~XWindowsEventQueueBuffer()
 {
-	// release pipe hack resources
-	close(m_pipefd[0]);
-	close(m_pipefd[1]);
+	// do nothing
 }
 
 void
@@ -86,16 +71,8 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 {
 	Thread::testCancel();
 
-	// clear out the pipe in preparation for waiting.
-
-	char buf[16];
-	ssize_t read_response = read(m_pipefd[0], buf, 15);
-	
-	// with linux automake, warnings are treated as errors by default
-	if (read_response < 0)
-	{
-		// todo: handle read response
-	}
+	// clear out the wakeup in preparation for waiting.
+	m_wakeup.reset();
 
 	{
 		Lock lock(&m_mutex);
@@ -117,7 +94,7 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 	struct pollfd pfds[2];
 	pfds[0].fd     = ConnectionNumber(m_display);
 	pfds[0].events = POLLIN;
-	pfds[1].fd     = m_pipefd[0];
+	pfds[1].fd     = m_wakeup.getFd();
 	pfds[1].events = POLLIN;
 	int timeout    = (dtimeout < 0.0) ? -1 :
 						static_cast<int>(1000.0 * dtimeout);
@@ -140,13 +117,13 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 	fd_set rfds;
 	FD_ZERO(&rfds);
 	FD_SET(ConnectionNumber(m_display), &rfds);
-	FD_SET(m_pipefd[0], &rfds);
+	FD_SET(m_wakeup.getFd(), &rfds);
  	int nfds;
- 	if (ConnectionNumber(m_display) > m_pipefd[0]) {
+ 	if (ConnectionNumber(m_display) > m_wakeup.getFd()) {
  		nfds = ConnectionNumber(m_display) + 1;
  	}
  	else {
- 		nfds = m_pipefd[0] + 1;
+ 		nfds = m_wakeup.getFd() + 1;
  	}
 #endif
 	// It's possible that the X server has queued events locally
@@ -166,14 +143,7 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 #if HAVE_POLL
 	retval = poll(pfds, 2, TIMEOUT_DELAY); //16ms = 60hz, but we make it > to play nicely with the cpu
  	if (pfds[1].revents & POLLIN) {
- 		ssize_t read_response = read(m_pipefd[0], buf, 15);
-		
-		// with linux automake, warnings are treated as errors by default
-		if (read_response < 0)
-		{
-			// todo: handle read response
-		}
-
+ 		m_wakeup.reset();
  	}
 #else
 	retval = select(nfds,
@@ -181,8 +151,8 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 						SELECT_TYPE_ARG234 NULL,
 						SELECT_TYPE_ARG234 NULL,
 						SELECT_TYPE_ARG5   TIMEOUT_DELAY);
-	if (FD_SET(m_pipefd[0], &rfds)) {
-		read(m_pipefd[0], buf, 15);
+	if (FD_ISSET(m_wakeup.getFd(), &rfds)) {
+		m_wakeup.reset();
 	}
 #endif
 	    remaining-=TIMEOUT_DELAY;
@@ -242,17 +212,11 @@ XWindowsEventQueueBuffer::addEvent(UInt32 dataID)
 	// too.
 	if (m_waiting) {
 		flush();
-		// Send a character through the round-trip pipe to wake a thread
-		// that is waiting for a ConnectionNumber() socket to be readable.
-		// The flush call can read incoming data from the socket and put
-		// it in Xlib's input buffer.  That sneaks it past the other thread.
-		ssize_t write_response = write(m_pipefd[1], "!", 1);
-
-		// with linux automake, warnings are treated as errors by default
-		if (write_response < 0)
-		{
-			// todo: handle read response
-		}
+		// Signal the wakeup to wake a thread that is waiting for a
+		// ConnectionNumber() socket to be readable.  The flush call can
+		// read incoming data from the socket and put it in Xlib's input
+		// buffer.  That sneaks it past the other thread.
+		m_wakeup.signal();
 	}
 
 	return true;
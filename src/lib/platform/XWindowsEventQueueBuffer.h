@@ -20,6 +20,7 @@
 
 #include "mt/Mutex.h"
 #include "base/IEventQueueBuffer.h"
+#include "arch/unix/ArchWakeupUnix.h"
 #include "common/stdvector.h"
 
 #if X_DISPLAY_MISSING
@@ -59,6 +60,6 @@ private:
 	XEvent				m_event;
 	EventList			m_postedEvents;
 	bool				m_waiting;
-	int					m_pipefd[2];
+	ArchWakeupUnix		m_wakeup;
 	IEventQueue*		m_events;
 };
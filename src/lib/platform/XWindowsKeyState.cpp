@@ -39,6 +39,7 @@
 #endif
 
 static const size_t ModifiersFromXDefaultSize = 32;
+static const size_t MaxCachedLayouts = 8;
 
 XWindowsKeyState::XWindowsKeyState(
 		Display* display, bool useXKB,
@@ -293,7 +294,11 @@ XWindowsKeyState::fakeKey(const Keystroke& keystroke)
 		}
 		break;
 	}
-	XFlush(m_display);
+
+	// don't flush.  a single key event usually turns into several
+	// keystrokes and XWindowsEventQueueBuffer flushes the display once
+	// per event dispatch, before blocking and before reading the next
+	// event, so all of them go to the server together.
 }
 
 void
@@ -544,6 +549,112 @@ XWindowsKeyState::updateKeysymMap(synergy::KeyMap& keyMap)
 #if HAVE_XKB_EXTENSION
 void
 XWindowsKeyState::updateKeysymMapXKB(synergy::KeyMap& keyMap)
+{
+	// Hack to deal with VMware.  When a VMware client grabs input the
+	// player clears out the X modifier map for whatever reason.  We're
+	// notified of the change and arrive here to discover that there
+	// are no modifiers at all.  Since this prevents the modifiers from
+	// working in the VMware client we'll use the last known good set
+	// of modifiers when there are no modifiers.  If there are modifiers
+	// we update the last known good set.
+	bool useLastGoodModifiers = !hasModifiersXKB();
+	if (useLastGoodModifiers) {
+		// the result depends on more than the keymap so don't cache it
+		XKBLayout layout;
+		buildLayoutXKB(layout, true);
+		applyLayoutXKB(layout, keyMap);
+		return;
+	}
+
+	// switching back to a layout we've already seen is common (e.g.
+	// toggling between two keyboard layouts) so reuse the result of
+	// walking the XKB keymap if it hasn't changed.
+	String signature;
+	getSignatureXKB(signature);
+	XKBLayoutCache::const_iterator index = m_xkbLayouts.find(signature);
+	if (index != m_xkbLayouts.end()) {
+		LOG((CLOG_DEBUG1 "XKB mapping (cached)"));
+		applyLayoutXKB(index->second, keyMap);
+		return;
+	}
+
+	if (m_xkbLayouts.size() >= MaxCachedLayouts) {
+		m_xkbLayouts.clear();
+	}
+	XKBLayout& layout = m_xkbLayouts[signature];
+	buildLayoutXKB(layout, false);
+	applyLayoutXKB(layout, keyMap);
+}
+
+void
+XWindowsKeyState::applyLayoutXKB(const XKBLayout& layout,
+				synergy::KeyMap& keyMap)
+{
+	m_modifierFromX        = layout.m_modifierFromX;
+	m_modifierToX          = layout.m_modifierToX;
+	m_keyCodeFromKey       = layout.m_keyCodeFromKey;
+	m_lastGoodXKBModifiers = layout.m_lastGoodXKBModifiers;
+
+	for (size_t i = 0; i < layout.m_halfDuplex.size(); ++i) {
+		keyMap.addHalfDuplexButton(layout.m_halfDuplex[i]);
+	}
+	for (size_t i = 0; i < layout.m_items.size(); ++i) {
+		keyMap.addKeyEntry(layout.m_items[i]);
+	}
+
+	// change all modifier masks to synergy masks from X masks
+	keyMap.foreachKey(&XWindowsKeyState::remapKeyModifiers, this);
+
+	// allow composition across groups
+	keyMap.allowGroupSwitchDuringCompose();
+}
+
+void
+XWindowsKeyState::getSignatureXKB(String& signature) const
+{
+	// collect every part of the keymap that buildLayoutXKB() reads.
+	// comparing these bytes is much cheaper than walking the keymap.
+	signature.clear();
+	XkbClientMapPtr map    = m_xkb->map;
+	XkbServerMapPtr server = m_xkb->server;
+	int minKeyCode         = m_xkb->min_key_code;
+	int numKeyCodes        = m_xkb->max_key_code - minKeyCode + 1;
+
+	signature.push_back(static_cast<char>(m_xkb->min_key_code));
+	signature.push_back(static_cast<char>(m_xkb->max_key_code));
+	for (int i = 0; i < map->num_types; ++i) {
+		const XkbKeyTypeRec& type = map->types[i];
+		signature.push_back(static_cast<char>(type.mods.mask));
+		signature.push_back(static_cast<char>(type.num_levels));
+		signature.push_back(static_cast<char>(type.map_count));
+		for (int j = 0; j < type.map_count; ++j) {
+			signature.push_back(static_cast<char>(type.map[j].active));
+			signature.push_back(static_cast<char>(type.map[j].level));
+			signature.push_back(static_cast<char>(type.map[j].mods.mask));
+			if (type.preserve != NULL) {
+				signature.push_back(static_cast<char>(type.preserve[j].mask));
+			}
+		}
+	}
+	signature.append(reinterpret_cast<const char*>(
+							map->key_sym_map + minKeyCode),
+						numKeyCodes * sizeof(XkbSymMapRec));
+	signature.append(reinterpret_cast<const char*>(map->syms),
+						map->num_syms * sizeof(KeySym));
+	signature.append(reinterpret_cast<const char*>(map->modmap + minKeyCode),
+						numKeyCodes);
+	signature.append(reinterpret_cast<const char*>(
+							server->key_acts + minKeyCode),
+						numKeyCodes * sizeof(unsigned short));
+	signature.append(reinterpret_cast<const char*>(server->acts),
+						server->num_acts * sizeof(XkbAction));
+	signature.append(reinterpret_cast<const char*>(
+							server->behaviors + minKeyCode),
+						numKeyCodes * sizeof(XkbBehavior));
+}
+
+void
+XWindowsKeyState::buildLayoutXKB(XKBLayout& layout, bool useLastGoodModifiers)
 {
 	static const XkbKTMapEntryRec defMapEntry = {
 		True,		// active
@@ -575,14 +686,7 @@ XWindowsKeyState::updateKeysymMapXKB(synergy::KeyMap& keyMap)
 	// prepare map from KeyID to KeyCode
 	m_keyCodeFromKey.clear();
 
-	// Hack to deal with VMware.  When a VMware client grabs input the
-	// player clears out the X modifier map for whatever reason.  We're
-	// notified of the change and arrive here to discover that there
-	// are no modifiers at all.  Since this prevents the modifiers from
-	// working in the VMware client we'll use the last known good set
-	// of modifiers when there are no modifiers.  If there are modifiers
-	// we update the last known good set.
-	bool useLastGoodModifiers = !hasModifiersXKB();
+	// see updateKeysymMapXKB() for why we'd use the last good modifiers
 	if (!useLastGoodModifiers) {
 		m_lastGoodXKBModifiers.clear();
 	}
@@ -603,7 +707,7 @@ XWindowsKeyState::updateKeysymMapXKB(synergy::KeyMap& keyMap)
 		// note half-duplex keys
 		const XkbBehavior& b = m_xkb->server->behaviors[keycode];
 		if ((b.type & XkbKB_OpMask) == XkbKB_Lock) {
-			keyMap.addHalfDuplexButton(item.m_button);
+			layout.m_halfDuplex.push_back(item.m_button);
 		}
 
 		// iterate over all groups
@@ -745,13 +849,13 @@ XWindowsKeyState::updateKeysymMapXKB(synergy::KeyMap& keyMap)
 
 						item.m_id       = lKeyID;
 						item.m_required = 0;
-						keyMap.addKeyEntry(item);
+						layout.m_items.push_back(item);
 
 						item.m_id       = uKeyID;
 						item.m_required = ShiftMask;
-						keyMap.addKeyEntry(item);
+						layout.m_items.push_back(item);
 						item.m_required = LockMask;
-						keyMap.addKeyEntry(item);
+						layout.m_items.push_back(item);
 
 						if (group == 0) {
 							m_keyCodeFromKey.insert(
@@ -765,7 +869,7 @@ XWindowsKeyState::updateKeysymMapXKB(synergy::KeyMap& keyMap)
 
 				// add entry
 				item.m_id = XWindowsUtil::mapKeySymToKeyID(keysym);
-				keyMap.addKeyEntry(item);
+				layout.m_items.push_back(item);
 				if (group == 0) {
 					m_keyCodeFromKey.insert(std::make_pair(item.m_id, keycode));
 				}
@@ -773,11 +877,10 @@ XWindowsKeyState::updateKeysymMapXKB(synergy::KeyMap& keyMap)
 		}
 	}
 
-	// change all modifier masks to synergy masks from X masks
-	keyMap.foreachKey(&XWindowsKeyState::remapKeyModifiers, this);
-
-	// allow composition across groups
-	keyMap.allowGroupSwitchDuringCompose();
+	layout.m_modifierFromX        = m_modifierFromX;
+	layout.m_modifierToX          = m_modifierToX;
+	layout.m_keyCodeFromKey       = m_keyCodeFromKey;
+	layout.m_lastGoodXKBModifiers = m_lastGoodXKBModifiers;
 }
 #endif
 
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "synergy/KeyState.h"
+#include "base/String.h"
 #include "common/stdmap.h"
 #include "common/stdvector.h"
 
@@ -165,6 +166,31 @@ private:
 	// autorepeat state
 	XKeyboardState		m_keyboardState;
 
+#if HAVE_XKB_EXTENSION
+	// everything updateKeysymMapXKB() derives from an XKB keymap
+	class XKBLayout {
+	public:
+		typedef std::vector<synergy::KeyMap::KeyItem> KeyItemList;
+		typedef std::vector<KeyButton> KeyButtonList;
+
+		KeyItemList			m_items;
+		KeyButtonList		m_halfDuplex;
+		KeyModifierMaskList	m_modifierFromX;
+		KeyModifierToXMask	m_modifierToX;
+		KeyToKeyCodeMap		m_keyCodeFromKey;
+		XKBModifierMap		m_lastGoodXKBModifiers;
+	};
+
+	// layouts we've seen, keyed by the XKB keymap they were built from
+	typedef std::map<String, XKBLayout> XKBLayoutCache;
+
+	void				buildLayoutXKB(XKBLayout&, bool useLastGoodModifiers);
+	void				applyLayoutXKB(const XKBLayout&, synergy::KeyMap&);
+	void				getSignatureXKB(String&) const;
+
+	XKBLayoutCache		m_xkbLayouts;
+#endif
+
 #ifdef TEST_ENV
 public:
 	SInt32                  group() const { return m_group; }
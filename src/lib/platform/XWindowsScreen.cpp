@@ -106,6 +106,7 @@ XWindowsScreen::XWindowsScreen(
 	m_w(0), m_h(0),
 	m_xCenter(0), m_yCenter(0),
 	m_xCursor(0), m_yCursor(0),
+	m_xRawMotion(0.0), m_yRawMotion(0.0),
 	m_keyState(NULL),
 	m_lastFocus(None),
 	m_lastFocusRevert(RevertToNone),
@@ -119,6 +120,7 @@ XWindowsScreen::XWindowsScreen(
 	m_preserveFocus(false),
 	m_xkb(false),
 	m_xi2detected(false),
+	m_xiRawDeltas(false),
 	m_xrandr(false),
 	m_events(events),
 	PlatformScreen(events)
@@ -378,6 +380,8 @@ XWindowsScreen::leave()
 
 	// now off screen
 	m_isOnScreen = false;
+	m_xRawMotion = 0.0;
+	m_yRawMotion = 0.0;
 
 	return true;
 }
@@ -829,7 +833,6 @@ XWindowsScreen::fakeMouseButton(ButtonID button, bool press)
 	if (xButton != 0) {
 		XTestFakeButtonEvent(m_display, xButton,
 							press ? True : False, CurrentTime);
-		XFlush(m_display);
 	}
 }
 
@@ -843,7 +846,9 @@ XWindowsScreen::fakeMouseMove(SInt32 x, SInt32 y)
 		XTestFakeMotionEvent(m_display, DefaultScreen(m_display),
 							x, y, CurrentTime);
 	}
-	XFlush(m_display);
+
+	// the event queue buffer flushes once per dispatch so a burst of
+	// motion goes out together.  see XWindowsKeyState::fakeKey().
 }
 
 void
@@ -856,7 +861,6 @@ XWindowsScreen::fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const
 	else {
 		XTestFakeRelativeMotionEvent(m_display, dx, dy, CurrentTime);
 	}
-	XFlush(m_display);
 }
 
 void
@@ -902,7 +906,6 @@ XWindowsScreen::fakeMouseWheel(SInt32, SInt32 yDelta) const
 		XTestFakeButtonEvent(m_display, xButton, True, CurrentTime);
 		XTestFakeButtonEvent(m_display, xButton, False, CurrentTime);
 	}
-	XFlush(m_display);
 }
 
 Display*
@@ -1147,7 +1150,10 @@ XWindowsScreen::openIM()
 void
 XWindowsScreen::sendEvent(Event::Type type, void* data)
 {
-	m_events->addEvent(Event(type, getEventTarget(), data));
+	// stamp input with when it was captured to measure its latency
+	Event event(type, getEventTarget(), data);
+	event.setTime(ARCH->time());
+	m_events->addEvent(event);
 }
 
 void
@@ -1270,6 +1276,38 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 			if (XGetEventData(m_display, cookie) &&
 				cookie->type == GenericEvent &&
 				cookie->extension == xi_opcode) {
+			if (cookie->evtype == XI_HierarchyChanged ||
+				cookie->evtype == XI_DeviceChanged) {
+				// devices were added, removed or switched mode
+				updateXIDevices();
+				XFreeEventData(m_display, cookie);
+				return;
+			}
+			if (cookie->evtype == XI_RawMotion) {
+				const XIRawEvent* raw =
+					static_cast<const XIRawEvent*>(cookie->data);
+				m_xiRawDeltas = (!m_isOnScreen &&
+								isXIRelativeDevice(raw->sourceid));
+			}
+			if (cookie->evtype == XI_RawMotion && m_xiRawDeltas) {
+				// off screen we only need deltas and a relative device
+				// gives us those directly, so there's no need to query
+				// the pointer or keep warping it back to the center.
+				// absolute devices (tablets, touchscreens) report
+				// positions here, so those take the warp path below.
+				const XIRawEvent* raw =
+					static_cast<const XIRawEvent*>(cookie->data);
+				const double* value = raw->raw_values;
+				double delta[2] = { 0.0, 0.0 };
+				for (int i = 0; i < 2 && i < raw->valuators.mask_len * 8; ++i) {
+					if (XIMaskIsSet(raw->valuators.mask, i)) {
+						delta[i] = *value++;
+					}
+				}
+				onRawMotion(delta[0], delta[1]);
+				XFreeEventData(m_display, cookie);
+				return;
+			}
 			if (cookie->evtype == XI_RawMotion) {
 				// Get current pointer's position
 				Window root, child;
@@ -1401,6 +1439,14 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 
 	case MotionNotify:
 		if (m_isPrimary) {
+#ifdef HAVE_XI2
+			// the raw event for this motion was already sent as deltas
+			// (see onRawMotion()).  warp markers must still get through.
+			if (m_xiRawDeltas && !m_isOnScreen &&
+				!xevent->xmotion.send_event) {
+				return;
+			}
+#endif
 			onMouseMove(xevent->xmotion);
 		}
 		return;
@@ -1550,8 +1596,7 @@ XWindowsScreen::onHotKey(XKeyEvent& xkey, bool isRepeat)
 
 	// generate event (ignore key repeats)
 	if (!isRepeat) {
-		m_events->addEvent(Event(type, getEventTarget(),
-								HotKeyInfo::alloc(i->second)));
+		sendEvent(type, HotKeyInfo::alloc(i->second));
 	}
 	return true;
 }
@@ -2088,16 +2133,88 @@ XWindowsScreen::detectXI2()
 void
 XWindowsScreen::selectXIRawMotion()
 {
-	XIEventMask mask;
-
-	mask.deviceid = XIAllDevices;
-	mask.mask_len = XIMaskLen(XI_RawMotion);
-	mask.mask = (unsigned char*)calloc(mask.mask_len, sizeof(char));
-	mask.deviceid = XIAllMasterDevices;
-	memset(mask.mask, 0, 2);
-    XISetMask(mask.mask, XI_RawKeyRelease);
-	XISetMask(mask.mask, XI_RawMotion);
-	XISelectEvents(m_display, DefaultRootWindow(m_display), &mask, 1);
-	free(mask.mask);
+	unsigned char masterMask[XIMaskLen(XI_RawMotion)];
+	unsigned char deviceMask[XIMaskLen(XI_RawMotion)];
+	memset(masterMask, 0, sizeof(masterMask));
+	memset(deviceMask, 0, sizeof(deviceMask));
+	XISetMask(masterMask, XI_RawKeyRelease);
+	XISetMask(masterMask, XI_RawMotion);
+	XISetMask(deviceMask, XI_HierarchyChanged);
+	XISetMask(deviceMask, XI_DeviceChanged);
+
+	XIEventMask masks[2];
+	masks[0].deviceid = XIAllMasterDevices;
+	masks[0].mask_len = sizeof(masterMask);
+	masks[0].mask     = masterMask;
+	masks[1].deviceid = XIAllDevices;
+	masks[1].mask_len = sizeof(deviceMask);
+	masks[1].mask     = deviceMask;
+	XISelectEvents(m_display, DefaultRootWindow(m_display), masks, 2);
+
+	updateXIDevices();
+}
+
+void
+XWindowsScreen::updateXIDevices()
+{
+	m_xiRelativeDevices.clear();
+
+	int n;
+	XIDeviceInfo* devices = XIQueryDevice(m_display, XIAllDevices, &n);
+	if (devices == NULL) {
+		return;
+	}
+
+	// a device is relative if both its x and y valuators are.  devices
+	// with no x/y valuators (keyboards) never send raw motion anyway.
+	for (int i = 0; i < n; ++i) {
+		int relative = 0;
+		for (int j = 0; j < devices[i].num_classes; ++j) {
+			if (devices[i].classes[j]->type != XIValuatorClass) {
+				continue;
+			}
+			const XIValuatorClassInfo* valuator =
+				reinterpret_cast<const XIValuatorClassInfo*>(
+								devices[i].classes[j]);
+			if ((valuator->number == 0 || valuator->number == 1) &&
+				valuator->mode == XIModeRelative) {
+				++relative;
+			}
+		}
+		if (relative == 2) {
+			m_xiRelativeDevices.insert(devices[i].deviceid);
+		}
+	}
+	XIFreeDeviceInfo(devices);
+
+	LOG((CLOG_DEBUG1 "%d of %d input devices report relative motion",
+							(int)m_xiRelativeDevices.size(), n));
+}
+
+bool
+XWindowsScreen::isXIRelativeDevice(int deviceid) const
+{
+	return (m_xiRelativeDevices.count(deviceid) > 0);
+}
+
+void
+XWindowsScreen::onRawMotion(double dx, double dy)
+{
+	LOG((CLOG_DEBUG2 "event: RawMotion %+f,%+f", dx, dy));
+
+	// raw deltas are unaccelerated and may be fractional.  carry the
+	// fraction over to the next event rather than dropping it so slow
+	// motion isn't lost.
+	m_xRawMotion += dx;
+	m_yRawMotion += dy;
+	SInt32 x = static_cast<SInt32>(m_xRawMotion);
+	SInt32 y = static_cast<SInt32>(m_yRawMotion);
+	m_xRawMotion -= x;
+	m_yRawMotion -= y;
+
+	if (x != 0 || y != 0) {
+		sendEvent(m_events->forIPrimaryScreen().motionOnSecondary(),
+							MotionInfo::alloc(x, y));
+	}
 }
 #endif
@@ -139,6 +139,9 @@ private:
 	bool				detectXI2();
 #ifdef HAVE_XI2
 	void				selectXIRawMotion();
+	void				updateXIDevices();
+	bool				isXIRelativeDevice(int deviceid) const;
+	void				onRawMotion(double dx, double dy);
 #endif
 	void				selectEvents(Window) const;
 	void				doSelectEvents(Window) const;
@@ -189,6 +192,9 @@ private:
 	// last mouse position
 	SInt32				m_xCursor, m_yCursor;
 
+	// sub-pixel raw motion not yet sent while off screen
+	double				m_xRawMotion, m_yRawMotion;
+
 	// keyboard stuff
 	XWindowsKeyState*	m_keyState;
 
@@ -239,6 +245,12 @@ private:
 
 	bool				m_xi2detected;
 
+	// XI2 devices whose x and y valuators report relative motion
+	std::set<int>		m_xiRelativeDevices;
+
+	// true if the last raw motion event was sent as deltas
+	bool				m_xiRawDeltas;
+
 	// XRandR extension stuff
 	bool                m_xrandr;
 	int                 m_xrandrEventBase;
@@ -23,6 +23,8 @@
 #include "base/Log.h"
 #include "base/String.h"
 
+#include <algorithm>
+
 #include <X11/Xatom.h>
 #define XK_APL
 #define XK_ARABIC
@@ -79,7 +81,9 @@
 struct codepair {
 	KeySym				keysym;
 	UInt32				ucs4;
-} s_keymap[] = {
+};
+
+static codepair s_keymap[] = {
 { XK_Aogonek,                     0x0104 }, /* LATIN CAPITAL LETTER A WITH OGONEK */
 { XK_breve,                       0x02d8 }, /* BREVE */
 { XK_Lstroke,                     0x0141 }, /* LATIN CAPITAL LETTER L WITH STROKE */
@@ -1290,7 +1294,7 @@ static const KeySym s_map1008FF[] =
 // XWindowsUtil
 //
 
-XWindowsUtil::KeySymMap	XWindowsUtil::s_keySymToUCS4;
+bool					XWindowsUtil::s_keyMapsSorted = false;
 
 bool
 XWindowsUtil::getWindowProperty(Display* display, Window window,
@@ -1545,10 +1549,17 @@ XWindowsUtil::mapKeySymToKeyID(KeySym k)
 		return s_map1008FF[k & 0xff];
 
 	default: {
-		// lookup character in table
-		KeySymMap::const_iterator index = s_keySymToUCS4.find(k);
-		if (index != s_keySymToUCS4.end()) {
-			return static_cast<KeyID>(index->second);
+		// lookup character in table.  this is a binary search without
+		// an early exit so the loop body compiles to a conditional move.
+		const codepair* entry = s_keymap;
+		size_t n = sizeof(s_keymap) / sizeof(s_keymap[0]);
+		while (n > 1) {
+			size_t half = n / 2;
+			entry = (entry[half].keysym <= k) ? entry + half : entry;
+			n    -= half;
+		}
+		if (entry->keysym == k) {
+			return static_cast<KeyID>(entry->ucs4);
 		}
 
 		// unknown character
@@ -1698,13 +1709,22 @@ XWindowsUtil::propertyNotifyPredicate(Display*, XEvent* xevent, XPointer arg)
 			xevent->xproperty.state  == PropertyNewValue) ? True : False;
 }
 
+static bool
+codepairLess(const codepair& a, const codepair& b)
+{
+	return (a.keysym < b.keysym);
+}
+
 void
 XWindowsUtil::initKeyMaps()
 {
-	if (s_keySymToUCS4.empty()) {
-		for (size_t i =0; i < sizeof(s_keymap) / sizeof(s_keymap[0]); ++i) {
-			s_keySymToUCS4[s_keymap[i].keysym] = s_keymap[i].ucs4;
-		}
+	// the keysym values (and which groups exist at all) depend on the
+	// installed keysymdef.h so the table can't be ordered by hand.  sort
+	// it in place once;  it's a flat array so there's nothing to allocate.
+	if (!s_keyMapsSorted) {
+		std::sort(s_keymap, s_keymap + sizeof(s_keymap) / sizeof(s_keymap[0]),
+							&codepairLess);
+		s_keyMapsSorted = true;
 	}
 }
 
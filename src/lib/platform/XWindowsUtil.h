@@ -181,7 +181,5 @@ private:
 	static void			initKeyMaps();
 
 private:
-	typedef std::map<KeySym, UInt32> KeySymMap;
-
-	static KeySymMap	s_keySymToUCS4;
+	static bool			s_keyMapsSorted;
 };
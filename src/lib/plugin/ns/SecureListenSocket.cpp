@@ -52,7 +52,7 @@ SecureListenSocket::accept()
 	try {
 		socket = new SecureSocket(
 						m_events,
-						m_socketMultiplexer,
+						m_socketMultiplexer->getIOMultiplexer(),
 						ARCH->acceptSocket(m_socket, NULL));
 
 		m_secureSocketSet.insert(socket);
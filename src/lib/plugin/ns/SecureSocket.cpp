@@ -52,13 +52,17 @@ SecureSocket::SecureSocket(
 		IEventQueue* events,
 		SocketMultiplexer* socketMultiplexer,
 		ArchSocket socket) :
-	TCPSocket(events, socketMultiplexer, socket),
+	TCPSocket(events, socketMultiplexer, socket, false),
 	m_secureReady(false)
 {
 }
 
 SecureSocket::~SecureSocket()
 {
+	// stop the multiplexer servicing the handshake before the ssl state
+	// it uses goes away
+	setJob(NULL);
+
 	if (m_ssl->m_ssl != NULL) {
 		SSL_shutdown(m_ssl->m_ssl);
 
@@ -98,13 +102,14 @@ SecureSocket::secureAccept()
 }
 
 UInt32
-SecureSocket::secureRead(void* buffer, UInt32 n)
+SecureSocket::secureRead(void* buffer, UInt32 n, bool& retry)
 {
 	int r = 0;
+	retry = false;
 	if (m_ssl->m_ssl != NULL) {
 		r = SSL_read(m_ssl->m_ssl, buffer, n);
 		
-		bool fatal, retry;
+		bool fatal;
 		checkResult(r, fatal, retry);
 		
 		if (retry) {
@@ -224,15 +229,17 @@ SecureSocket::secureAccept(int socket)
 	checkResult(r, fatal, retry);
 
 	if (fatal) {
-		// tell user and sleep so the socket isn't hammered.
+		// tell user.  the socket is not ready so the caller stops
+		// servicing it rather than hammering it.
 		LOG((CLOG_ERR "failed to accept secure socket"));
 		LOG((CLOG_INFO "client connection may not be secure"));
-		ARCH->sleep(1);
+		return false;
 	}
 
 	m_secureReady = !retry;
 	if (m_secureReady) {
 		LOG((CLOG_INFO "accepted secure socket"));
+		sendEvent(getEvents()->forIDataSocket().secureConnected());
 	}
 
 	return retry;
@@ -253,10 +260,11 @@ SecureSocket::secureConnect(int socket)
 	checkResult(r, fatal, retry);
 
 	if (fatal) {
-		// tell user and sleep so the socket isn't hammered.
+		// tell user.  the socket is not ready so the caller stops
+		// servicing it rather than hammering it.
 		LOG((CLOG_ERR "failed to connect secure socket"));
 		LOG((CLOG_INFO "server connection may not be secure"));
-		ARCH->sleep(1);
+		return false;
 	}
 
 	m_secureReady = !retry;
@@ -264,6 +272,7 @@ SecureSocket::secureConnect(int socket)
 	if (m_secureReady) {
 		LOG((CLOG_INFO "connected to secure socket"));
 		showCertificate();
+		sendEvent(getEvents()->forIDataSocket().secureConnected());
 	}
 
 	return retry;
@@ -390,8 +399,13 @@ SecureSocket::getError()
 
 ISocketMultiplexerJob*
 SecureSocket::serviceConnect(ISocketMultiplexerJob* job,
-				bool, bool write, bool error)
+				bool read, bool write, bool error)
 {
+	if (!read && !write && !error) {
+		// some other socket woke the multiplexer
+		return job;
+	}
+
 	Lock lock(&getMutex());
 
 	bool retry = true;
@@ -401,13 +415,19 @@ SecureSocket::serviceConnect(ISocketMultiplexerJob* job,
 	retry = secureConnect(getSocket()->m_fd);
 #endif
 
-	return retry ? job : newJob();
+	return serviceHandshake(job, retry,
+							&SecureSocket::serviceConnect);
 }
 
 ISocketMultiplexerJob*
 SecureSocket::serviceAccept(ISocketMultiplexerJob* job,
-				bool, bool write, bool error)
+				bool read, bool write, bool error)
 {
+	if (!read && !write && !error) {
+		// some other socket woke the multiplexer
+		return job;
+	}
+
 	Lock lock(&getMutex());
 
 	bool retry = true;
@@ -417,5 +437,29 @@ SecureSocket::serviceAccept(ISocketMultiplexerJob* job,
 	retry = secureAccept(getSocket()->m_fd);
 #endif
 
-	return retry ? job : newJob();
+	return serviceHandshake(job, retry,
+							&SecureSocket::serviceAccept);
+}
+
+ISocketMultiplexerJob*
+SecureSocket::serviceHandshake(ISocketMultiplexerJob* job, bool retry,
+				ServiceMethod method)
+{
+	// note -- must have the mutex locked on entry
+
+	if (!retry) {
+		// a failed handshake has already reported the disconnection
+		// so stop servicing the socket
+		return m_secureReady ? newJob() : NULL;
+	}
+
+	// only wait for the direction the handshake is blocked on.  waiting
+	// on writable too would wake the multiplexer continuously while the
+	// peer is still thinking.
+	bool write = (SSL_want_write(m_ssl->m_ssl) != 0);
+	if (job->isReadable() == !write && job->isWritable() == write) {
+		return job;
+	}
+	return new TSocketMultiplexerMethodJob<SecureSocket>(
+			this, method, getSocket(), !write, write);
 }
@@ -46,7 +46,7 @@ public:
 	bool				isReady() const { return m_secureReady; }
 	bool				isSecureReady();
 	bool				isSecure() { return true; }
-	UInt32				secureRead(void* buffer, UInt32 n);
+	UInt32				secureRead(void* buffer, UInt32 n, bool& retry);
 	UInt32				secureWrite(const void* buffer, UInt32 n);
 	void				initSsl(bool server);
 	void				loadCertificates(const char* CertFile);
@@ -71,6 +71,13 @@ private:
 						serviceAccept(ISocketMultiplexerJob*,
 							bool, bool, bool);
 
+	typedef ISocketMultiplexerJob* (SecureSocket::*ServiceMethod)(
+							ISocketMultiplexerJob*, bool, bool, bool);
+
+	ISocketMultiplexerJob*
+						serviceHandshake(ISocketMultiplexerJob*,
+							bool retry, ServiceMethod);
+
 private:
 	Ssl*				m_ssl;
 	bool				m_secureReady;
@@ -18,6 +18,8 @@
 
 #include "server/BaseClientProxy.h"
 
+#include "server/KeyBroadcast.h"
+
 //
 // BaseClientProxy
 //
@@ -25,7 +27,8 @@
 BaseClientProxy::BaseClientProxy(const String& name) :
 	m_name(name),
 	m_x(0),
-	m_y(0)
+	m_y(0),
+	m_handle(kNoScreenHandle)
 {
 	// do nothing
 }
@@ -42,6 +45,26 @@ BaseClientProxy::setJumpCursorPos(SInt32 x, SInt32 y)
 	m_y = y;
 }
 
+void
+BaseClientProxy::setScreenHandle(ScreenHandle handle)
+{
+	m_handle = handle;
+}
+
+void
+BaseClientProxy::keyBroadcast(KeyBroadcast& key)
+{
+	switch (key.getType()) {
+	case KeyBroadcast::kDown:
+		keyDown(key.getKey(), key.getMask(), key.getButton());
+		break;
+
+	case KeyBroadcast::kUp:
+		keyUp(key.getKey(), key.getMask(), key.getButton());
+		break;
+	}
+}
+
 void
 BaseClientProxy::getJumpCursorPos(SInt32& x, SInt32& y) const
 {
@@ -22,6 +22,18 @@
 #include "base/String.h"
 
 namespace synergy { class IStream; }
+class KeyBroadcast;
+
+//! Screen handle
+/*!
+Type to hold the small integer the server assigns to a connected
+screen.  Handles are dense, starting at zero, and are reused once a
+screen disconnects so they can index arrays and bitsets directly.
+*/
+typedef UInt32			ScreenHandle;
+
+//! Invalid screen handle
+static const ScreenHandle	kNoScreenHandle = 0xffffffff;
 
 //! Generic proxy for client or primary
 class BaseClientProxy : public IClient {
@@ -41,6 +53,24 @@ public:
 	*/
 	void				setJumpCursorPos(SInt32 x, SInt32 y);
 
+	//! Set screen handle
+	/*!
+	Set the handle the server uses to index this client.  Use
+	\c kNoScreenHandle when the client is no longer in the server's
+	client list.
+	*/
+	void				setScreenHandle(ScreenHandle handle);
+
+	//! Relay key event sent to several screens
+	/*!
+	Sends a key event that the server is relaying to several screens at
+	once.  Proxies for remote clients write the encoding shared through
+	\p key so the event is serialized once per protocol format rather
+	than once per client.  The default calls keyDown(), keyUp() or
+	keyRepeat().
+	*/
+	virtual void		keyBroadcast(KeyBroadcast& key);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -51,6 +81,13 @@ public:
 	*/
 	void				getJumpCursorPos(SInt32& x, SInt32& y) const;
 
+	//! Get screen handle
+	/*!
+	Returns the handle set by setScreenHandle(), or \c kNoScreenHandle
+	if the client hasn't been added to the server.
+	*/
+	ScreenHandle		getScreenHandle() const { return m_handle; }
+
 	//@}
 
 	// IScreen
@@ -90,4 +127,5 @@ public:
 private:
 	String				m_name;
 	SInt32				m_x, m_y;
+	ScreenHandle		m_handle;
 };
@@ -21,6 +21,8 @@
 #include "server/ClientProxy.h"
 #include "server/ClientProxyUnknown.h"
 #include "synergy/PacketStreamFilter.h"
+#include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_types.h"
 #include "net/IDataSocket.h"
 #include "net/IListenSocket.h"
 #include "net/ISocketFactory.h"
@@ -39,26 +41,32 @@ static const char s_networkSecurity[] = { "ns" };
 static const char s_networkSecurity[] = { "libns" };
 #endif
 
+// how long a client has to complete the secure handshake
+static const double s_secureHandshakeTimeout = 10.0;
+
+// how many clients may be connecting (in the secure handshake or the
+// hello exchange) at once.  more are asked to come back later.
+static const size_t s_maxConnectingClients = 16;
+
+// how long a client that is turned away is asked to wait for each batch
+// of clients turned away before it, and the most it is asked to wait
+static const double s_retryAfter    = 0.5;
+static const double s_maxRetryAfter = 10.0;
+
 ClientListener::ClientListener(const NetworkAddress& address,
 				ISocketFactory* socketFactory,
 				IEventQueue* events,
-				bool enableCrypto) :
+				bool secure) :
 	m_socketFactory(socketFactory),
+	m_numTurnedAway(0),
 	m_server(NULL),
 	m_events(events),
-	m_useSecureNetwork(false)
+	m_useSecureNetwork(secure)
 {
 	assert(m_socketFactory != NULL);
 
 	try {
 		// create listen socket
-		if (enableCrypto) {
-			m_useSecureNetwork = ARCH->plugin().exists(s_networkSecurity);
-			if (m_useSecureNetwork == false) {
-				LOG((CLOG_NOTE "crypto disabled because of ns plugin not available"));
-			}
-		}
-
 		m_listen = m_socketFactory->createListen(m_useSecureNetwork);
 
 		// bind listen address
@@ -87,6 +95,25 @@ ClientListener::~ClientListener()
 {
 	LOG((CLOG_DEBUG1 "stop listening for clients"));
 
+	// discard clients still doing the secure handshake.  the sockets
+	// are owned by the listen socket.
+	while (!m_pendingSockets.empty()) {
+		removePendingSocket(m_pendingSockets.begin()->first);
+	}
+
+	// discard clients we're turning away
+	for (TurnedAwayClients::iterator index = m_turnedAwayClients.begin();
+								index != m_turnedAwayClients.end(); ++index) {
+		synergy::IStream* stream = *index;
+		m_events->removeHandler(
+							m_events->forIStream().outputFlushed(),
+							stream->getEventTarget());
+		m_events->removeHandler(
+							m_events->forISocket().disconnected(),
+							stream->getEventTarget());
+		delete stream;
+	}
+
 	// discard already connected clients
 	for (NewClients::iterator index = m_newClients.begin();
 								index != m_newClients.end(); ++index) {
@@ -141,38 +168,52 @@ void
 ClientListener::handleClientConnecting(const Event&, void*)
 {
 	// accept client connection
-	IDataSocket* socket	= m_listen->accept();
-	synergy::IStream* stream  = socket;
+	IDataSocket* socket = m_listen->accept();
+	if (socket == NULL) {
+		return;
+	}
 
-	if (stream == NULL) {
+	// admit clients in batches so a storm of reconnecting clients can't
+	// swamp the event loop with handshakes
+	size_t connecting = m_pendingSockets.size() + m_newClients.size();
+	if (connecting == 0) {
+		m_numTurnedAway = 0;
+	}
+	else if (connecting >= s_maxConnectingClients) {
+		turnAwayClient(socket);
 		return;
 	}
 
 	LOG((CLOG_NOTE "accepted client connection"));
 
-	// filter socket messages, including a packetizing filter
-	bool adopt = !m_useSecureNetwork;
-	stream = new PacketStreamFilter(m_events, stream, adopt);
-
-	assert(m_server != NULL);
-
-	if (m_useSecureNetwork) {
-		while(!socket->isReady()) {
-			ARCH->sleep(.5f);
-		}
+	if (!m_useSecureNetwork) {
+		addUnknownClient(socket);
+		return;
 	}
 
-	// create proxy for unknown client
-	ClientProxyUnknown* client = new ClientProxyUnknown(stream, 30.0, m_server, m_events);
-	m_newClients.insert(client);
+	// the socket multiplexer services the handshake.  don't talk to the
+	// client until it has finished so a slow or stalled client can't
+	// hold up the event loop or any other connecting client.
+	EventQueueTimer* timer =
+		m_events->newOneShotTimer(s_secureHandshakeTimeout, NULL);
+	m_pendingSockets.insert(std::make_pair(socket, timer));
 
-	// watch for events from unknown client
-	m_events->adoptHandler(m_events->forClientProxyUnknown().success(), client,
+	m_events->adoptHandler(m_events->forIDataSocket().secureConnected(),
+							socket->getEventTarget(),
 							new TMethodEventJob<ClientListener>(this,
-								&ClientListener::handleUnknownClient, client));
-	m_events->adoptHandler(m_events->forClientProxyUnknown().failure(), client,
+								&ClientListener::handleSecureConnected,
+								socket));
+	m_events->adoptHandler(m_events->forISocket().disconnected(),
+							socket->getEventTarget(),
 							new TMethodEventJob<ClientListener>(this,
-								&ClientListener::handleUnknownClient, client));
+								&ClientListener::handleSecureFailed,
+								socket));
+	m_events->adoptHandler(Event::kTimer, timer,
+							new TMethodEventJob<ClientListener>(this,
+								&ClientListener::handleSecureTimeout,
+								socket));
+	LOG((CLOG_DEBUG1 "waiting for secure handshake, %d pending",
+		static_cast<int>(m_pendingSockets.size())));
 }
 
 void
@@ -237,6 +278,127 @@ ClientListener::handleClientDisconnected(const Event&, void* vclient)
 	}
 }
 
+void
+ClientListener::handleSecureConnected(const Event&, void* vsocket)
+{
+	IDataSocket* socket = reinterpret_cast<IDataSocket*>(vsocket);
+	removePendingSocket(socket);
+	addUnknownClient(socket);
+}
+
+void
+ClientListener::handleSecureFailed(const Event&, void* vsocket)
+{
+	IDataSocket* socket = reinterpret_cast<IDataSocket*>(vsocket);
+	LOG((CLOG_NOTE "secure handshake with client failed"));
+	removePendingSocket(socket);
+	deleteSocket(socket);
+}
+
+void
+ClientListener::handleSecureTimeout(const Event&, void* vsocket)
+{
+	IDataSocket* socket = reinterpret_cast<IDataSocket*>(vsocket);
+	LOG((CLOG_NOTE "secure handshake with client timed out"));
+	removePendingSocket(socket);
+	deleteSocket(socket);
+}
+
+void
+ClientListener::handleTurnedAwayClient(const Event&, void* vstream)
+{
+	synergy::IStream* stream = reinterpret_cast<synergy::IStream*>(vstream);
+	m_events->removeHandler(m_events->forIStream().outputFlushed(),
+							stream->getEventTarget());
+	m_events->removeHandler(m_events->forISocket().disconnected(),
+							stream->getEventTarget());
+	m_turnedAwayClients.erase(stream);
+	delete stream;
+}
+
+void
+ClientListener::addUnknownClient(IDataSocket* socket)
+{
+	assert(m_server != NULL);
+
+	// filter socket messages, including a packetizing filter.  secure
+	// sockets are deleted by the listen socket that created them.
+	bool adopt = !m_useSecureNetwork;
+	synergy::IStream* stream = new PacketStreamFilter(m_events, socket, adopt);
+
+	// create proxy for unknown client
+	ClientProxyUnknown* client = new ClientProxyUnknown(stream, 30.0, m_server, m_events);
+	m_newClients.insert(client);
+
+	// watch for events from unknown client
+	m_events->adoptHandler(m_events->forClientProxyUnknown().success(), client,
+							new TMethodEventJob<ClientListener>(this,
+								&ClientListener::handleUnknownClient, client));
+	m_events->adoptHandler(m_events->forClientProxyUnknown().failure(), client,
+							new TMethodEventJob<ClientListener>(this,
+								&ClientListener::handleUnknownClient, client));
+}
+
+void
+ClientListener::turnAwayClient(IDataSocket* socket)
+{
+	// ask the client to wait longer for each batch of clients turned
+	// away before it so they don't all come back at once
+	double retryAfter = s_retryAfter *
+						(1 + m_numTurnedAway / s_maxConnectingClients);
+	if (retryAfter > s_maxRetryAfter) {
+		retryAfter = s_maxRetryAfter;
+	}
+	++m_numTurnedAway;
+
+	if (m_useSecureNetwork) {
+		// we can't say anything without a secure handshake, which is
+		// the work we're avoiding, so just hang up.  the client will
+		// back off anyway.
+		LOG((CLOG_DEBUG "too many clients connecting, hanging up"));
+		deleteSocket(socket);
+		return;
+	}
+
+	LOG((CLOG_DEBUG "too many clients connecting, asking client to retry in %.1f seconds", retryAfter));
+	synergy::IStream* stream = new PacketStreamFilter(m_events, socket, true);
+	m_turnedAwayClients.insert(stream);
+	m_events->adoptHandler(m_events->forIStream().outputFlushed(),
+							stream->getEventTarget(),
+							new TMethodEventJob<ClientListener>(this,
+								&ClientListener::handleTurnedAwayClient,
+								stream));
+	m_events->adoptHandler(m_events->forISocket().disconnected(),
+							stream->getEventTarget(),
+							new TMethodEventJob<ClientListener>(this,
+								&ClientListener::handleTurnedAwayClient,
+								stream));
+
+	// the client expects a hello before anything else
+	ProtocolUtil::writef(stream, kMsgHello,
+							kProtocolMajorVersion,
+							kProtocolMinorVersion);
+	ProtocolUtil::writef(stream, kMsgERetry,
+							static_cast<SInt32>(retryAfter * 1000.0));
+}
+
+void
+ClientListener::removePendingSocket(IDataSocket* socket)
+{
+	PendingSockets::iterator i = m_pendingSockets.find(socket);
+	if (i == m_pendingSockets.end()) {
+		return;
+	}
+
+	m_events->removeHandler(m_events->forIDataSocket().secureConnected(),
+							socket->getEventTarget());
+	m_events->removeHandler(m_events->forISocket().disconnected(),
+							socket->getEventTarget());
+	m_events->removeHandler(Event::kTimer, i->second);
+	m_events->deleteTimer(i->second);
+	m_pendingSockets.erase(i);
+}
+
 void
 ClientListener::cleanupListenSocket()
 {
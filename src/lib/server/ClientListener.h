@@ -22,23 +22,29 @@
 #include "base/EventTypes.h"
 #include "base/Event.h"
 #include "common/stddeque.h"
+#include "common/stdmap.h"
 #include "common/stdset.h"
 
 class ClientProxy;
 class ClientProxyUnknown;
+class EventQueueTimer;
 class NetworkAddress;
+class IDataSocket;
 class IListenSocket;
 class ISocketFactory;
 class Server;
 class IEventQueue;
+namespace synergy { class IStream; }
 
 class ClientListener {
 public:
-	// The factories are adopted.
+	// The factories are adopted.  If \p secure is true the listen socket
+	// and the sockets it accepts come from the network security plugin,
+	// which the caller must have checked is available.
 	ClientListener(const NetworkAddress&,
 							ISocketFactory*,
 							IEventQueue* events,
-							bool enableCrypto);
+							bool secure);
 	~ClientListener();
 
 	//! @name manipulators
@@ -72,15 +78,29 @@ private:
 	void				handleUnknownClient(const Event&, void*);
 	void				handleClientDisconnected(const Event&, void*);
 
+	// secure handshake event handlers
+	void				handleSecureConnected(const Event&, void*);
+	void				handleSecureFailed(const Event&, void*);
+	void				handleSecureTimeout(const Event&, void*);
+	void				handleTurnedAwayClient(const Event&, void*);
+
+	void				addUnknownClient(IDataSocket*);
+	void				turnAwayClient(IDataSocket*);
+	void				removePendingSocket(IDataSocket*);
 	void				cleanupListenSocket();
 
 private:
+	typedef std::map<IDataSocket*, EventQueueTimer*> PendingSockets;
 	typedef std::set<ClientProxyUnknown*> NewClients;
+	typedef std::set<synergy::IStream*> TurnedAwayClients;
 	typedef std::deque<ClientProxy*> WaitingClients;
 
 	IListenSocket*		m_listen;
 	ISocketFactory*		m_socketFactory;
+	PendingSockets		m_pendingSockets;
 	NewClients			m_newClients;
+	TurnedAwayClients	m_turnedAwayClients;
+	UInt32				m_numTurnedAway;
 	WaitingClients		m_waitingClients;
 	Server*				m_server;
 	IEventQueue*		m_events;
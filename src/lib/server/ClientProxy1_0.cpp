@@ -18,6 +18,7 @@
 
 #include "server/ClientProxy1_0.h"
 
+#include "server/KeyBroadcast.h"
 #include "synergy/ProtocolUtil.h"
 #include "synergy/XSynergy.h"
 #include "io/IStream.h"
@@ -325,6 +326,28 @@ ClientProxy1_0::keyUp(KeyID key, KeyModifierMask mask, KeyButton)
 	ProtocolUtil::writef(getStream(), kMsgDKeyUp1_0, key, mask);
 }
 
+void
+ClientProxy1_0::keyBroadcast(KeyBroadcast& key)
+{
+	switch (key.getType()) {
+	case KeyBroadcast::kDown:
+		writeKeyBroadcast(key, kMsgDKeyDown1_0);
+		break;
+
+	case KeyBroadcast::kUp:
+		writeKeyBroadcast(key, kMsgDKeyUp1_0);
+		break;
+	}
+}
+
+void
+ClientProxy1_0::writeKeyBroadcast(KeyBroadcast& key, const char* fmt)
+{
+	LOG((CLOG_DEBUG1 "send key broadcast to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key.getKey(), key.getMask()));
+	const String& message = key.getMessage(fmt);
+	getStream()->write(message.data(), (UInt32)message.size());
+}
+
 void
 ClientProxy1_0::mouseDown(ButtonID button)
 {
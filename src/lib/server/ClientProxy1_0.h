@@ -61,7 +61,14 @@ public:
 	virtual void		sendDragInfo(UInt32 fileCount, const char* info, size_t size);
 	virtual void		fileChunkSending(UInt8 mark, char* data, size_t dataSize);
 
+	// BaseClientProxy overrides
+	virtual void		keyBroadcast(KeyBroadcast& key);
+
 protected:
+	// write the shared encoding of \p key using protocol format \p fmt
+	void				writeKeyBroadcast(KeyBroadcast& key,
+							const char* fmt);
+
 	virtual bool		parseHandshakeMessage(const UInt8* code);
 	virtual bool		parseMessage(const UInt8* code);
 
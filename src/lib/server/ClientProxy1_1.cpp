@@ -18,6 +18,7 @@
 
 #include "server/ClientProxy1_1.h"
 
+#include "server/KeyBroadcast.h"
 #include "synergy/ProtocolUtil.h"
 #include "base/Log.h"
 
@@ -53,6 +54,20 @@ ClientProxy1_1::keyRepeat(KeyID key, KeyModifierMask mask,
 	ProtocolUtil::writef(getStream(), kMsgDKeyRepeat, key, mask, count, button);
 }
 
+void
+ClientProxy1_1::keyBroadcast(KeyBroadcast& key)
+{
+	switch (key.getType()) {
+	case KeyBroadcast::kDown:
+		writeKeyBroadcast(key, kMsgDKeyDown);
+		break;
+
+	case KeyBroadcast::kUp:
+		writeKeyBroadcast(key, kMsgDKeyUp);
+		break;
+	}
+}
+
 void
 ClientProxy1_1::keyUp(KeyID key, KeyModifierMask mask, KeyButton button)
 {
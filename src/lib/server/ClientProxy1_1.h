@@ -31,4 +31,7 @@ public:
 	virtual void		keyRepeat(KeyID, KeyModifierMask,
 							SInt32 count, KeyButton);
 	virtual void		keyUp(KeyID, KeyModifierMask, KeyButton);
+
+	// BaseClientProxy overrides
+	virtual void		keyBroadcast(KeyBroadcast& key);
 };
@@ -0,0 +1,161 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ClientProxy1_6.h"
+
+#include "server/Server.h"
+#include "synergy/InputLatency.h"
+#include "synergy/ProtocolUtil.h"
+#include "synergy/option_types.h"
+#include "io/IStream.h"
+#include "base/Log.h"
+
+#include <cstring>
+
+//
+// ClientProxy1_6
+//
+
+ClientProxy1_6::ClientProxy1_6(const String& name, synergy::IStream* stream, Server* server, IEventQueue* events) :
+	ClientProxy1_5(name, stream, server, events),
+	m_sendInputTime(false)
+{
+}
+
+ClientProxy1_6::~ClientProxy1_6()
+{
+}
+
+void
+ClientProxy1_6::keyDown(KeyID key, KeyModifierMask mask, KeyButton button)
+{
+	sendInputTime();
+	ClientProxy1_5::keyDown(key, mask, button);
+}
+
+void
+ClientProxy1_6::keyRepeat(KeyID key, KeyModifierMask mask, SInt32 count, KeyButton button)
+{
+	sendInputTime();
+	ClientProxy1_5::keyRepeat(key, mask, count, button);
+}
+
+void
+ClientProxy1_6::keyUp(KeyID key, KeyModifierMask mask, KeyButton button)
+{
+	sendInputTime();
+	ClientProxy1_5::keyUp(key, mask, button);
+}
+
+void
+ClientProxy1_6::keyBroadcast(KeyBroadcast& key)
+{
+	// the broadcast message is shared by every client but the time
+	// message isn't, so it goes ahead of the shared bytes
+	sendInputTime();
+	ClientProxy1_5::keyBroadcast(key);
+}
+
+void
+ClientProxy1_6::mouseDown(ButtonID button)
+{
+	sendInputTime();
+	ClientProxy1_5::mouseDown(button);
+}
+
+void
+ClientProxy1_6::mouseUp(ButtonID button)
+{
+	sendInputTime();
+	ClientProxy1_5::mouseUp(button);
+}
+
+void
+ClientProxy1_6::mouseMove(SInt32 xAbs, SInt32 yAbs)
+{
+	sendInputTime();
+	ClientProxy1_5::mouseMove(xAbs, yAbs);
+}
+
+void
+ClientProxy1_6::mouseRelativeMove(SInt32 xRel, SInt32 yRel)
+{
+	sendInputTime();
+	ClientProxy1_5::mouseRelativeMove(xRel, yRel);
+}
+
+void
+ClientProxy1_6::mouseWheel(SInt32 xDelta, SInt32 yDelta)
+{
+	sendInputTime();
+	ClientProxy1_5::mouseWheel(xDelta, yDelta);
+}
+
+void
+ClientProxy1_6::resetOptions()
+{
+	m_sendInputTime = false;
+	ClientProxy1_5::resetOptions();
+}
+
+void
+ClientProxy1_6::setOptions(const OptionsList& options)
+{
+	for (UInt32 i = 0, n = (UInt32)options.size(); i < n; i += 2) {
+		if (options[i] == kOptionInputLatency) {
+			m_sendInputTime = (options[i + 1] != 0);
+		}
+	}
+	ClientProxy1_5::setOptions(options);
+}
+
+bool
+ClientProxy1_6::parseMessage(const UInt8* code)
+{
+	if (memcmp(code, kMsgCClockSync, 4) == 0) {
+		return clockSyncReceived();
+	}
+	return ClientProxy1_5::parseMessage(code);
+}
+
+void
+ClientProxy1_6::sendInputTime()
+{
+	// input that wasn't captured by a screen, such as keystrokes sent
+	// by a filter action for a non-input event, has no capture time
+	double captureTime = getServer()->getInputCaptureTime();
+	if (m_sendInputTime && captureTime != 0.0) {
+		UInt32 capture = InputLatency::toMicroseconds(captureTime);
+		ProtocolUtil::writef(getStream(), kMsgDInputTime, capture, InputLatency::now());
+	}
+}
+
+bool
+ClientProxy1_6::clockSyncReceived()
+{
+	UInt32 received = InputLatency::now();
+	UInt32 clientSend, unused1, unused2;
+	if (!ProtocolUtil::readf(getStream(), kMsgCClockSync + 4,
+							&clientSend, &unused1, &unused2)) {
+		return false;
+	}
+
+	// reply straight away so queueing here doesn't skew the estimate
+	ProtocolUtil::writef(getStream(), kMsgCClockSync,
+							clientSend, received, InputLatency::now());
+	return true;
+}
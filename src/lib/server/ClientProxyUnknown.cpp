@@ -25,12 +25,15 @@
 #include "server/ClientProxy1_3.h"
 #include "server/ClientProxy1_4.h"
 #include "server/ClientProxy1_5.h"
+#include "server/ClientProxy1_6.h"
 #include "synergy/protocol_types.h"
 #include "synergy/ProtocolUtil.h"
 #include "synergy/XSynergy.h"
+#include "synergy/PacketStreamFilter.h"
 #include "io/IStream.h"
 #include "io/XIO.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
 #include "base/String.h"
 #include "base/IEventQueue.h"
 #include "base/TMethodEventJob.h"
@@ -227,6 +230,10 @@ ClientProxyUnknown::handleData(const Event&, void*)
 			case 5:
 				m_proxy = new ClientProxy1_5(name, m_stream, m_server, m_events);
 				break;
+
+			case 6:
+				m_proxy = new ClientProxy1_6(name, m_stream, m_server, m_events);
+				break;
 			}
 		}
 
@@ -235,6 +242,18 @@ ClientProxyUnknown::handleData(const Event&, void*)
 			throw XIncompatibleClient(major, minor);
 		}
 
+		// count this client's traffic
+		PacketStreamFilter* packetStream =
+			dynamic_cast<PacketStreamFilter*>(m_stream);
+		if (packetStream != NULL) {
+			String label = Metrics::label("client", name);
+			packetStream->setMetrics(label,
+				METRICS->counter("synergy_client_received_bytes_total",
+					"Bytes received from a client", label),
+				METRICS->counter("synergy_client_sent_bytes_total",
+					"Bytes sent to a client", label));
+		}
+
 		// the proxy is created and now proxy now owns the stream
 		LOG((CLOG_DEBUG1 "created proxy for client \"%s\" version %d.%d", name.c_str(), major, minor));
 		m_stream = NULL;
@@ -27,9 +27,43 @@
 #include <cstdlib>
 #include <cstring>
 
+// modifiers that cannot be combined with a mouse button
+static const KeyModifierMask s_buttonIgnoreMask =
+	KeyModifierAltGr | KeyModifierCapsLock |
+	KeyModifierNumLock | KeyModifierScrollLock;
+
 // -----------------------------------------------------------------------------
 // Input Filter Condition Classes
 // -----------------------------------------------------------------------------
+InputFilter::MatchKey::MatchKey() :
+	m_kind(kMatchHotKey),
+	m_code(0),
+	m_mask(0)
+{
+	// do nothing
+}
+
+InputFilter::MatchKey::MatchKey(
+		EMatchKind kind, UInt32 code, KeyModifierMask mask) :
+	m_kind(kind),
+	m_code(code),
+	m_mask(mask)
+{
+	// do nothing
+}
+
+bool
+InputFilter::MatchKey::operator<(const MatchKey& x) const
+{
+	if (m_kind != x.m_kind) {
+		return (m_kind < x.m_kind);
+	}
+	if (m_code != x.m_code) {
+		return (m_code < x.m_code);
+	}
+	return (m_mask < x.m_mask);
+}
+
 InputFilter::Condition::Condition()
 {
 	// do nothing
@@ -40,6 +74,12 @@ InputFilter::Condition::~Condition()
 	// do nothing
 }
 
+bool
+InputFilter::Condition::getMatchKey(MatchKey&) const
+{
+	return false;
+}
+
 void
 InputFilter::Condition::enablePrimary(PrimaryClient*)
 {
@@ -129,6 +169,13 @@ InputFilter::KeystrokeCondition::match(const Event& event)
 	return status;
 }
 
+bool
+InputFilter::KeystrokeCondition::getMatchKey(MatchKey& key) const
+{
+	key = MatchKey(kMatchHotKey, m_id, 0);
+	return true;
+}
+
 void
 InputFilter::KeystrokeCondition::enablePrimary(PrimaryClient* primary)
 {
@@ -196,10 +243,6 @@ InputFilter::MouseButtonCondition::format() const
 InputFilter::EFilterStatus		
 InputFilter::MouseButtonCondition::match(const Event& event)
 {
-	static const KeyModifierMask s_ignoreMask =
-		KeyModifierAltGr | KeyModifierCapsLock |
-		KeyModifierNumLock | KeyModifierScrollLock;
-
 	EFilterStatus status;
 
 	// check for hotkey events
@@ -219,13 +262,20 @@ InputFilter::MouseButtonCondition::match(const Event& event)
 	IPlatformScreen::ButtonInfo* minfo =
 		reinterpret_cast<IPlatformScreen::ButtonInfo*>(event.getData());
 	if (minfo->m_button != m_button ||
-		(minfo->m_mask & ~s_ignoreMask) != m_mask) {
+		(minfo->m_mask & ~s_buttonIgnoreMask) != m_mask) {
 		return kNoMatch;
 	}
 
 	return status;
 }
 
+bool
+InputFilter::MouseButtonCondition::getMatchKey(MatchKey& key) const
+{
+	key = MatchKey(kMatchButton, m_button, m_mask);
+	return true;
+}
+
 InputFilter::ScreenConnectedCondition::ScreenConnectedCondition(
 		IEventQueue* events, const String& screen) :
 	m_screen(screen),
@@ -265,6 +315,13 @@ InputFilter::ScreenConnectedCondition::match(const Event& event)
 	return kNoMatch;
 }
 
+bool
+InputFilter::ScreenConnectedCondition::getMatchKey(MatchKey& key) const
+{
+	key = MatchKey(kMatchConnected, 0, 0);
+	return true;
+}
+
 // -----------------------------------------------------------------------------
 // Input Filter Action Classes
 // -----------------------------------------------------------------------------
@@ -559,9 +616,11 @@ InputFilter::KeystrokeAction::perform(const Event& event)
 	m_events->addEvent(Event(m_events->forIPrimaryScreen().fakeInputBegin(),
 								event.getTarget(), NULL,
 								Event::kDeliverImmediately));
-	m_events->addEvent(Event(type, event.getTarget(), m_keyInfo,
+	Event keyEvent(type, event.getTarget(), m_keyInfo,
 								Event::kDeliverImmediately |
-								Event::kDontFreeData));
+								Event::kDontFreeData);
+	keyEvent.setTime(event.getTime());
+	m_events->addEvent(keyEvent);
 	m_events->addEvent(Event(m_events->forIPrimaryScreen().fakeInputEnd(),
 								event.getTarget(), NULL,
 								Event::kDeliverImmediately));
@@ -636,9 +695,11 @@ InputFilter::MouseButtonAction::perform(const Event& event)
 	// send button
 	Event::Type type = m_press ? m_events->forIPrimaryScreen().buttonDown() :
 								m_events->forIPrimaryScreen().buttonUp();
-	m_events->addEvent(Event(type, event.getTarget(), m_buttonInfo,
+	Event buttonEvent(type, event.getTarget(), m_buttonInfo,
 								Event::kDeliverImmediately |
-								Event::kDontFreeData));
+								Event::kDontFreeData);
+	buttonEvent.setTime(event.getTime());
+	m_events->addEvent(buttonEvent);
 }
 
 const char*
@@ -784,17 +845,23 @@ InputFilter::Rule::disable(PrimaryClient* primaryClient)
 	}
 }
 
-bool
-InputFilter::Rule::handleEvent(const Event& event)
+InputFilter::EFilterStatus
+InputFilter::Rule::match(const Event& event)
 {
 	// NULL condition never matches
 	if (m_condition == NULL) {
-		return false;
+		return kNoMatch;
 	}
 
+	return m_condition->match(event);
+}
+
+bool
+InputFilter::Rule::handleEvent(const Event& event)
+{
 	// match
 	const ActionList* actions;
-	switch (m_condition->match(event)) {
+	switch (match(event)) {
 	default:
 		// not handled
 		return false;
@@ -889,7 +956,8 @@ InputFilter::Rule::getAction(bool onActivation, UInt32 index) const
 // -----------------------------------------------------------------------------
 InputFilter::InputFilter(IEventQueue* events) :
 	m_primaryClient(NULL),
-	m_events(events)
+	m_events(events),
+	m_indexValid(false)
 {
 	// do nothing
 }
@@ -897,7 +965,8 @@ InputFilter::InputFilter(IEventQueue* events) :
 InputFilter::InputFilter(const InputFilter& x) :
 	m_ruleList(x.m_ruleList),
 	m_primaryClient(NULL),
-	m_events(x.m_events)
+	m_events(x.m_events),
+	m_indexValid(false)
 {
 	setPrimaryClient(x.m_primaryClient);
 }
@@ -914,7 +983,8 @@ InputFilter::operator=(const InputFilter& x)
 		PrimaryClient* oldClient = m_primaryClient;
 		setPrimaryClient(NULL);
 
-		m_ruleList = x.m_ruleList;
+		m_ruleList   = x.m_ruleList;
+		m_indexValid = false;
 
 		setPrimaryClient(oldClient);
 	}
@@ -928,6 +998,7 @@ InputFilter::addFilterRule(const Rule& rule)
 	if (m_primaryClient != NULL) {
 		m_ruleList.back().enable(m_primaryClient);
 	}
+	m_indexValid = false;
 }
 
 void
@@ -937,6 +1008,7 @@ InputFilter::removeFilterRule(UInt32 index)
 		m_ruleList[index].disable(m_primaryClient);
 	}
 	m_ruleList.erase(m_ruleList.begin() + index);
+	m_indexValid = false;
 }
 
 InputFilter::Rule&
@@ -977,6 +1049,7 @@ InputFilter::setPrimaryClient(PrimaryClient* client)
 	}
 
 	m_primaryClient = client;
+	m_indexValid    = false;
 
 	if (m_primaryClient != NULL) {
 		m_events->adoptHandler(m_events->forIKeyState().keyDown(),
@@ -1075,16 +1148,104 @@ InputFilter::handleEvent(const Event& event, void*)
 	Event myEvent(event.getType(), this, event.getData(),
 								event.getFlags() | Event::kDontFreeData |
 								Event::kDeliverImmediately);
+	myEvent.setTime(event.getTime());
 
-	// let each rule try to match the event until one does
-	for (RuleList::iterator rule  = m_ruleList.begin();
-							 rule != m_ruleList.end(); ++rule) {
-		if (rule->handleEvent(myEvent)) {
-			// handled
-			return;
-		}
+	// let the first rule that matches the event handle it
+	UInt32 index = findRule(myEvent);
+	if (index < m_ruleList.size() && m_ruleList[index].handleEvent(myEvent)) {
+		// handled
+		return;
 	}
 
 	// not handled so pass through
 	m_events->addEvent(myEvent);
 }
+
+UInt32
+InputFilter::findRule(const Event& event)
+{
+	if (!m_indexValid) {
+		compileIndex();
+	}
+
+	// get the rules with the event's key, if any
+	static const RuleIndices s_noRules;
+	const RuleIndices* keyed = &s_noRules;
+	MatchKey key;
+	if (getEventMatchKey(event, key)) {
+		RuleIndex::const_iterator i = m_ruleIndex.find(key);
+		if (i != m_ruleIndex.end()) {
+			keyed = &i->second;
+		}
+	}
+
+	// try the keyed and unkeyed candidates in rule order.  no other
+	// rule can match so this finds the same rule as trying every rule.
+	RuleIndices::const_iterator i = keyed->begin();
+	RuleIndices::const_iterator j = m_unkeyedRules.begin();
+	while (i != keyed->end() || j != m_unkeyedRules.end()) {
+		UInt32 index;
+		if (j == m_unkeyedRules.end() ||
+			(i != keyed->end() && *i < *j)) {
+			index = *i++;
+		}
+		else {
+			index = *j++;
+		}
+		if (m_ruleList[index].match(event) != kNoMatch) {
+			return index;
+		}
+	}
+
+	return getNumRules();
+}
+
+bool
+InputFilter::getEventMatchKey(const Event& event, MatchKey& key) const
+{
+	Event::Type type = event.getType();
+	if (type == m_events->forIPrimaryScreen().hotKeyDown() ||
+		type == m_events->forIPrimaryScreen().hotKeyUp()) {
+		IPlatformScreen::HotKeyInfo* kinfo =
+			reinterpret_cast<IPlatformScreen::HotKeyInfo*>(event.getData());
+		key = MatchKey(kMatchHotKey, kinfo->m_id, 0);
+		return true;
+	}
+	else if (type == m_events->forIPrimaryScreen().buttonDown() ||
+			 type == m_events->forIPrimaryScreen().buttonUp()) {
+		IPlatformScreen::ButtonInfo* minfo =
+			reinterpret_cast<IPlatformScreen::ButtonInfo*>(event.getData());
+		key = MatchKey(kMatchButton, minfo->m_button,
+							minfo->m_mask & ~s_buttonIgnoreMask);
+		return true;
+	}
+	else if (type == m_events->forServer().connected()) {
+		key = MatchKey(kMatchConnected, 0, 0);
+		return true;
+	}
+	return false;
+}
+
+void
+InputFilter::compileIndex()
+{
+	m_ruleIndex.clear();
+	m_unkeyedRules.clear();
+	for (UInt32 index = 0; index < m_ruleList.size(); ++index) {
+		const Condition* condition = m_ruleList[index].getCondition();
+		if (condition == NULL) {
+			// never matches
+			continue;
+		}
+
+		MatchKey key;
+		if (condition->getMatchKey(key)) {
+			m_ruleIndex[key].push_back(index);
+		}
+		else {
+			m_unkeyedRules.push_back(index);
+		}
+	}
+	m_indexValid = true;
+	LOG((CLOG_DEBUG1 "indexed %d filter rules by %d keys", (int)m_ruleList.size(), (int)m_ruleIndex.size()));
+}
@@ -25,6 +25,7 @@
 #include "base/String.h"
 #include "common/stdmap.h"
 #include "common/stdset.h"
+#include "common/stdvector.h"
 
 class PrimaryClient;
 class Event;
@@ -41,6 +42,28 @@ public:
 		kDeactivate
 	};
 
+	// kinds of events a condition can be indexed by
+	enum EMatchKind {
+		kMatchHotKey,
+		kMatchButton,
+		kMatchConnected
+	};
+
+	// MatchKey -- conditions that have a match key can only match
+	// events with an equal key, which lets the filter index its rules.
+	class MatchKey {
+	public:
+		MatchKey();
+		MatchKey(EMatchKind, UInt32 code, KeyModifierMask mask);
+
+		bool					operator<(const MatchKey&) const;
+
+	public:
+		EMatchKind				m_kind;
+		UInt32					m_code;
+		KeyModifierMask			m_mask;
+	};
+
 	class Condition {
 	public:
 		Condition();
@@ -51,6 +74,10 @@ public:
 
 		virtual EFilterStatus	match(const Event&) = 0;
 
+		// get the key of the events this condition can match.  returns
+		// false if the condition may match any event.
+		virtual bool			getMatchKey(MatchKey&) const;
+
 		virtual void			enablePrimary(PrimaryClient*);
 		virtual void			disablePrimary(PrimaryClient*);
 	};
@@ -69,6 +96,7 @@ public:
 		virtual Condition*		clone() const;
 		virtual String			format() const;
 		virtual EFilterStatus	match(const Event&);
+		virtual bool			getMatchKey(MatchKey&) const;
 		virtual void			enablePrimary(PrimaryClient*);
 		virtual void			disablePrimary(PrimaryClient*);
 
@@ -93,6 +121,7 @@ public:
 		virtual Condition*		clone() const;
 		virtual String			format() const;
 		virtual EFilterStatus	match(const Event&);
+		virtual bool			getMatchKey(MatchKey&) const;
 
 	private:
 		ButtonID				m_button;
@@ -110,6 +139,7 @@ public:
 		virtual Condition*		clone() const;
 		virtual String			format() const;
 		virtual EFilterStatus	match(const Event&);
+		virtual bool			getMatchKey(MatchKey&) const;
 
 	private:
 		String					m_screen;
@@ -284,6 +314,7 @@ public:
 		void			disable(PrimaryClient*);
 
 		// event handling
+		EFilterStatus	match(const Event&);
 		bool			handleEvent(const Event&);
 
 		// convert rule to a string
@@ -321,7 +352,7 @@ public:
 	virtual ~InputFilter();
 
 #ifdef TEST_ENV
-	InputFilter() : m_primaryClient(NULL) { }
+	InputFilter() : m_primaryClient(NULL), m_indexValid(false) { }
 #endif
 
 	InputFilter&		operator=(const InputFilter&);
@@ -332,7 +363,8 @@ public:
 	// remove a rule
 	void				removeFilterRule(UInt32 index);
 
-	// get rule by index
+	// get rule by index.  the rule's condition must not be replaced
+	// through the result;  use removeFilterRule() and addFilterRule().
 	Rule&				getRule(UInt32 index);
 
 	// enable event filtering using the given primary client.  disable
@@ -345,6 +377,10 @@ public:
 	// get number of rules
 	UInt32				getNumRules() const;
 
+	// get the index of the first rule matching \p event, or
+	// getNumRules() if no rule matches.  this uses the rule index.
+	UInt32				findRule(const Event& event);
+
 	//! Compare filters
 	bool				operator==(const InputFilter&) const;
 	//! Compare filters
@@ -354,8 +390,26 @@ private:
 	// event handling
 	void				handleEvent(const Event&, void*);
 
+	// get the match key of \p event.  returns false if no keyed
+	// condition can match the event.
+	bool				getEventMatchKey(const Event&, MatchKey&) const;
+
+	// rebuild the rule index from the rule list
+	void				compileIndex();
+
 private:
+	// indices into m_ruleList, in ascending order
+	typedef std::vector<UInt32> RuleIndices;
+	typedef std::map<MatchKey, RuleIndices> RuleIndex;
+
 	RuleList			m_ruleList;
 	PrimaryClient*		m_primaryClient;
 	IEventQueue*		m_events;
+
+	// rules with a match key indexed by key and the rules that must
+	// be tried against every event.  the index is rebuilt on demand
+	// after the rules or their hotkey registrations change.
+	RuleIndex			m_ruleIndex;
+	RuleIndices			m_unkeyedRules;
+	bool				m_indexValid;
 };
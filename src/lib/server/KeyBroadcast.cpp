@@ -0,0 +1,54 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/KeyBroadcast.h"
+
+#include "synergy/ProtocolUtil.h"
+
+//
+// KeyBroadcast
+//
+
+KeyBroadcast::KeyBroadcast(EType type, KeyID key, KeyModifierMask mask,
+				KeyButton button) :
+	m_type(type),
+	m_key(key),
+	m_mask(mask),
+	m_button(button)
+{
+	// do nothing
+}
+
+const String&
+KeyBroadcast::getMessage(const char* fmt)
+{
+	// formats are string constants so compare by address
+	for (Encodings::const_iterator index = m_encodings.begin();
+								index != m_encodings.end(); ++index) {
+		if (index->m_fmt == fmt) {
+			return index->m_data;
+		}
+	}
+
+	// encode.  extra trailing arguments are ignored by formats that
+	// don't use them.
+	m_encodings.push_back(Encoding());
+	Encoding& encoding = m_encodings.back();
+	encoding.m_fmt = fmt;
+	ProtocolUtil::encodef(encoding.m_data, fmt, m_key, m_mask, m_button);
+	return encoding.m_data;
+}
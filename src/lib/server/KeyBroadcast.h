@@ -0,0 +1,79 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/key_types.h"
+#include "base/String.h"
+#include "common/stdvector.h"
+
+//! Key event sent to several screens
+/*!
+Holds one key event that the server relays to a set of screens, along
+with its wire encodings.  Each protocol message format is encoded at
+most once, the first time a client asks for it, and the bytes are then
+reused for every other client that speaks the same format.
+*/
+class KeyBroadcast {
+public:
+	enum EType { kDown, kUp };
+
+	KeyBroadcast(EType, KeyID, KeyModifierMask, KeyButton);
+
+	//! @name manipulators
+	//@{
+
+	//! Get encoded message
+	/*!
+	Returns the event encoded with the protocol message format \c fmt,
+	which takes the key id, modifier mask and button.  Formats for older
+	protocol versions may omit the trailing button.
+	*/
+	const String&		getMessage(const char* fmt);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get event type
+	EType				getType() const { return m_type; }
+
+	//! Get key id
+	KeyID				getKey() const { return m_key; }
+
+	//! Get modifier mask
+	KeyModifierMask		getMask() const { return m_mask; }
+
+	//! Get physical button
+	KeyButton			getButton() const { return m_button; }
+
+	//@}
+
+private:
+	class Encoding {
+	public:
+		const char*		m_fmt;
+		String			m_data;
+	};
+	typedef std::vector<Encoding> Encodings;
+
+	EType				m_type;
+	KeyID				m_key;
+	KeyModifierMask		m_mask;
+	KeyButton			m_button;
+	Encodings			m_encodings;
+};
@@ -21,6 +21,7 @@
 #include "server/ClientProxy.h"
 #include "server/ClientProxyUnknown.h"
 #include "server/PrimaryClient.h"
+#include "server/KeyBroadcast.h"
 #include "server/ClientListener.h"
 #include "synergy/IPlatformScreen.h"
 #include "synergy/DropHelper.h"
@@ -36,11 +37,12 @@
 #include "net/IDataSocket.h"
 #include "net/IListenSocket.h"
 #include "net/XSocket.h"
-#include "mt/Thread.h"
+#include "mt/ThreadPool.h"
 #include "arch/Arch.h"
 #include "base/TMethodJob.h"
 #include "base/IEventQueue.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
 #include "base/TMethodEventJob.h"
 #include "common/stdexcept.h"
 
@@ -82,15 +84,16 @@ Server::Server(
 	m_switchNeedsControl(false),
 	m_switchNeedsAlt(false),
 	m_relativeMoves(false),
+	m_inputCaptureTime(0.0),
+	m_metricClipboardSize(METRICS->histogram("synergy_clipboard_bytes",
+							"Size of clipboard updates")),
 	m_keyboardBroadcasting(false),
 	m_lockedToScreen(false),
 	m_screen(screen),
 	m_events(events),
-	m_sendFileThread(NULL),
-	m_writeToDropDirThread(NULL),
 	m_ignoreFileTransfer(false),
 	m_enableDragDrop(enableDragDrop),
-	m_getDragInfoThread(NULL),
+	m_gettingDragInfo(false),
 	m_waitDragInfoThread(true)
 {
 	// must have a primary client and it must have a canonical name
@@ -98,20 +101,6 @@ Server::Server(
 	assert(config.isScreen(primaryClient->getName()));
 	assert(m_screen != NULL);
 
-	String primaryName = getName(primaryClient);
-
-	// clear clipboards
-	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-		ClipboardInfo& clipboard   = m_clipboards[id];
-		clipboard.m_clipboardOwner  = primaryName;
-		clipboard.m_clipboardSeqNum = m_seqNum;
-		if (clipboard.m_clipboard.open(0)) {
-			clipboard.m_clipboard.empty();
-			clipboard.m_clipboard.close();
-		}
-		clipboard.m_clipboardData   = clipboard.m_clipboard.marshall();
-	}
-
 	// install event handlers
 	m_events->adoptHandler(Event::kTimer, this,
 							new TMethodEventJob<Server>(this,
@@ -190,11 +179,28 @@ Server::Server(
 								this,
 								new TMethodEventJob<Server>(this,
 									&Server::handleFileRecieveCompletedEvent));
+		m_events->adoptHandler(m_events->forThreadPool().completed(),
+								this,
+								new TMethodEventJob<Server>(this,
+									&Server::handleDragInfoCompletedEvent));
 	}
 
 	// add connection
 	addClient(m_primaryClient);
 
+	// clear clipboards
+	ScreenHandle primaryHandle = m_primaryClient->getScreenHandle();
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		ClipboardInfo& clipboard   = m_clipboards[id];
+		clipboard.m_clipboardOwner  = primaryHandle;
+		clipboard.m_clipboardSeqNum = m_seqNum;
+		if (clipboard.m_clipboard.open(0)) {
+			clipboard.m_clipboard.empty();
+			clipboard.m_clipboard.close();
+		}
+		clipboard.m_clipboardData   = clipboard.m_clipboard.marshall();
+	}
+
 	// set initial configuration
 	setConfig(config);
 
@@ -242,6 +248,9 @@ Server::~Server()
 	m_events->removeHandler(m_events->forIPrimaryScreen().fakeInputEnd(),
 							m_inputFilter);
 	m_events->removeHandler(Event::kTimer, this);
+	if (m_enableDragDrop) {
+		m_events->removeHandler(m_events->forThreadPool().completed(), this);
+	}
 	stopSwitch();
 
 	// force immediate disconnection of secondary clients
@@ -297,10 +306,11 @@ Server::setConfig(const Config& config)
 	m_primaryClient->reconfigure(getActivePrimarySides());
 
 	// tell all (connected) clients about current options
-	for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-		BaseClientProxy* client = index->second;
-		sendOptions(client);
+	for (ScreenTable::const_iterator index = m_screens.begin();
+								index != m_screens.end(); ++index) {
+		if (*index != NULL) {
+			sendOptions(*index);
+		}
 	}
 
 	return true;
@@ -331,6 +341,8 @@ Server::adoptClient(BaseClientProxy* client)
 		return;
 	}
 	LOG((CLOG_NOTE "client \"%s\" has connected", getName(client).c_str()));
+	METRICS->counter("synergy_client_connections_total",
+		"Times a client has connected")->increment();
 
 	// send configuration options to client
 	sendOptions(client);
@@ -379,6 +391,11 @@ Server::getClients(std::vector<String>& list) const
 String
 Server::getName(const BaseClientProxy* client) const
 {
+	// clients in the list have their canonical name cached
+	if (isClient(client)) {
+		return m_screenNames[client->getScreenHandle()];
+	}
+
 	String name = m_config->getCanonicalName(client->getName());
 	if (name.empty()) {
 		name = client->getName();
@@ -386,6 +403,70 @@ Server::getName(const BaseClientProxy* client) const
 	return name;
 }
 
+String
+Server::getName(ScreenHandle handle) const
+{
+	if (handle < m_screenNames.size()) {
+		return m_screenNames[handle];
+	}
+	return String();
+}
+
+bool
+Server::isClient(const BaseClientProxy* client) const
+{
+	ScreenHandle handle = client->getScreenHandle();
+	return (handle < m_screens.size() && m_screens[handle] == client);
+}
+
+void
+Server::getScreenSet(const char* screens, ScreenSet& set) const
+{
+	set.assign(m_screens.size(), false);
+	if (IKeyState::KeyInfo::isDefault(screens)) {
+		return;
+	}
+
+	// all connected screens
+	if (screens[0] == '*') {
+		for (ScreenHandle handle = 0; handle < m_screens.size(); ++handle) {
+			set[handle] = (m_screens[handle] != NULL);
+		}
+		return;
+	}
+
+	// named screens.  names not connected right now are ignored.
+	std::set<String> names;
+	IKeyState::KeyInfo::split(screens, names);
+	for (std::set<String>::const_iterator index = names.begin();
+								index != names.end(); ++index) {
+		ClientList::const_iterator client = m_clients.find(*index);
+		if (client != m_clients.end()) {
+			set[client->second] = true;
+		}
+	}
+}
+
+void
+Server::updateKeyboardBroadcastSet()
+{
+	const char* screens = m_keyboardBroadcastingScreens.c_str();
+	if (IKeyState::KeyInfo::isDefault(screens)) {
+		screens = "*";
+	}
+	getScreenSet(screens, m_keyboardBroadcastingSet);
+}
+
+void
+Server::broadcastKey(KeyBroadcast& key, const ScreenSet& targets)
+{
+	for (ScreenHandle handle = 0; handle < targets.size(); ++handle) {
+		if (targets[handle] && m_screens[handle] != NULL) {
+			m_screens[handle]->keyBroadcast(key);
+		}
+	}
+}
+
 UInt32
 Server::getActivePrimarySides() const
 {
@@ -486,7 +567,8 @@ Server::switchScreen(BaseClientProxy* dst,
 		if (m_active == m_primaryClient) {
 			for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
 				ClipboardInfo& clipboard = m_clipboards[id];
-				if (clipboard.m_clipboardOwner == getName(m_primaryClient)) {
+				if (clipboard.m_clipboardOwner ==
+						m_primaryClient->getScreenHandle()) {
 					onClipboardChanged(m_primaryClient,
 						id, clipboard.m_clipboardSeqNum);
 				}
@@ -621,8 +703,9 @@ Server::getNeighbor(BaseClientProxy* src,
 		ClientList::const_iterator index = m_clients.find(dstName);
 		if (index != m_clients.end()) {
 			LOG((CLOG_DEBUG2 "\"%s\" is on %s of \"%s\" at %f", dstName.c_str(), Config::dirName(dir), srcName.c_str(), t));
-			mapToPixel(index->second, dir, tTmp, x, y);
-			return index->second;
+			BaseClientProxy* dst = m_screens[index->second];
+			mapToPixel(dst, dir, tTmp, x, y);
+			return dst;
 		}
 
 		// skip over unconnected screen
@@ -1176,7 +1259,7 @@ Server::handleShapeChanged(const Event&, void* vclient)
 {
 	// ignore events from unknown clients
 	BaseClientProxy* client = reinterpret_cast<BaseClientProxy*>(vclient);
-	if (m_clientSet.count(client) == 0) {
+	if (!isClient(client)) {
 		return;
 	}
 
@@ -1209,7 +1292,7 @@ Server::handleClipboardGrabbed(const Event& event, void* vclient)
 {
 	// ignore events from unknown clients
 	BaseClientProxy* grabber = reinterpret_cast<BaseClientProxy*>(vclient);
-	if (m_clientSet.count(grabber) == 0) {
+	if (!isClient(grabber)) {
 		return;
 	}
 	const IScreen::ClipboardInfo* info =
@@ -1225,8 +1308,8 @@ Server::handleClipboardGrabbed(const Event& event, void* vclient)
 	}
 
 	// mark screen as owning clipboard
-	LOG((CLOG_INFO "screen \"%s\" grabbed clipboard %d from \"%s\"", getName(grabber).c_str(), info->m_id, clipboard.m_clipboardOwner.c_str()));
-	clipboard.m_clipboardOwner  = getName(grabber);
+	LOG((CLOG_INFO "screen \"%s\" grabbed clipboard %d from \"%s\"", getName(grabber).c_str(), info->m_id, getName(clipboard.m_clipboardOwner).c_str()));
+	clipboard.m_clipboardOwner  = grabber->getScreenHandle();
 	clipboard.m_clipboardSeqNum = info->m_sequenceNumber;
 
 	// clear the clipboard data (since it's not known at this point)
@@ -1238,9 +1321,12 @@ Server::handleClipboardGrabbed(const Event& event, void* vclient)
 
 	// tell all other screens to take ownership of clipboard.  tell the
 	// grabber that it's clipboard isn't dirty.
-	for (ClientList::iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-		BaseClientProxy* client = index->second;
+	for (ScreenTable::const_iterator index = m_screens.begin();
+								index != m_screens.end(); ++index) {
+		BaseClientProxy* client = *index;
+		if (client == NULL) {
+			continue;
+		}
 		if (client == grabber) {
 			client->setClipboardDirty(info->m_id, false);
 		}
@@ -1255,7 +1341,7 @@ Server::handleClipboardChanged(const Event& event, void* vclient)
 {
 	// ignore events from unknown clients
 	BaseClientProxy* sender = reinterpret_cast<BaseClientProxy*>(vclient);
-	if (m_clientSet.count(sender) == 0) {
+	if (!isClient(sender)) {
 		return;
 	}
 	const IScreen::ClipboardInfo* info =
@@ -1268,6 +1354,7 @@ Server::handleKeyDownEvent(const Event& event, void*)
 {
 	IPlatformScreen::KeyInfo* info =
 		reinterpret_cast<IPlatformScreen::KeyInfo*>(event.getData());
+	m_inputCaptureTime = event.getTime();
 	onKeyDown(info->m_key, info->m_mask, info->m_button, info->m_screens);
 }
 
@@ -1276,6 +1363,7 @@ Server::handleKeyUpEvent(const Event& event, void*)
 {
 	IPlatformScreen::KeyInfo* info =
 		 reinterpret_cast<IPlatformScreen::KeyInfo*>(event.getData());
+	m_inputCaptureTime = event.getTime();
 	onKeyUp(info->m_key, info->m_mask, info->m_button, info->m_screens);
 }
 
@@ -1284,6 +1372,7 @@ Server::handleKeyRepeatEvent(const Event& event, void*)
 {
 	IPlatformScreen::KeyInfo* info =
 		reinterpret_cast<IPlatformScreen::KeyInfo*>(event.getData());
+	m_inputCaptureTime = event.getTime();
 	onKeyRepeat(info->m_key, info->m_mask, info->m_count, info->m_button);
 }
 
@@ -1292,6 +1381,7 @@ Server::handleButtonDownEvent(const Event& event, void*)
 {
 	IPlatformScreen::ButtonInfo* info =
 		reinterpret_cast<IPlatformScreen::ButtonInfo*>(event.getData());
+	m_inputCaptureTime = event.getTime();
 	onMouseDown(info->m_button);
 }
 
@@ -1300,6 +1390,7 @@ Server::handleButtonUpEvent(const Event& event, void*)
 {
 	IPlatformScreen::ButtonInfo* info =
 		reinterpret_cast<IPlatformScreen::ButtonInfo*>(event.getData());
+	m_inputCaptureTime = event.getTime();
 	onMouseUp(info->m_button);
 }
 
@@ -1308,6 +1399,7 @@ Server::handleMotionPrimaryEvent(const Event& event, void*)
 {
 	IPlatformScreen::MotionInfo* info =
 		reinterpret_cast<IPlatformScreen::MotionInfo*>(event.getData());
+	m_inputCaptureTime = event.getTime();
 	onMouseMovePrimary(info->m_x, info->m_y);
 }
 
@@ -1316,6 +1408,7 @@ Server::handleMotionSecondaryEvent(const Event& event, void*)
 {
 	IPlatformScreen::MotionInfo* info =
 		reinterpret_cast<IPlatformScreen::MotionInfo*>(event.getData());
+	m_inputCaptureTime = event.getTime();
 	onMouseMoveSecondary(info->m_x, info->m_y);
 }
 
@@ -1324,6 +1417,7 @@ Server::handleWheelEvent(const Event& event, void*)
 {
 	IPlatformScreen::WheelInfo* info =
 		reinterpret_cast<IPlatformScreen::WheelInfo*>(event.getData());
+	m_inputCaptureTime = event.getTime();
 	onMouseWheel(info->m_xDelta, info->m_yDelta);
 }
 
@@ -1392,7 +1486,7 @@ Server::handleSwitchToScreenEvent(const Event& event, void*)
 		LOG((CLOG_DEBUG1 "screen \"%s\" not active", info->m_screen));
 	}
 	else {
-		jumpToScreen(index->second);
+		jumpToScreen(m_screens[index->second]);
 	}
 }
 
@@ -1441,6 +1535,7 @@ Server::handleKeyboardBroadcastEvent(const Event& event, void*)
 		info->m_screens != m_keyboardBroadcastingScreens) {
 		m_keyboardBroadcasting        = newState;
 		m_keyboardBroadcastingScreens = info->m_screens;
+		updateKeyboardBroadcastSet();
 		LOG((CLOG_DEBUG "keyboard broadcasting %s: %s", m_keyboardBroadcasting ? "on" : "off", m_keyboardBroadcastingScreens.c_str()));
 	}
 }
@@ -1503,6 +1598,12 @@ Server::handleFileRecieveCompletedEvent(const Event& event, void*)
 	onFileRecieveCompleted();
 }
 
+void
+Server::handleDragInfoCompletedEvent(const Event&, void*)
+{
+	m_gettingDragInfo = false;
+}
+
 void
 Server::onClipboardChanged(BaseClientProxy* sender,
 				ClipboardID id, UInt32 seqNum)
@@ -1516,7 +1617,7 @@ Server::onClipboardChanged(BaseClientProxy* sender,
 	}
 
 	// should be the expected client
-	assert(sender == m_clients.find(clipboard.m_clipboardOwner)->second);
+	assert(sender->getScreenHandle() == clipboard.m_clipboardOwner);
 
 	// get data
 	sender->getClipboard(id, &clipboard.m_clipboard);
@@ -1524,19 +1625,22 @@ Server::onClipboardChanged(BaseClientProxy* sender,
 	// ignore if data hasn't changed
 	String data = clipboard.m_clipboard.marshall();
 	if (data == clipboard.m_clipboardData) {
-		LOG((CLOG_DEBUG "ignored screen \"%s\" update of clipboard %d (unchanged)", clipboard.m_clipboardOwner.c_str(), id));
+		LOG((CLOG_DEBUG "ignored screen \"%s\" update of clipboard %d (unchanged)", getName(sender).c_str(), id));
 		return;
 	}
 
 	// got new data
-	LOG((CLOG_INFO "screen \"%s\" updated clipboard %d", clipboard.m_clipboardOwner.c_str(), id));
+	LOG((CLOG_INFO "screen \"%s\" updated clipboard %d", getName(sender).c_str(), id));
 	clipboard.m_clipboardData = data;
+	m_metricClipboardSize->observe(static_cast<UInt32>(data.size()));
 
 	// tell all clients except the sender that the clipboard is dirty
-	for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-		BaseClientProxy* client = index->second;
-		client->setClipboardDirty(id, client != sender);
+	for (ScreenTable::const_iterator index = m_screens.begin();
+								index != m_screens.end(); ++index) {
+		BaseClientProxy* client = *index;
+		if (client != NULL) {
+			client->setClipboardDirty(id, client != sender);
+		}
 	}
 
 	// send the new clipboard to the active screen
@@ -1591,10 +1695,12 @@ Server::onScreensaver(bool activated)
 	}
 
 	// send message to all clients
-	for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-		BaseClientProxy* client = index->second;
-		client->screensaver(activated);
+	for (ScreenTable::const_iterator index = m_screens.begin();
+								index != m_screens.end(); ++index) {
+		BaseClientProxy* client = *index;
+		if (client != NULL) {
+			client->screensaver(activated);
+		}
 	}
 }
 
@@ -1610,17 +1716,14 @@ Server::onKeyDown(KeyID id, KeyModifierMask mask, KeyButton button,
 		m_active->keyDown(id, mask, button);
 	}
 	else {
+		KeyBroadcast key(KeyBroadcast::kDown, id, mask, button);
 		if (!screens && m_keyboardBroadcasting) {
-			screens = m_keyboardBroadcastingScreens.c_str();
-			if (IKeyState::KeyInfo::isDefault(screens)) {
-				screens = "*";
-			}
+			broadcastKey(key, m_keyboardBroadcastingSet);
 		}
-		for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-			if (IKeyState::KeyInfo::contains(screens, index->first)) {
-				index->second->keyDown(id, mask, button);
-			}
+		else {
+			ScreenSet targets;
+			getScreenSet(screens, targets);
+			broadcastKey(key, targets);
 		}
 	}
 }
@@ -1637,17 +1740,14 @@ Server::onKeyUp(KeyID id, KeyModifierMask mask, KeyButton button,
 		m_active->keyUp(id, mask, button);
 	}
 	else {
+		KeyBroadcast key(KeyBroadcast::kUp, id, mask, button);
 		if (!screens && m_keyboardBroadcasting) {
-			screens = m_keyboardBroadcastingScreens.c_str();
-			if (IKeyState::KeyInfo::isDefault(screens)) {
-				screens = "*";
-			}
+			broadcastKey(key, m_keyboardBroadcastingSet);
 		}
-		for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-			if (IKeyState::KeyInfo::contains(screens, index->first)) {
-				index->second->keyUp(id, mask, button);
-			}
+		else {
+			ScreenSet targets;
+			getScreenSet(screens, targets);
+			broadcastKey(key, targets);
 		}
 	}
 }
@@ -1779,16 +1879,18 @@ Server::onMouseMovePrimary(SInt32 x, SInt32 y)
 			&& m_screen->isDraggingStarted()
 			&& m_active != newScreen
 			&& m_waitDragInfoThread) {
-			if (m_getDragInfoThread == NULL) {
-				m_getDragInfoThread = new Thread(
+			if (!m_gettingDragInfo) {
+				m_gettingDragInfo = true;
+				ThreadPool::getInstance()->run(
 					new TMethodJob<Server>(
 						this,
-						&Server::getDragInfoThread));
+						&Server::getDragInfoThread),
+					this);
 			}
 			return false;
 		}
 		
-		if (m_getDragInfoThread == NULL) {
+		if (!m_gettingDragInfo) {
 			// switch screen
 			switchScreen(newScreen, x, y, false);
 
@@ -1827,7 +1929,6 @@ Server::getDragInfoThread(void*)
 #endif
 
 	m_waitDragInfoThread = false;
-	m_getDragInfoThread = NULL;
 }
 
 void
@@ -2036,9 +2137,9 @@ void
 Server::onFileRecieveCompleted()
 {
 	if (isReceivedFileSizeValid()) {
-		m_writeToDropDirThread = new Thread(
-									   new TMethodJob<Server>(
-															   this, &Server::writeToDropDirThread));
+		ThreadPool::getInstance()->run(
+			new TMethodJob<Server>(
+				this, &Server::writeToDropDirThread));
 	}
 }
 
@@ -2063,6 +2164,16 @@ Server::addClient(BaseClientProxy* client)
 		return false;
 	}
 
+	// assign the lowest free handle
+	ScreenHandle handle = 0;
+	while (handle < m_screens.size() && m_screens[handle] != NULL) {
+		++handle;
+	}
+	if (handle == m_screens.size()) {
+		m_screens.push_back(NULL);
+		m_screenNames.push_back(String());
+	}
+
 	// add event handlers
 	m_events->adoptHandler(m_events->forIScreen().shapeChanged(),
 							client->getEventTarget(),
@@ -2078,8 +2189,12 @@ Server::addClient(BaseClientProxy* client)
 								&Server::handleClipboardChanged, client));
 
 	// add to list
-	m_clientSet.insert(client);
-	m_clients.insert(std::make_pair(name, client));
+	m_screens[handle]     = client;
+	m_screenNames[handle] = name;
+	m_clients.insert(std::make_pair(name, handle));
+	client->setScreenHandle(handle);
+	LOG((CLOG_DEBUG1 "screen \"%s\" has handle %d", name.c_str(), handle));
+	updateKeyboardBroadcastSet();
 
 	// initialize client data
 	SInt32 x, y;
@@ -2096,8 +2211,7 @@ bool
 Server::removeClient(BaseClientProxy* client)
 {
 	// return false if not in list
-	ClientSet::iterator i = m_clientSet.find(client);
-	if (i == m_clientSet.end()) {
+	if (!isClient(client)) {
 		return false;
 	}
 
@@ -2109,9 +2223,20 @@ Server::removeClient(BaseClientProxy* client)
 	m_events->removeHandler(m_events->forClientProxy().clipboardChanged(),
 							client->getEventTarget());
 
+	// the handle may be reused so forget clipboard ownership
+	ScreenHandle handle = client->getScreenHandle();
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		if (m_clipboards[id].m_clipboardOwner == handle) {
+			m_clipboards[id].m_clipboardOwner = kNoScreenHandle;
+		}
+	}
+
 	// remove from list
-	m_clients.erase(getName(client));
-	m_clientSet.erase(i);
+	m_clients.erase(m_screenNames[handle]);
+	m_screens[handle] = NULL;
+	m_screenNames[handle].erase();
+	client->setScreenHandle(kNoScreenHandle);
+	updateKeyboardBroadcastSet();
 
 	return true;
 }
@@ -2162,7 +2287,7 @@ Server::closeClients(const Config& config)
 	for (ClientList::iterator index = m_clients.begin();
 								index != m_clients.end(); ++index) {
 		if (!config.isCanonicalName(index->first)) {
-			removed.insert(index->second);
+			removed.insert(m_screens[index->second]);
 		}
 	}
 
@@ -2252,7 +2377,7 @@ Server::forceLeaveClient(BaseClientProxy* client)
 Server::ClipboardInfo::ClipboardInfo() :
 	m_clipboard(),
 	m_clipboardData(),
-	m_clipboardOwner(),
+	m_clipboardOwner(kNoScreenHandle),
 	m_clipboardSeqNum(0)
 {
 	// do nothing
@@ -2354,7 +2479,7 @@ Server::isReceivedFileSizeValid()
 void
 Server::sendFileToClient(const char* filename)
 {
-	m_sendFileThread = new Thread(
+	ThreadPool::getInstance()->run(
 		new TMethodJob<Server>(
 			this, &Server::sendFileThread,
 			reinterpret_cast<void*>(const_cast<char*>(filename))));
@@ -2371,8 +2496,6 @@ Server::sendFileThread(void* data)
 	catch (std::runtime_error error) {
 		LOG((CLOG_ERR "failed sending file chunks, error: %s", error.what()));
 	}
-
-	m_sendFileThread = NULL;
 }
 
 void
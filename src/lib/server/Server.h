@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "server/BaseClientProxy.h"
 #include "server/Config.h"
 #include "synergy/clipboard_types.h"
 #include "synergy/Clipboard.h"
@@ -32,14 +33,14 @@
 #include "common/stdset.h"
 #include "common/stdvector.h"
 
-class BaseClientProxy;
 class EventQueueTimer;
+class KeyBroadcast;
 class PrimaryClient;
 class InputFilter;
 namespace synergy { class Screen; }
 class IEventQueue;
-class Thread;
 class ClientListener;
+class MetricHistogram;
 
 //! Synergy server
 /*!
@@ -181,12 +182,41 @@ public:
 	//! Return expected file size
 	size_t				getExpectedFileSize() { return m_expectedFileSize; }
 
+	//! Get input capture time
+	/*!
+	Returns the time, as reported by \c ARCH->time(), at which the input
+	currently being forwarded to the active screen was captured.
+	*/
+	double				getInputCaptureTime() const { return m_inputCaptureTime; }
+
 	//@}
 
 private:
 	// get canonical name of client
 	String				getName(const BaseClientProxy*) const;
 
+	// get canonical name of the client with the given handle, or the
+	// empty string if there isn't one
+	String				getName(ScreenHandle) const;
+
+	// returns true iff \p client is in the client list
+	bool				isClient(const BaseClientProxy* client) const;
+
+	// set of screens indexed by screen handle
+	typedef std::vector<bool> ScreenSet;
+
+	// compile a ":name:name:" screens list (see IKeyState::KeyInfo) into
+	// the set of connected screens it names
+	void				getScreenSet(const char* screens, ScreenSet&) const;
+
+	// recompile the keyboard broadcast target set.  must be called when
+	// the broadcast screens or the connected clients change.
+	void				updateKeyboardBroadcastSet();
+
+	// send \p key to every screen in \p targets
+	void				broadcastKey(KeyBroadcast& key,
+							const ScreenSet& targets);
+
 	// get the sides of the primary screen that have neighbors
 	UInt32				getActivePrimarySides() const;
 
@@ -317,6 +347,7 @@ private:
 	void				handleFakeInputEndEvent(const Event&, void*);
 	void				handleFileChunkSendingEvent(const Event&, void*);
 	void				handleFileRecieveCompletedEvent(const Event&, void*);
+	void				handleDragInfoCompletedEvent(const Event&, void*);
 
 	// event processing
 	void				onClipboardChanged(BaseClientProxy* sender,
@@ -381,18 +412,23 @@ private:
 	public:
 		Clipboard		m_clipboard;
 		String			m_clipboardData;
-		String			m_clipboardOwner;
+		ScreenHandle	m_clipboardOwner;
 		UInt32			m_clipboardSeqNum;
 	};
 
 	// the primary screen client
 	PrimaryClient*		m_primaryClient;
 
-	// all clients (including the primary client) indexed by name
-	typedef std::map<String, BaseClientProxy*> ClientList;
-	typedef std::set<BaseClientProxy*> ClientSet;
+	// all clients (including the primary client) indexed by screen
+	// handle, and their canonical names.  free handles are NULL.
+	// per-event routing works on these;  the name to handle map is
+	// only used where names come in from the configuration.
+	typedef std::vector<BaseClientProxy*> ScreenTable;
+	typedef std::vector<String> ScreenNames;
+	typedef std::map<String, ScreenHandle> ClientList;
+	ScreenTable			m_screens;
+	ScreenNames			m_screenNames;
 	ClientList			m_clients;
-	ClientSet			m_clientSet;
 
 	// all old connections that we're waiting to hangup
 	typedef std::map<BaseClientProxy*, EventQueueTimer*> OldClients;
@@ -453,10 +489,17 @@ private:
 	// relative mouse move option
 	bool				m_relativeMoves;
 
+	// creation time of the input event being handled
+	double				m_inputCaptureTime;
+
+	// size of clipboard updates
+	MetricHistogram*	m_metricClipboardSize;
+
 	// flag whether or not we have broadcasting enabled and the screens to
 	// which we should send broadcasted keys.
 	bool				m_keyboardBroadcasting;
 	String				m_keyboardBroadcastingScreens;
+	ScreenSet			m_keyboardBroadcastingSet;
 
 	// screen locking (former scroll lock)
 	bool				m_lockedToScreen;
@@ -470,13 +513,11 @@ private:
 	size_t				m_expectedFileSize;
 	String				m_receivedFileData;
 	DragFileList		m_dragFileList;
-	Thread*				m_sendFileThread;
-	Thread*				m_writeToDropDirThread;
 	String				m_dragFileExt;
 	bool				m_ignoreFileTransfer;
 	bool				m_enableDragDrop;
 
-	Thread*				m_getDragInfoThread;
+	bool				m_gettingDragInfo;
 	bool				m_waitDragInfoThread;
 
 	ClientListener*		m_clientListener;
@@ -32,6 +32,12 @@
 #include "ipc/IpcMessage.h"
 #include "ipc/Ipc.h"
 #include "base/EventQueue.h"
+#include "mt/Thread.h"
+#include "net/SocketMultiplexer.h"
+#include "net/XSocket.h"
+#include "synergy/MetricsListener.h"
+#include "base/Metrics.h"
+#include "base/Trace.h"
 
 #if SYSAPI_WIN32
 #include "arch/win32/ArchMiscWindows.h"
@@ -52,6 +58,9 @@
 
 App* App::s_instance = nullptr;
 
+// how often metrics are sent to the gui, in seconds
+static const double		s_metricsIpcInterval = 5.0;
+
 //
 // App
 //
@@ -64,7 +73,9 @@ App::App(IEventQueue* events, CreateTaskBarReceiverFunc createTaskBarReceiver, A
 	m_args(args),
 	m_createTaskBarReceiver(createTaskBarReceiver),
 	m_appUtil(events),
-	m_ipcClient(nullptr)
+	m_ipcClient(nullptr),
+	m_metricsListener(NULL),
+	m_metricsTimer(NULL)
 {
 	assert(s_instance == nullptr);
 	s_instance = this;
@@ -236,6 +247,120 @@ App::handleIpcMessage(const Event& e, void*)
     }
 }
 
+void
+App::initInputThreads()
+{
+	initInputThread(Thread::getCurrentThread(), "event");
+	if (m_socketMultiplexer != NULL) {
+		initInputThread(m_socketMultiplexer->getServiceThread(), "socket");
+		for (UInt32 i = 0; i < m_socketMultiplexer->getNumIOThreads(); ++i) {
+			initInputThread(m_socketMultiplexer->getIOThread(i), "socket i/o");
+		}
+	}
+}
+
+void
+App::initMetrics()
+{
+	const ArgsBase& args = argsBase();
+
+	if (args.m_metricsPort > 0) {
+		m_metricsListener = new MetricsListener(
+			m_events, m_socketMultiplexer, args.m_metricsPort);
+		try {
+			m_metricsListener->listen();
+		}
+		catch (XSocket& e) {
+			LOG((CLOG_WARN "cannot serve metrics on port %d: %s",
+				args.m_metricsPort, e.what()));
+			delete m_metricsListener;
+			m_metricsListener = NULL;
+		}
+	}
+
+	if (args.m_enableIpc) {
+		m_metricsTimer = m_events->newTimer(s_metricsIpcInterval, NULL);
+		m_events->adoptHandler(Event::kTimer, m_metricsTimer,
+			new TMethodEventJob<App>(this, &App::handleMetricsTimer));
+	}
+}
+
+void
+App::cleanupMetrics()
+{
+	if (m_metricsTimer != NULL) {
+		m_events->removeHandler(Event::kTimer, m_metricsTimer);
+		m_events->deleteTimer(m_metricsTimer);
+		m_metricsTimer = NULL;
+	}
+
+	delete m_metricsListener;
+	m_metricsListener = NULL;
+}
+
+void
+App::startTracing()
+{
+	if (argsBase().m_traceFile != NULL) {
+		LOG((CLOG_NOTE "recording trace to %s", argsBase().m_traceFile));
+		TRACE->start();
+	}
+}
+
+void
+App::stopTracing()
+{
+	const char* filename = argsBase().m_traceFile;
+	if (filename != NULL) {
+		TRACE->stop();
+		if (TRACE->write(filename)) {
+			LOG((CLOG_NOTE "wrote trace to %s", filename));
+		}
+		else {
+			LOG((CLOG_ERR "failed to write trace to %s", filename));
+		}
+	}
+}
+
+void
+App::handleMetricsTimer(const Event&, void*)
+{
+	if (m_ipcClient != NULL) {
+		m_ipcClient->send(IpcMetricsMessage(METRICS->format()));
+	}
+}
+
+void
+App::initInputThread(Thread thread, const char* name)
+{
+	const ArgsBase& args = argsBase();
+
+	bool realtime = false;
+	if (args.m_inputRealtimePriority > 0) {
+		realtime = thread.setRealtimePriority(args.m_inputRealtimePriority);
+		if (realtime) {
+			LOG((CLOG_DEBUG "%s thread using real-time priority %d", name, args.m_inputRealtimePriority));
+		}
+		else {
+			LOG((CLOG_WARN "real-time priority not permitted for %s thread", name));
+		}
+	}
+	if (!realtime && args.m_inputPriority != 0) {
+		// raising the priority may be silently limited by the system
+		thread.setNice(args.m_inputPriority);
+		LOG((CLOG_DEBUG "%s thread nice level set to %d", name, args.m_inputPriority));
+	}
+
+	if (args.m_inputCPU >= 0) {
+		if (thread.setAffinity(args.m_inputCPU)) {
+			LOG((CLOG_DEBUG "%s thread bound to cpu %d", name, args.m_inputCPU));
+		}
+		else {
+			LOG((CLOG_WARN "cannot bind %s thread to cpu %d", name, args.m_inputCPU));
+		}
+	}
+}
+
 void
 App::runEventsLoop(void*)
 {
@@ -38,6 +38,9 @@ class FileLogOutputter;
 namespace synergy { class Screen; }
 class IEventQueue;
 class SocketMultiplexer;
+class Thread;
+class MetricsListener;
+class EventQueueTimer;
 
 typedef IArchTaskBarReceiver* (*CreateTaskBarReceiverFunc)(const BufferedLogOutputter*, IEventQueue* events);
 
@@ -102,12 +105,29 @@ public:
 
 private:
 	void				handleIpcMessage(const Event&, void*);
+	void				initInputThread(Thread thread, const char* name);
+	void				handleMetricsTimer(const Event&, void*);
 
 protected:
 	void				initIpcClient();
 	void				cleanupIpcClient();
 	void				runEventsLoop(void*);
 
+	// Applies the --input-* scheduling options to the calling thread and
+	// the socket multiplexer thread, which together carry all input.
+	void				initInputThreads();
+
+	// Starts the --metrics-port endpoint and, when using ipc, periodically
+	// sends the metrics to the daemon for the gui.  Must be called after
+	// the node has started, since creating a screen discards pending events.
+	void				initMetrics();
+	void				cleanupMetrics();
+
+	// Records a trace while running if --trace-file was given, and writes
+	// it when stopped.
+	void				startTracing();
+	void				stopTracing();
+
 	IArchTaskBarReceiver* m_taskBarReceiver;
 	bool m_suspended;
 	IEventQueue*		m_events;
@@ -120,6 +140,8 @@ private:
 	ARCH_APP_UTIL m_appUtil;
 	IpcClient*			m_ipcClient;
 	SocketMultiplexer*	m_socketMultiplexer;
+	MetricsListener*	m_metricsListener;
+	EventQueueTimer*	m_metricsTimer;
 };
 
 class MinimalApp : public App {
@@ -163,7 +185,17 @@ private:
 	"*     --restart            restart the server automatically if it fails.\n" \
 	"  -l  --log <file>         write log messages to file.\n" \
 	"      --no-tray            disable the system tray icon.\n" \
-	"      --enable-drag-drop   enable file drag & drop.\n"
+	"      --enable-drag-drop   enable file drag & drop.\n" \
+	"      --input-priority <n> run input threads at nice level n (-20 to 19).\n" \
+	"      --input-realtime <n> run input threads with real-time priority n,\n" \
+	"                             falling back to --input-priority if that's\n" \
+	"                             not permitted.\n" \
+	"      --input-cpu <n>      run input threads only on CPU n.\n" \
+	"      --metrics-port <n>   serve metrics in the Prometheus text format on\n" \
+	"                             localhost port n.\n" \
+	"      --trace-file <file>  record event loop, socket and screen activity\n" \
+	"                             and write it to file in the Chrome trace\n" \
+	"                             format on exit.\n"
 
 #define HELP_COMMON_INFO_2 \
 	"  -h, --help               display this help and exit.\n" \
@@ -52,6 +52,13 @@ ArgParser::parseServerArgs(ServerArgs& args, int argc, const char* const* argv)
 			// save configuration file path
 			args.m_configFile = argv[++i];
 		}
+		else if (isArg(i, argc, argv, NULL, "--io-threads", 1)) {
+			// number of threads to spread client connections across
+			args.m_ioThreads = atoi(argv[++i]);
+			if (args.m_ioThreads < 0) {
+				args.m_ioThreads = 0;
+			}
+		}
 		else {
 			LOG((CLOG_PRINT "%s: unrecognized option `%s'" BYE, args.m_pname, argv[i], args.m_pname));
 			return false;
@@ -283,6 +290,21 @@ ArgParser::parseGenericArgs(int argc, const char* const* argv, int& i)
 	else if (isArg(i, argc, argv, NULL, "--enable-crypto")) {
 		argsBase().m_enableCrypto = true;
 	}
+	else if (isArg(i, argc, argv, NULL, "--input-priority", 1)) {
+		argsBase().m_inputPriority = atoi(argv[++i]);
+	}
+	else if (isArg(i, argc, argv, NULL, "--input-realtime", 1)) {
+		argsBase().m_inputRealtimePriority = atoi(argv[++i]);
+	}
+	else if (isArg(i, argc, argv, NULL, "--input-cpu", 1)) {
+		argsBase().m_inputCPU = atoi(argv[++i]);
+	}
+	else if (isArg(i, argc, argv, NULL, "--metrics-port", 1)) {
+		argsBase().m_metricsPort = atoi(argv[++i]);
+	}
+	else if (isArg(i, argc, argv, NULL, "--trace-file", 1)) {
+		argsBase().m_traceFile = argv[++i];
+	}
 	else if (isArg(i, argc, argv, NULL, "--profile-dir", 1)) {
 		argsBase().m_profileDirectory = argv[++i];
 	}
@@ -44,7 +44,12 @@ m_shouldExit(false),
 m_synergyAddress(),
 m_enableCrypto(false),
 m_profileDirectory(""),
-m_pluginDirectory("")
+m_pluginDirectory(""),
+m_inputPriority(0),
+m_inputRealtimePriority(0),
+m_inputCPU(-1),
+m_metricsPort(0),
+m_traceFile(NULL)
 {
 }
 
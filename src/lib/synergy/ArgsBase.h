@@ -49,4 +49,9 @@ public:
 	bool				m_enableCrypto;
 	String				m_profileDirectory;
 	String				m_pluginDirectory;
+	int					m_inputPriority;
+	int					m_inputRealtimePriority;
+	int					m_inputCPU;
+	int					m_metricsPort;
+	const char*			m_traceFile;
 };
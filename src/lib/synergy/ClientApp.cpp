@@ -26,9 +26,11 @@
 #include "synergy/ClientArgs.h"
 #include "net/NetworkAddress.h"
 #include "net/TCPSocketFactory.h"
+#include "net/UnixSocketFactory.h"
 #include "net/SocketMultiplexer.h"
 #include "net/XSocket.h"
 #include "mt/Thread.h"
+#include "mt/ThreadPool.h"
 #include "arch/IArchTaskBarReceiver.h"
 #include "arch/Arch.h"
 #include "base/String.h"
@@ -61,12 +63,14 @@
 #include <stdio.h>
 
 #define RETRY_TIME 1.0
+#define MAX_RETRY_TIME 8.0
 
 ClientApp::ClientApp(IEventQueue* events, CreateTaskBarReceiverFunc createTaskBarReceiver) :
 	App(events, createTaskBarReceiver, new ClientArgs()),
 	m_client(NULL),
 	m_clientScreen(NULL),
-	m_serverAddress(NULL)
+	m_serverAddress(NULL),
+	m_restartBackoff(RETRY_TIME, MAX_RETRY_TIME)
 {
 }
 
@@ -119,7 +123,7 @@ ClientApp::help()
 #  define WINAPI_INFO
 #endif
 
-	char buffer[2000];
+	char buffer[3000];
 	sprintf(
 		buffer,
 		"Usage: %s"
@@ -142,7 +146,8 @@ ClientApp::help()
 		"\n"
 		"The server address is of the form: [<hostname>][:<port>].  The hostname\n"
 		"must be the address or hostname of the server.  The port overrides the\n"
-		"default port, %d.\n",
+		"default port, %d.  Use unix:<path> to connect to a server on the same\n"
+		"host through a unix domain socket.\n",
 		args().m_pname, kDefaultPort
 	);
 
@@ -204,31 +209,18 @@ ClientApp::updateStatus(const String& msg)
 void
 ClientApp::resetRestartTimeout()
 {
-	// retry time can nolonger be changed
-	//s_retryTime = 0.0;
+	m_restartBackoff.reset();
 }
 
 
 double
-ClientApp::nextRestartTimeout()
+ClientApp::nextRestartTimeout(double retryAfter)
 {
-	// retry at a constant rate (Issue 52)
-	return RETRY_TIME;
-
-	/*
-	// choose next restart timeout.  we start with rapid retries
-	// then slow down.
-	if (s_retryTime < 1.0) {
-	s_retryTime = 1.0;
-	}
-	else if (s_retryTime < 3.0) {
-	s_retryTime = 3.0;
-	}
-	else {
-	s_retryTime = 5.0;
-	}
-	return s_retryTime;
-	*/
+	// the first retry is quick (Issue 52) but retries back off from
+	// there, with jitter, so that when a server restarts its clients
+	// don't all come back at once.  a busy server may ask us to wait
+	// longer.
+	return m_restartBackoff.next(retryAfter);
 }
 
 
@@ -281,7 +273,7 @@ void
 ClientApp::scheduleClientRestart(double retryTime)
 {
 	// install a timer and handler to retry later
-	LOG((CLOG_DEBUG "retry in %.0f seconds", retryTime));
+	LOG((CLOG_DEBUG "retry in %.1f seconds", retryTime));
 	EventQueueTimer* timer = m_events->newOneShotTimer(retryTime, NULL);
 	m_events->adoptHandler(Event::kTimer, timer,
 		new TMethodEventJob<ClientApp>(this, &ClientApp::handleClientRestart, timer));
@@ -311,7 +303,7 @@ ClientApp::handleClientFailed(const Event& e, void*)
 	else {
 		LOG((CLOG_WARN "failed to connect to server: %s", info->m_what.c_str()));
 		if (!m_suspended) {
-			scheduleClientRestart(nextRestartTimeout());
+			scheduleClientRestart(nextRestartTimeout(info->m_retryAfter));
 		}
 	}
 	delete info;
@@ -336,11 +328,19 @@ Client*
 ClientApp::openClient(const String& name, const NetworkAddress& address,
 				synergy::Screen* screen)
 {
+	ISocketFactory* socketFactory;
+	if (address.isUnix()) {
+		socketFactory = new UnixSocketFactory(m_events, getSocketMultiplexer());
+	}
+	else {
+		socketFactory = new TCPSocketFactory(m_events, getSocketMultiplexer());
+	}
+
 	Client* client = new Client(
 		m_events,
 		name,
 		address,
-		new TCPSocketFactory(m_events, getSocketMultiplexer()),
+		socketFactory,
 		screen,
 		args().m_enableDragDrop,
 		args().m_enableCrypto);
@@ -455,7 +455,10 @@ ClientApp::mainLoop()
 	// create socket multiplexer.  this must happen after daemonization
 	// on unix because threads evaporate across a fork().
 	SocketMultiplexer multiplexer;
+	ThreadPool threadPool(m_events);
 	setSocketMultiplexer(&multiplexer);
+	initInputThreads();
+	startTracing();
 
 	// load all available plugins.
 	ARCH->plugin().load();
@@ -470,6 +473,7 @@ ClientApp::mainLoop()
 	if (argsBase().m_enableIpc) {
 		initIpcClient();
 	}
+	initMetrics();
 
 	// init event for all available plugins.
 	ARCH->plugin().initEvent(m_clientScreen->getEventTarget(), m_events);
@@ -504,9 +508,11 @@ ClientApp::mainLoop()
 	updateStatus();
 	LOG((CLOG_NOTE "stopped client"));
 
+	cleanupMetrics();
 	if (argsBase().m_enableIpc) {
 		cleanupIpcClient();
 	}
+	stopTracing();
 
 	// unload all plugins.
 	ARCH->plugin().unload();
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "synergy/App.h"
+#include "base/Backoff.h"
 
 namespace synergy { class Screen; }
 class Event;
@@ -55,7 +56,7 @@ public:
 	void updateStatus();
 	void updateStatus(const String& msg);
 	void resetRestartTimeout();
-	double nextRestartTimeout();
+	double nextRestartTimeout(double retryAfter = 0.0);
 	void handleScreenError(const Event&, void*);
 	synergy::Screen* openClientScreen();
 	void closeClientScreen(synergy::Screen* screen);
@@ -80,4 +81,5 @@ private:
 	Client*			m_client;
 	synergy::Screen*m_clientScreen;
 	NetworkAddress*	m_serverAddress;
+	Backoff			m_restartBackoff;
 };
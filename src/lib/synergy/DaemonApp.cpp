@@ -380,6 +380,11 @@ DaemonApp::handleIpcMessage(const Event& e, void*)
 			break;
 		}
 
+		case kIpcMetrics:
+			// pass node metrics on to the gui
+			m_ipcServer->send(*m, kIpcClientGui);
+			break;
+
 		case kIpcHello:
 			IpcHelloMessage* hm = static_cast<IpcHelloMessage*>(m);
 			String type;
@@ -0,0 +1,212 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/InputLatency.h"
+
+#include "base/Metrics.h"
+#include "arch/Arch.h"
+
+#include <cmath>
+
+// difference a - b of two modular timestamps
+static
+SInt32
+timeDiff(UInt32 a, UInt32 b)
+{
+	return static_cast<SInt32>(a - b);
+}
+
+// a non-negative difference, clamping the effects of clock jitter
+static
+UInt32
+elapsed(UInt32 later, UInt32 earlier)
+{
+	SInt32 d = timeDiff(later, earlier);
+	return (d < 0) ? 0 : static_cast<UInt32>(d);
+}
+
+static
+MetricHistogram*
+stageMetric(const char* stage)
+{
+	return METRICS->histogram("synergy_input_latency_microseconds",
+							"Input latency from capture to injection by stage",
+							Metrics::label("stage", stage));
+}
+
+static
+void
+addSample(Histogram& histogram, MetricHistogram* metric, UInt32 value)
+{
+	histogram.add(value);
+	metric->observe(value);
+}
+
+//
+// InputLatency
+//
+
+InputLatency::InputLatency() :
+	m_numClockSamples(0),
+	m_nextClockSample(0),
+	m_offset(0),
+	m_roundTrip(0),
+	m_metricCaptureToSend(stageMetric("capture_to_send")),
+	m_metricNetwork(stageMetric("network")),
+	m_metricReceiveToInject(stageMetric("receive_to_inject")),
+	m_metricTotal(stageMetric("total"))
+{
+	// do nothing
+}
+
+void
+InputLatency::addClockSample(UInt32 localSend, UInt32 remoteRecv,
+				UInt32 remoteSend, UInt32 localRecv)
+{
+	// time spent on the remote side doesn't count toward the round trip
+	SInt32 roundTrip = timeDiff(localRecv, localSend) -
+						timeDiff(remoteSend, remoteRecv);
+	if (roundTrip < 0) {
+		roundTrip = 0;
+	}
+
+	// halve each difference separately so the sum can't overflow
+	SInt32 offset = timeDiff(remoteRecv, localSend) / 2 +
+					timeDiff(remoteSend, localRecv) / 2;
+
+	m_offsets[m_nextClockSample]    = offset;
+	m_roundTrips[m_nextClockSample] = static_cast<UInt32>(roundTrip);
+	m_nextClockSample = (m_nextClockSample + 1) % kClockSamples;
+	if (m_numClockSamples < kClockSamples) {
+		++m_numClockSamples;
+	}
+
+	// trust the sample with the least queueing delay
+	UInt32 best = 0;
+	for (UInt32 i = 1; i < m_numClockSamples; ++i) {
+		if (m_roundTrips[i] < m_roundTrips[best]) {
+			best = i;
+		}
+	}
+	m_offset    = m_offsets[best];
+	m_roundTrip = m_roundTrips[best];
+}
+
+void
+InputLatency::addInput(UInt32 capture, UInt32 send,
+				UInt32 receive, UInt32 inject)
+{
+	addSample(m_captureToSend, m_metricCaptureToSend,
+							elapsed(send, capture));
+	addSample(m_receiveToInject, m_metricReceiveToInject,
+							elapsed(inject, receive));
+
+	// the network and total stages need both clocks on the same base
+	if (hasClockOffset()) {
+		UInt32 localSend    = send - static_cast<UInt32>(m_offset);
+		UInt32 localCapture = capture - static_cast<UInt32>(m_offset);
+		addSample(m_network, m_metricNetwork,
+							elapsed(receive, localSend));
+		addSample(m_total, m_metricTotal,
+							elapsed(inject, localCapture));
+	}
+}
+
+void
+InputLatency::resetInputs()
+{
+	m_captureToSend.reset();
+	m_network.reset();
+	m_receiveToInject.reset();
+	m_total.reset();
+}
+
+UInt32
+InputLatency::now()
+{
+	return toMicroseconds(ARCH->time());
+}
+
+UInt32
+InputLatency::toMicroseconds(double seconds)
+{
+	return static_cast<UInt32>(fmod(seconds * 1.0e+6, 4294967296.0));
+}
+
+bool
+InputLatency::hasClockOffset() const
+{
+	return (m_numClockSamples != 0);
+}
+
+SInt32
+InputLatency::getClockOffset() const
+{
+	return m_offset;
+}
+
+UInt32
+InputLatency::getRoundTrip() const
+{
+	return m_roundTrip;
+}
+
+const Histogram&
+InputLatency::getCaptureToSend() const
+{
+	return m_captureToSend;
+}
+
+const Histogram&
+InputLatency::getNetwork() const
+{
+	return m_network;
+}
+
+const Histogram&
+InputLatency::getReceiveToInject() const
+{
+	return m_receiveToInject;
+}
+
+const Histogram&
+InputLatency::getTotal() const
+{
+	return m_total;
+}
+
+String
+InputLatency::format() const
+{
+	return synergy::string::sprintf(
+		"%u inputs, "
+		"capture->send p50=%uus p99=%uus max=%uus, "
+		"network p50=%uus p99=%uus max=%uus, "
+		"receive->inject p50=%uus p99=%uus max=%uus, "
+		"total p50=%uus p99=%uus max=%uus, "
+		"clock offset=%dus rtt=%uus",
+		m_captureToSend.getCount(),
+		m_captureToSend.getPercentile(50), m_captureToSend.getPercentile(99),
+		m_captureToSend.getMax(),
+		m_network.getPercentile(50), m_network.getPercentile(99),
+		m_network.getMax(),
+		m_receiveToInject.getPercentile(50), m_receiveToInject.getPercentile(99),
+		m_receiveToInject.getMax(),
+		m_total.getPercentile(50), m_total.getPercentile(99),
+		m_total.getMax(),
+		m_offset, m_roundTrip);
+}
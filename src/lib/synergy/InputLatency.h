@@ -0,0 +1,129 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/Histogram.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+
+class MetricHistogram;
+
+//! End-to-end input latency statistics
+/*!
+Collects the latency of input forwarded from the primary to a secondary
+screen, split into the time spent on the primary between capture and
+send, on the network, and on the secondary between receive and inject.
+Timestamps are microseconds modulo 2^32 on each side's monotonic clock;
+all arithmetic on them is modular so wrap around is harmless as long as
+intervals are shorter than about 35 minutes.
+
+The network stage needs the offset between the two clocks, estimated
+NTP style from kMsgCClockSync round trips.  The sample with the smallest
+round trip out of the last few is trusted since it has the least
+queueing delay.
+
+Every input sample is also recorded in the process wide
+\c synergy_input_latency_microseconds histograms, one per stage, so
+the latency can be queried through the metrics endpoint.
+*/
+class InputLatency {
+public:
+	InputLatency();
+
+	//! @name manipulators
+	//@{
+
+	//! Add a clock synchronization sample
+	/*!
+	\p localSend and \p localRecv are the local times the request was
+	sent and the reply received, \p remoteRecv and \p remoteSend the
+	remote times the request was received and the reply sent.
+	*/
+	void				addClockSample(UInt32 localSend, UInt32 remoteRecv,
+							UInt32 remoteSend, UInt32 localRecv);
+
+	//! Add an input sample
+	/*!
+	\p capture and \p send are remote times, \p receive and \p inject
+	are local times.
+	*/
+	void				addInput(UInt32 capture, UInt32 send,
+							UInt32 receive, UInt32 inject);
+
+	//! Discard input samples
+	/*!
+	Discards the input latency histograms but not the clock offset.
+	*/
+	void				resetInputs();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the current time in microseconds modulo 2^32
+	static UInt32		now();
+
+	//! Convert an \c ARCH->time() value to microseconds modulo 2^32
+	static UInt32		toMicroseconds(double seconds);
+
+	//! Test if the clock offset is known
+	bool				hasClockOffset() const;
+
+	//! Get the estimated remote minus local clock offset in microseconds
+	SInt32				getClockOffset() const;
+
+	//! Get the round trip time of the sample the offset is based on
+	UInt32				getRoundTrip() const;
+
+	//! Get the capture to send histogram (primary side)
+	const Histogram&	getCaptureToSend() const;
+
+	//! Get the send to receive histogram (network)
+	const Histogram&	getNetwork() const;
+
+	//! Get the receive to inject histogram (secondary side)
+	const Histogram&	getReceiveToInject() const;
+
+	//! Get the capture to inject histogram
+	const Histogram&	getTotal() const;
+
+	//! Format a one line summary of the statistics
+	String				format() const;
+
+	//@}
+
+private:
+	enum { kClockSamples = 8 };
+
+	SInt32				m_offsets[kClockSamples];
+	UInt32				m_roundTrips[kClockSamples];
+	UInt32				m_numClockSamples;
+	UInt32				m_nextClockSample;
+	SInt32				m_offset;
+	UInt32				m_roundTrip;
+
+	Histogram			m_captureToSend;
+	Histogram			m_network;
+	Histogram			m_receiveToInject;
+	Histogram			m_total;
+
+	MetricHistogram*	m_metricCaptureToSend;
+	MetricHistogram*	m_metricNetwork;
+	MetricHistogram*	m_metricReceiveToInject;
+	MetricHistogram*	m_metricTotal;
+};
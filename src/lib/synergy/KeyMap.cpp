@@ -26,6 +26,11 @@
 
 namespace synergy {
 
+// maximum number of memoized mapKey results.  the cache is simply
+// flushed when it fills;  typing rarely touches more than a few dozen
+// distinct key/modifier combinations.
+static const size_t		s_maxMapKeyCacheSize = 512;
+
 KeyMap::NameToKeyMap*			KeyMap::s_nameToKeyMap      = NULL;
 KeyMap::NameToModifierMap*		KeyMap::s_nameToModifierMap = NULL;
 KeyMap::KeyToNameMap*			KeyMap::s_keyToNameMap      = NULL;
@@ -54,6 +59,8 @@ KeyMap::~KeyMap()
 void
 KeyMap::swap(KeyMap& x)
 {
+	clearMapKeyCache();
+	x.clearMapKeyCache();
 	m_keyIDMap.swap(x.m_keyIDMap);
 	m_modifierKeys.swap(x.m_modifierKeys);
 	m_halfDuplex.swap(x.m_halfDuplex);
@@ -69,6 +76,8 @@ KeyMap::swap(KeyMap& x)
 void
 KeyMap::addKeyEntry(const KeyItem& item)
 {
+	clearMapKeyCache();
+
 	// ignore kKeyNone
 	if (item.m_id == kKeyNone) {
 		return;
@@ -142,6 +151,8 @@ bool
 KeyMap::addKeyCombinationEntry(KeyID id, SInt32 group,
 				const KeyID* keys, UInt32 numKeys)
 {
+	clearMapKeyCache();
+
 	// disallow kKeyNone
 	if (id == kKeyNone) {
 		return false;
@@ -202,30 +213,36 @@ KeyMap::addKeyCombinationEntry(KeyID id, SInt32 group,
 void
 KeyMap::allowGroupSwitchDuringCompose()
 {
+	clearMapKeyCache();
 	m_composeAcrossGroups = true;
 }
 
 void
 KeyMap::addHalfDuplexButton(KeyButton button)
 {
+	clearMapKeyCache();
 	m_halfDuplex.insert(button);
 }
 
 void
 KeyMap::clearHalfDuplexModifiers()
 {
+	clearMapKeyCache();
 	m_halfDuplexMods.clear();
 }
 
 void
 KeyMap::addHalfDuplexModifier(KeyID key)
 {
+	clearMapKeyCache();
 	m_halfDuplexMods.insert(key);
 }
 
 void
 KeyMap::finish()
 {
+	clearMapKeyCache();
+
 	m_numGroups = findNumGroups();
 
 	// make sure every key has the same number of groups
@@ -241,6 +258,9 @@ KeyMap::finish()
 void
 KeyMap::foreachKey(ForeachKeyCallback cb, void* userData)
 {
+	// the callback may modify the items
+	clearMapKeyCache();
+
 	for (KeyIDMap::iterator i = m_keyIDMap.begin();
 								i != m_keyIDMap.end(); ++i) {
 		KeyGroupTable& groupTable = i->second;
@@ -263,6 +283,59 @@ KeyMap::mapKey(Keystrokes& keys, KeyID id, SInt32 group,
 				KeyModifierMask& currentState,
 				KeyModifierMask desiredMask,
 				bool isAutoRepeat) const
+{
+	// the uncached path may discard everything in keys on failure so
+	// only memoize when starting from an empty list
+	if (!keys.empty()) {
+		return mapKeyUncached(keys, id, group, activeModifiers,
+								currentState, desiredMask, isAutoRepeat);
+	}
+
+	MapKeyCacheKey key;
+	key.m_id           = id;
+	key.m_group        = group;
+	key.m_currentState = currentState;
+	key.m_desiredMask  = desiredMask;
+	key.m_isAutoRepeat = isAutoRepeat;
+	key.m_activeButtons.reserve(activeModifiers.size());
+	for (ModifierToKeys::const_iterator i = activeModifiers.begin();
+								i != activeModifiers.end(); ++i) {
+		key.m_activeButtons.push_back(i->second.m_button);
+	}
+
+	// use the memoized result if the active modifiers match exactly
+	MapKeyCache::const_iterator index = m_mapKeyCache.find(key);
+	if (index != m_mapKeyCache.end() &&
+		index->second.m_activeModifiers == activeModifiers) {
+		const MapKeyCacheEntry& entry = index->second;
+		LOG((CLOG_DEBUG2 "mapKey %04x (%d) with mask %04x, start state: %04x (cached)", id, id, desiredMask, currentState));
+		keys            = entry.m_keys;
+		activeModifiers = entry.m_newModifiers;
+		currentState    = entry.m_newState;
+		return entry.m_item;
+	}
+
+	MapKeyCacheEntry entry;
+	entry.m_activeModifiers = activeModifiers;
+	entry.m_item = mapKeyUncached(keys, id, group, activeModifiers,
+								currentState, desiredMask, isAutoRepeat);
+	entry.m_keys         = keys;
+	entry.m_newModifiers = activeModifiers;
+	entry.m_newState     = currentState;
+
+	if (m_mapKeyCache.size() >= s_maxMapKeyCacheSize) {
+		m_mapKeyCache.clear();
+	}
+	m_mapKeyCache[key] = entry;
+	return entry.m_item;
+}
+
+const KeyMap::KeyItem*
+KeyMap::mapKeyUncached(Keystrokes& keys, KeyID id, SInt32 group,
+				ModifierToKeys& activeModifiers,
+				KeyModifierMask& currentState,
+				KeyModifierMask desiredMask,
+				bool isAutoRepeat) const
 {
 	LOG((CLOG_DEBUG1 "mapKey %04x (%d) with mask %04x, start state: %04x", id, id, desiredMask, currentState));
 
@@ -331,6 +404,12 @@ KeyMap::mapKey(Keystrokes& keys, KeyID id, SInt32 group,
 	return item;
 }
 
+void
+KeyMap::clearMapKeyCache() const
+{
+	m_mapKeyCache.clear();
+}
+
 SInt32
 KeyMap::getNumGroups() const
 {
@@ -1315,6 +1394,32 @@ KeyMap::KeyItem::operator==(const KeyItem& x) const
 }
 
 
+//
+// KeyMap::MapKeyCacheKey
+//
+
+bool
+KeyMap::MapKeyCacheKey::operator<(const MapKeyCacheKey& x) const
+{
+	if (m_id != x.m_id) {
+		return (m_id < x.m_id);
+	}
+	if (m_group != x.m_group) {
+		return (m_group < x.m_group);
+	}
+	if (m_currentState != x.m_currentState) {
+		return (m_currentState < x.m_currentState);
+	}
+	if (m_desiredMask != x.m_desiredMask) {
+		return (m_desiredMask < x.m_desiredMask);
+	}
+	if (m_isAutoRepeat != x.m_isAutoRepeat) {
+		return x.m_isAutoRepeat;
+	}
+	return (m_activeButtons < x.m_activeButtons);
+}
+
+
 //
 // KeyMap::Keystroke
 //
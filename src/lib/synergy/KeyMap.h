@@ -439,6 +439,18 @@ private:
 	// Initialize key name/id maps
 	static void			initKeyNameMaps();
 
+	// does the work of \c mapKey without consulting the cache
+	const KeyItem*		mapKeyUncached(Keystrokes& keys,
+							KeyID id, SInt32 group,
+							ModifierToKeys& activeModifiers,
+							KeyModifierMask& currentState,
+							KeyModifierMask desiredMask,
+							bool isAutoRepeat) const;
+
+	// discards all memoized \c mapKey results.  must be called whenever
+	// the key map changes.
+	void				clearMapKeyCache() const;
+
 	// not implemented
 	KeyMap(const KeyMap&);
 	KeyMap&			operator=(const KeyMap&);
@@ -470,6 +482,32 @@ private:
 	typedef std::map<KeyID, String> KeyToNameMap;
 	typedef std::map<KeyModifierMask, String> ModifierToNameMap;
 
+	// Inputs to \c mapKey that determine its result
+	class MapKeyCacheKey {
+	public:
+		bool			operator<(const MapKeyCacheKey&) const;
+
+	public:
+		KeyID			m_id;
+		SInt32			m_group;
+		KeyModifierMask	m_currentState;
+		KeyModifierMask	m_desiredMask;
+		bool			m_isAutoRepeat;
+		std::vector<KeyButton>	m_activeButtons;
+	};
+
+	// Memoized result of \c mapKey
+	class MapKeyCacheEntry {
+	public:
+		ModifierToKeys	m_activeModifiers;	// active modifiers on entry
+		Keystrokes		m_keys;
+		ModifierToKeys	m_newModifiers;
+		KeyModifierMask	m_newState;
+		const KeyItem*	m_item;
+	};
+
+	typedef std::map<MapKeyCacheKey, MapKeyCacheEntry> MapKeyCache;
+
 	// KeyID info
 	KeyIDMap			m_keyIDMap;
 	SInt32				m_numGroups;
@@ -485,6 +523,9 @@ private:
 	// dummy KeyItem for changing modifiers
 	KeyItem				m_modifierKeyItem;
 
+	// memoized mapKey results
+	mutable MapKeyCache	m_mapKeyCache;
+
 	// parsing/formatting tables
 	static NameToKeyMap*		s_nameToKeyMap;
 	static NameToModifierMap*	s_nameToModifierMap;
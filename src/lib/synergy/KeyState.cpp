@@ -17,6 +17,7 @@
  */
 
 #include "synergy/KeyState.h"
+#include "arch/Arch.h"
 #include "base/Log.h"
 
 #include <cstring>
@@ -448,33 +449,45 @@ KeyState::sendKeyEvent(
 				KeyID key, KeyModifierMask mask,
 				SInt32 count, KeyButton button)
 {
+	// stamp the events with when the key was captured to measure
+	// its latency
+	double time = ARCH->time();
 	if (m_keyMap.isHalfDuplex(key, button)) {
 		if (isAutoRepeat) {
 			// ignore auto-repeat on half-duplex keys
 		}
 		else {
-			m_events->addEvent(Event(m_events->forIKeyState().keyDown(), target,
-							KeyInfo::alloc(key, mask, button, 1)));
-			m_events->addEvent(Event(m_events->forIKeyState().keyUp(), target,
-							KeyInfo::alloc(key, mask, button, 1)));
+			addKeyEvent(m_events->forIKeyState().keyDown(), target,
+							KeyInfo::alloc(key, mask, button, 1), time);
+			addKeyEvent(m_events->forIKeyState().keyUp(), target,
+							KeyInfo::alloc(key, mask, button, 1), time);
 		}
 	}
 	else {
 		if (isAutoRepeat) {
-			m_events->addEvent(Event(m_events->forIKeyState().keyRepeat(), target,
-							 KeyInfo::alloc(key, mask, button, count)));
+			addKeyEvent(m_events->forIKeyState().keyRepeat(), target,
+							KeyInfo::alloc(key, mask, button, count), time);
 		}
 		else if (press) {
-			m_events->addEvent(Event(m_events->forIKeyState().keyDown(), target,
-							KeyInfo::alloc(key, mask, button, 1)));
+			addKeyEvent(m_events->forIKeyState().keyDown(), target,
+							KeyInfo::alloc(key, mask, button, 1), time);
 		}
 		else {
-			m_events->addEvent(Event(m_events->forIKeyState().keyUp(), target,
-							KeyInfo::alloc(key, mask, button, 1)));
+			addKeyEvent(m_events->forIKeyState().keyUp(), target,
+							KeyInfo::alloc(key, mask, button, 1), time);
 		}
 	}
 }
 
+void
+KeyState::addKeyEvent(Event::Type type, void* target,
+				KeyInfo* info, double time)
+{
+	Event event(type, target, info);
+	event.setTime(time);
+	m_events->addEvent(event);
+}
+
 void
 KeyState::updateKeyMap()
 {
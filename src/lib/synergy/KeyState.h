@@ -195,6 +195,10 @@ private:
 	static void			addActiveModifierCB(KeyID id, SInt32 group,
 							synergy::KeyMap::KeyItem& keyItem, void* vcontext);
 
+	// post a key event stamped with the capture time
+	void				addKeyEvent(Event::Type type, void* target,
+							KeyInfo* info, double time);
+
 private:
 	// must be declared before m_keyMap. used when this class owns the key map.
 	synergy::KeyMap*			m_keyMapPtr;
@@ -0,0 +1,168 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/MetricsListener.h"
+
+#include "net/IDataSocket.h"
+#include "base/IEventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "base/Event.h"
+#include "base/Log.h"
+#include "base/Metrics.h"
+
+// requests larger than this are answered without waiting for the end
+// of the headers
+static const size_t		s_maxRequestSize = 8192;
+
+//
+// MetricsListener
+//
+
+MetricsListener::MetricsListener(IEventQueue* events,
+				SocketMultiplexer* socketMultiplexer, int port) :
+	m_socket(events, socketMultiplexer),
+	m_address(NetworkAddress("127.0.0.1", port)),
+	m_events(events)
+{
+	m_address.resolve();
+
+	m_events->adoptHandler(
+		m_events->forIListenSocket().connecting(), &m_socket,
+		new TMethodEventJob<MetricsListener>(
+		this, &MetricsListener::handleClientConnecting));
+}
+
+MetricsListener::~MetricsListener()
+{
+	m_events->removeHandler(m_events->forIListenSocket().connecting(), &m_socket);
+
+	while (!m_sockets.empty()) {
+		removeSocket(m_sockets.begin()->first);
+	}
+}
+
+void
+MetricsListener::listen()
+{
+	m_socket.bind(m_address);
+	LOG((CLOG_NOTE "serving metrics on %s:%d",
+		m_address.getHostname().c_str(), m_address.getPort()));
+}
+
+void
+MetricsListener::handleClientConnecting(const Event&, void*)
+{
+	IDataSocket* socket = m_socket.accept();
+	if (socket == NULL) {
+		return;
+	}
+
+	LOG((CLOG_DEBUG1 "accepted metrics connection"));
+	m_sockets[socket] = String();
+
+	void* target = socket->getEventTarget();
+	m_events->adoptHandler(m_events->forIStream().inputReady(), target,
+		new TMethodEventJob<MetricsListener>(
+		this, &MetricsListener::handleInputReady, socket));
+	m_events->adoptHandler(m_events->forIStream().outputFlushed(), target,
+		new TMethodEventJob<MetricsListener>(
+		this, &MetricsListener::handleOutputFlushed, socket));
+	m_events->adoptHandler(m_events->forIStream().inputShutdown(), target,
+		new TMethodEventJob<MetricsListener>(
+		this, &MetricsListener::handleDisconnected, socket));
+	m_events->adoptHandler(m_events->forIStream().outputError(), target,
+		new TMethodEventJob<MetricsListener>(
+		this, &MetricsListener::handleDisconnected, socket));
+	m_events->adoptHandler(m_events->forISocket().disconnected(), target,
+		new TMethodEventJob<MetricsListener>(
+		this, &MetricsListener::handleDisconnected, socket));
+}
+
+void
+MetricsListener::handleInputReady(const Event&, void* vsocket)
+{
+	IDataSocket* socket = static_cast<IDataSocket*>(vsocket);
+	SocketMap::iterator i = m_sockets.find(socket);
+	if (i == m_sockets.end()) {
+		return;
+	}
+
+	char buffer[1024];
+	UInt32 n;
+	while ((n = socket->read(buffer, sizeof(buffer))) > 0) {
+		i->second.append(buffer, n);
+	}
+
+	// answer once the request headers are complete.  the request line
+	// isn't checked so the endpoint works with anything from curl to a
+	// bare netcat.
+	const String& request = i->second;
+	if (request.find("\r\n\r\n") != String::npos ||
+		request.find("\n\n") != String::npos ||
+		request.size() >= s_maxRequestSize) {
+		sendMetrics(socket);
+	}
+}
+
+void
+MetricsListener::handleOutputFlushed(const Event&, void* vsocket)
+{
+	removeSocket(static_cast<IDataSocket*>(vsocket));
+}
+
+void
+MetricsListener::handleDisconnected(const Event&, void* vsocket)
+{
+	removeSocket(static_cast<IDataSocket*>(vsocket));
+}
+
+void
+MetricsListener::sendMetrics(IDataSocket* socket)
+{
+	String body = METRICS->format();
+	String response =
+		"HTTP/1.0 200 OK\r\n"
+		"Content-Type: text/plain; version=0.0.4\r\n"
+		"Connection: close\r\n"
+		"\r\n";
+	response += body;
+
+	// stop reading; the connection is closed once the output drains
+	m_events->removeHandler(m_events->forIStream().inputReady(),
+		socket->getEventTarget());
+	socket->write(response.data(), static_cast<UInt32>(response.size()));
+}
+
+void
+MetricsListener::removeSocket(IDataSocket* socket)
+{
+	SocketMap::iterator i = m_sockets.find(socket);
+	if (i == m_sockets.end()) {
+		return;
+	}
+	m_sockets.erase(i);
+
+	void* target = socket->getEventTarget();
+	m_events->removeHandler(m_events->forIStream().inputReady(), target);
+	m_events->removeHandler(m_events->forIStream().outputFlushed(), target);
+	m_events->removeHandler(m_events->forIStream().inputShutdown(), target);
+	m_events->removeHandler(m_events->forIStream().outputError(), target);
+	m_events->removeHandler(m_events->forISocket().disconnected(), target);
+	delete socket;
+
+	LOG((CLOG_DEBUG1 "closed metrics connection"));
+}
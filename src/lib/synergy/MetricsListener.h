@@ -0,0 +1,71 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "net/TCPListenSocket.h"
+#include "net/NetworkAddress.h"
+#include "base/String.h"
+#include "common/stdmap.h"
+
+class Event;
+class IDataSocket;
+class IEventQueue;
+class SocketMultiplexer;
+
+//! Metrics endpoint
+/*!
+Serves the contents of the metrics registry to local scrapers.  Each
+connection may send an HTTP request; once the request headers have been
+read the metrics are written in the Prometheus text format and the
+connection is closed.  Only connections on the loopback interface are
+accepted.
+*/
+class MetricsListener {
+public:
+	MetricsListener(IEventQueue* events,
+							SocketMultiplexer* socketMultiplexer, int port);
+	~MetricsListener();
+
+	//! @name manipulators
+	//@{
+
+	//! Start listening
+	/*!
+	Throws \c XSocket if the port can't be bound.
+	*/
+	void				listen();
+
+	//@}
+
+private:
+	void				handleClientConnecting(const Event&, void*);
+	void				handleInputReady(const Event&, void*);
+	void				handleOutputFlushed(const Event&, void*);
+	void				handleDisconnected(const Event&, void*);
+	void				sendMetrics(IDataSocket*);
+	void				removeSocket(IDataSocket*);
+
+private:
+	// maps each connection to the request read from it so far
+	typedef std::map<IDataSocket*, String> SocketMap;
+
+	TCPListenSocket		m_socket;
+	NetworkAddress		m_address;
+	SocketMap			m_sockets;
+	IEventQueue*		m_events;
+};
@@ -20,6 +20,7 @@
 #include "base/IEventQueue.h"
 #include "mt/Lock.h"
 #include "base/TMethodEventJob.h"
+#include "base/Metrics.h"
 
 #include <cstring>
 #include <memory>
@@ -32,14 +33,32 @@ PacketStreamFilter::PacketStreamFilter(IEventQueue* events, synergy::IStream* st
 	StreamFilter(events, stream, adoptStream),
 	m_size(0),
 	m_inputShutdown(false),
-	m_events(events)
+	m_events(events),
+	m_metricBytesIn(NULL),
+	m_metricBytesOut(NULL)
 {
 	// do nothing
 }
 
 PacketStreamFilter::~PacketStreamFilter()
 {
-	// do nothing
+	if (m_metricBytesIn != NULL || m_metricBytesOut != NULL) {
+		METRICS->release(m_metricLabels);
+	}
+}
+
+void
+PacketStreamFilter::setMetrics(const String& labels,
+				MetricCounter* bytesIn, MetricCounter* bytesOut)
+{
+	assert(m_metricBytesIn == NULL && m_metricBytesOut == NULL);
+
+	if (bytesIn != NULL || bytesOut != NULL) {
+		METRICS->retain(labels);
+	}
+	m_metricLabels   = labels;
+	m_metricBytesIn  = bytesIn;
+	m_metricBytesOut = bytesOut;
 }
 
 void
@@ -102,6 +121,10 @@ PacketStreamFilter::write(const void* buffer, UInt32 count)
 
 	// write the payload
 	getStream()->write(buffer, count);
+
+	if (m_metricBytesOut != NULL) {
+		m_metricBytesOut->increment(sizeof(length) + count);
+	}
 }
 
 void
@@ -160,6 +183,9 @@ PacketStreamFilter::readMore()
 	UInt32 n = getStream()->read(buffer, sizeof(buffer));
 	while (n > 0) {
 		m_buffer.write(buffer, n);
+		if (m_metricBytesIn != NULL) {
+			m_metricBytesIn->increment(n);
+		}
 		n = getStream()->read(buffer, sizeof(buffer));
 	}
 
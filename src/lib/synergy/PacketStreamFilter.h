@@ -21,8 +21,10 @@
 #include "io/StreamFilter.h"
 #include "io/StreamBuffer.h"
 #include "mt/Mutex.h"
+#include "base/String.h"
 
 class IEventQueue;
+class MetricCounter;
 
 //! Packetizing stream filter 
 /*!
@@ -33,6 +35,17 @@ public:
 	PacketStreamFilter(IEventQueue* events, synergy::IStream* stream, bool adoptStream = true);
 	~PacketStreamFilter();
 
+	//! Count traffic into metrics
+	/*!
+	Bytes read and written through the filter, including packet headers,
+	are added to \p bytesIn and \p bytesOut, which must be series with
+	\p labels.  The filter holds \p labels (see \c Metrics::retain())
+	until it's destroyed so the series go away with the last filter
+	counting into them.  This may only be called once.
+	*/
+	void				setMetrics(const String& labels,
+							MetricCounter* bytesIn, MetricCounter* bytesOut);
+
 	// IStream overrides
 	virtual void		close();
 	virtual UInt32		read(void* buffer, UInt32 n);
@@ -56,4 +69,7 @@ private:
 	StreamBuffer		m_buffer;
 	bool				m_inputShutdown;
 	IEventQueue*		m_events;
+	String				m_metricLabels;
+	MetricCounter*		m_metricBytesIn;
+	MetricCounter*		m_metricBytesOut;
 };
@@ -44,6 +44,27 @@ ProtocolUtil::writef(synergy::IStream* stream, const char* fmt, ...)
 	va_end(args);
 }
 
+void
+ProtocolUtil::encodef(String& buffer, const char* fmt, ...)
+{
+	assert(fmt != NULL);
+	LOG((CLOG_DEBUG2 "encodef(%s)", fmt));
+
+	va_list args;
+	va_start(args, fmt);
+	UInt32 size = getLength(fmt, args);
+	va_end(args);
+
+	buffer.resize(size);
+	if (size == 0) {
+		return;
+	}
+
+	va_start(args, fmt);
+	writef(&buffer[0], fmt, args);
+	va_end(args);
+}
+
 bool
 ProtocolUtil::readf(synergy::IStream* stream, const char* fmt, ...)
 {
@@ -20,6 +20,7 @@
 
 #include "io/XIO.h"
 #include "base/EventTypes.h"
+#include "base/String.h"
 
 #include <stdarg.h>
 
@@ -53,6 +54,14 @@ public:
 	static void			writef(synergy::IStream*,
 							const char* fmt, ...);
 
+	//! Encode formatted data
+	/*!
+	Same as writef() but stores the encoded bytes in \c buffer instead
+	of writing them to a stream.  Useful when the same message is sent
+	to several streams.
+	*/
+	static void			encodef(String& buffer, const char* fmt, ...);
+
 	//! Read formatted data
 	/*!
 	Read formatted binary data from a buffer.  This performs the
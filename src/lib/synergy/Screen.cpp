@@ -20,6 +20,7 @@
 #include "synergy/IPlatformScreen.h"
 #include "synergy/protocol_types.h"
 #include "base/Log.h"
+#include "base/Trace.h"
 #include "base/IEventQueue.h"
 #include "server/ClientProxy.h"
 #include "base/TMethodEventJob.h"
@@ -115,6 +116,7 @@ Screen::enter(KeyModifierMask toggleMask)
 	// now on screen
 	m_entered = true;
 
+	TraceSpan span("screen", "enter");
 	m_screen->enter();
 	if (m_isPrimary) {
 		enterPrimary();
@@ -130,6 +132,7 @@ Screen::leave()
 	assert(m_entered == true);
 	LOG((CLOG_INFO "leaving screen"));
 
+	TraceSpan span("screen", "leave");
 	if (!m_screen->leave()) {
 		return false;
 	}
@@ -160,12 +163,14 @@ void
 Screen::warpCursor(SInt32 x, SInt32 y)
 {
 	assert(m_isPrimary);
+	TraceSpan span("screen", "warpCursor");
 	m_screen->warpCursor(x, y);
 }
 
 void
 Screen::setClipboard(ClipboardID id, const IClipboard* clipboard)
 {
+	TraceSpan span("screen", "setClipboard");
 	m_screen->setClipboard(id, clipboard);
 }
 
@@ -198,6 +203,7 @@ Screen::keyDown(KeyID id, KeyModifierMask mask, KeyButton button)
 			return;
 		}
 	}
+	TraceSpan span("screen", "fakeKeyDown");
 	m_screen->fakeKeyDown(id, mask, button);
 }
 
@@ -206,24 +212,28 @@ Screen::keyRepeat(KeyID id,
 				KeyModifierMask mask, SInt32 count, KeyButton button)
 {
 	assert(!m_isPrimary);
+	TraceSpan span("screen", "fakeKeyRepeat");
 	m_screen->fakeKeyRepeat(id, mask, count, button);
 }
 
 void
 Screen::keyUp(KeyID, KeyModifierMask, KeyButton button)
 {
+	TraceSpan span("screen", "fakeKeyUp");
 	m_screen->fakeKeyUp(button);
 }
 
 void
 Screen::mouseDown(ButtonID button)
 {
+	TraceSpan span("screen", "fakeMouseButton");
 	m_screen->fakeMouseButton(button, true);
 }
 
 void
 Screen::mouseUp(ButtonID button)
 {
+	TraceSpan span("screen", "fakeMouseButton");
 	m_screen->fakeMouseButton(button, false);
 }
 
@@ -231,6 +241,7 @@ void
 Screen::mouseMove(SInt32 x, SInt32 y)
 {
 	assert(!m_isPrimary);
+	TraceSpan span("screen", "fakeMouseMove");
 	m_screen->fakeMouseMove(x, y);
 }
 
@@ -238,6 +249,7 @@ void
 Screen::mouseRelativeMove(SInt32 dx, SInt32 dy)
 {
 	assert(!m_isPrimary);
+	TraceSpan span("screen", "fakeMouseRelativeMove");
 	m_screen->fakeMouseRelativeMove(dx, dy);
 }
 
@@ -245,6 +257,7 @@ void
 Screen::mouseWheel(SInt32 xDelta, SInt32 yDelta)
 {
 	assert(!m_isPrimary);
+	TraceSpan span("screen", "fakeMouseWheel");
 	m_screen->fakeMouseWheel(xDelta, yDelta);
 }
 
@@ -356,6 +369,7 @@ Screen::fakeInputEnd()
 	assert(m_fakeInput);
 
 	m_fakeInput = false;
+	TraceSpan span("screen", "fakeInputEnd");
 	m_screen->fakeInputEnd();
 }
 
@@ -475,6 +489,7 @@ Screen::getEventTarget() const
 bool
 Screen::getClipboard(ClipboardID id, IClipboard* clipboard) const
 {
+	TraceSpan span("screen", "getClipboard");
 	return m_screen->getClipboard(id, clipboard);
 }
 
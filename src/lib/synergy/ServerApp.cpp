@@ -29,7 +29,9 @@
 #include "synergy/ServerArgs.h"
 #include "net/SocketMultiplexer.h"
 #include "net/TCPSocketFactory.h"
+#include "net/UnixSocketFactory.h"
 #include "net/XSocket.h"
+#include "mt/ThreadPool.h"
 #include "arch/Arch.h"
 #include "base/EventQueue.h"
 #include "base/log_outputters.h"
@@ -120,12 +122,13 @@ ServerApp::help()
 #  define WINAPI_INFO
 #endif
 
-	char buffer[2000];
+	char buffer[3000];
 	sprintf(
 		buffer,
 		"Usage: %s"
 		" [--address <address>]"
 		" [--config <pathname>]"
+		" [--io-threads <count>]"
 		WINAPI_ARGS
 		HELP_SYS_ARGS
 		HELP_COMMON_ARGS
@@ -134,6 +137,8 @@ ServerApp::help()
 		"\n"
 		"  -a, --address <address>  listen for clients on the given address.\n"
 		"  -c, --config <pathname>  use the named configuration file instead.\n"
+		"      --io-threads <count> service client connections on <count>\n"
+		"                             threads instead of one (*0).\n"
 		HELP_COMMON_INFO_1
 		WINAPI_INFO
 		HELP_SYS_INFO
@@ -144,7 +149,8 @@ ServerApp::help()
 		"The argument for --address is of the form: [<hostname>][:<port>].  The\n"
 		"hostname must be the address or hostname of an interface on the system.\n"
 		"The default is to listen on all interfaces.  The port overrides the\n"
-		"default port, %d.\n"
+		"default port, %d.  Use unix:<path> to listen on a unix domain socket\n"
+		"for clients on the same host.\n"
 		"\n"
 		"If no configuration file pathname is provided then the first of the\n"
 		"following to load successfully sets the configuration:\n"
@@ -630,11 +636,27 @@ ServerApp::handleResume(const Event&, void*)
 ClientListener*
 ServerApp::openClientListener(const NetworkAddress& address)
 {
+	ISocketFactory* socketFactory;
+	if (address.isUnix()) {
+		socketFactory = new UnixSocketFactory(m_events, getSocketMultiplexer());
+	}
+	else {
+		socketFactory = new TCPSocketFactory(m_events, getSocketMultiplexer());
+	}
+
+	bool secure = false;
+	if (args().m_enableCrypto) {
+		secure = TCPSocketFactory::isSecureAvailable();
+		if (!secure) {
+			LOG((CLOG_NOTE "crypto disabled because of ns plugin not available"));
+		}
+	}
+
 	ClientListener* listen = new ClientListener(
 		address,
-		new TCPSocketFactory(m_events, getSocketMultiplexer()),
+		socketFactory,
 		m_events,
-		args().m_enableCrypto);
+		secure);
 	
 	m_events->adoptHandler(
 		m_events->forClientListener().connected(), listen,
@@ -682,7 +704,11 @@ ServerApp::mainLoop()
 	// create socket multiplexer.  this must happen after daemonization
 	// on unix because threads evaporate across a fork().
 	SocketMultiplexer multiplexer;
+	ThreadPool threadPool(m_events);
+	multiplexer.setIOThreads(args().m_ioThreads);
 	setSocketMultiplexer(&multiplexer);
+	initInputThreads();
+	startTracing();
 
 	// if configuration has no screens then add this system
 	// as the default
@@ -720,6 +746,7 @@ ServerApp::mainLoop()
 	if (argsBase().m_enableIpc) {
 		initIpcClient();
 	}
+	initMetrics();
 
 	// init event for all available plugins.
 	ARCH->plugin().initEvent(m_serverScreen->getEventTarget(), m_events);
@@ -776,9 +803,11 @@ ServerApp::mainLoop()
 	updateStatus();
 	LOG((CLOG_NOTE "stopped server"));
 
+	cleanupMetrics();
 	if (argsBase().m_enableIpc) {
 		cleanupIpcClient();
 	}
+	stopTracing();
 
 	// unload all plugins.
 	ARCH->plugin().unload();
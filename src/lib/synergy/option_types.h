@@ -67,6 +67,7 @@ static const OptionID	kOptionXTestXineramaUnaware   = OPTION_CODE("XTXU");
 static const OptionID	kOptionScreenPreserveFocus    = OPTION_CODE("SFOC");
 static const OptionID	kOptionRelativeMouseMoves     = OPTION_CODE("MDLT");
 static const OptionID	kOptionWin32KeepForeground    = OPTION_CODE("_KFW");
+static const OptionID	kOptionInputLatency           = OPTION_CODE("ILAT");
 //@}
 
 //! @name Screen switch corner enumeration
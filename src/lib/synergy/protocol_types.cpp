@@ -29,12 +29,14 @@ const char*				kMsgCScreenSaver 	= "CSEC%1i";
 const char*				kMsgCResetOptions	= "CROP";
 const char*				kMsgCInfoAck		= "CIAK";
 const char*				kMsgCKeepAlive		= "CALV";
+const char*				kMsgCClockSync		= "CCLK%4i%4i%4i";
 const char*				kMsgDKeyDown		= "DKDN%2i%2i%2i";
 const char*				kMsgDKeyDown1_0		= "DKDN%2i%2i";
 const char*				kMsgDKeyRepeat		= "DKRP%2i%2i%2i%2i";
 const char*				kMsgDKeyRepeat1_0	= "DKRP%2i%2i%2i";
 const char*				kMsgDKeyUp			= "DKUP%2i%2i%2i";
 const char*				kMsgDKeyUp1_0		= "DKUP%2i%2i";
+const char*				kMsgDInputTime		= "DITM%4i%4i";
 const char*				kMsgDMouseDown		= "DMDN%1i";
 const char*				kMsgDMouseUp		= "DMUP%1i";
 const char*				kMsgDMouseMove		= "DMMV%2i%2i";
@@ -51,3 +53,4 @@ const char*				kMsgEIncompatible	= "EICV%2i%2i";
 const char*				kMsgEBusy 			= "EBSY";
 const char*				kMsgEUnknown		= "EUNK";
 const char*				kMsgEBad			= "EBAD";
+const char*				kMsgERetry			= "ERTY%4i";
@@ -28,9 +28,15 @@
 //       adds horizontal mouse scrolling
 // 1.4:  adds crypto support
 // 1.5:  adds file transfer and removes home brew crypto
+// 1.6:  adds input timestamps and keep alive clock synchronization
 // NOTE: with new version, synergy minor version should increment
 static const SInt16		kProtocolMajorVersion = 1;
-static const SInt16		kProtocolMinorVersion = 5;
+static const SInt16		kProtocolMinorVersion = 6;
+
+// oldest server version a client will talk to.  a client replies to an
+// older (but supported) server with the server's version so it only
+// uses messages both sides understand.
+static const SInt16		kProtocolMinimumMinorVersion = 5;
 
 // default contact port number
 static const UInt16		kDefaultPort = 24800;
@@ -164,6 +170,16 @@ extern const char*		kMsgCInfoAck;
 // defined by an option.
 extern const char*		kMsgCKeepAlive;
 
+// clock synchronization:  primary <-> secondary
+// sent by the secondary along with its reply to kMsgCKeepAlive when
+// input latency measurement is enabled.  $1 = time the secondary sent
+// the request, $2 and $3 are zero.  the primary replies in kind with
+// $1 unchanged, $2 = time the primary received the request and $3 =
+// time the primary sent the reply.  times are microseconds, modulo
+// 2^32, on each side's monotonic clock.  the secondary uses these to
+// estimate the offset between the two clocks.
+extern const char*		kMsgCClockSync;
+
 //
 // data codes
 //
@@ -198,6 +214,13 @@ extern const char*		kMsgDKeyUp;
 // key released 1.0:  same as above but without KeyButton
 extern const char*		kMsgDKeyUp1_0;
 
+// input timestamps:  primary -> secondary
+// sent immediately before a key or mouse message when input latency
+// measurement is enabled.  $1 = time the primary captured the input,
+// $2 = time the primary sent it.  times are microseconds, modulo 2^32,
+// on the primary's monotonic clock.
+extern const char*		kMsgDInputTime;
+
 // mouse button pressed:  primary -> secondary
 // $1 = ButtonID
 extern const char*		kMsgDMouseDown;
@@ -294,6 +317,13 @@ extern const char*		kMsgEUnknown;
 // primary should disconnect after sending this message.
 extern const char*		kMsgEBad;
 
+// too many clients connecting:  primary -> secondary
+// $1 = milliseconds the secondary should wait before connecting again.
+// sent after kMsgHello, and primary disconnects after sending this
+// message.  secondaries that don't know it treat it as a protocol error
+// and retry as usual.
+extern const char*		kMsgERetry;
+
 
 //
 // structures
@@ -0,0 +1,110 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arch/Arch.h"
+#include "mt/Thread.h"
+
+#include "test/global/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#define BUSY_THREADS 8
+#define SLEEP_SAMPLES 50
+#define SLEEP_TIME 0.002
+
+static volatile bool s_busy;
+
+static void*
+spin(void*)
+{
+	volatile unsigned int n = 0;
+	while (s_busy) {
+		++n;
+	}
+	return NULL;
+}
+
+TEST(ArchMultithreadTests, sleep_highPriorityUnderCpuLoad_wakesPromptly)
+{
+	Thread self = Thread::getCurrentThread();
+
+	// not being permitted to raise the priority is fine;  the request
+	// is silently limited to what's allowed.
+	self.setNice(-10);
+
+	s_busy = true;
+	std::vector<ArchThread> threads;
+	for (int i = 0; i < BUSY_THREADS; ++i) {
+		threads.push_back(ARCH->newThread(&spin, NULL));
+	}
+
+	std::vector<double> latency;
+	for (int i = 0; i < SLEEP_SAMPLES; ++i) {
+		double start = ARCH->time();
+		ARCH->sleep(SLEEP_TIME);
+		latency.push_back(ARCH->time() - start - SLEEP_TIME);
+	}
+
+	s_busy = false;
+	for (size_t i = 0; i < threads.size(); ++i) {
+		ARCH->wait(threads[i], -1.0);
+		ARCH->closeThread(threads[i]);
+	}
+	self.setNice(0);
+
+	std::sort(latency.begin(), latency.end());
+	EXPECT_LT(latency[latency.size() / 2], 0.020);
+}
+
+#if defined(__linux__)
+TEST(ArchMultithreadTests, setAffinityOfThread_firstCpu_returnsTrue)
+{
+	// use a thread of our own so the test runner isn't left pinned
+	s_busy = true;
+	ArchThread thread = ARCH->newThread(&spin, NULL);
+
+	EXPECT_TRUE(ARCH->setAffinityOfThread(thread, 0));
+	EXPECT_FALSE(ARCH->setAffinityOfThread(thread, -1));
+
+	s_busy = false;
+	ARCH->wait(thread, -1.0);
+	ARCH->closeThread(thread);
+}
+#endif
+
+TEST(ArchMultithreadTests, waitCondVar_timeout_elapsesOnMonotonicClock)
+{
+	ArchCond cond   = ARCH->newCondVar();
+	ArchMutex mutex = ARCH->newMutex();
+
+	ARCH->lockMutex(mutex);
+	double start = ARCH->time();
+	bool signalled = ARCH->waitCondVar(cond, mutex, 0.05);
+	double elapsed = ARCH->time() - start;
+	ARCH->unlockMutex(mutex);
+
+	ARCH->closeMutex(mutex);
+	ARCH->closeCondVar(cond);
+
+	// spurious wakeups are allowed but a timeout must not return early
+	if (!signalled) {
+		EXPECT_GE(elapsed, 0.045);
+	}
+	EXPECT_LT(elapsed, 1.0);
+	EXPECT_LE(start, ARCH->time());
+}
@@ -39,6 +39,10 @@
 
 #include "test/global/gtest.h"
 
+#if SYSAPI_UNIX
+#	include <unistd.h>
+#endif
+
 #define TEST_IPC_PORT 24802
 
 class IpcTests : public ::testing::Test
@@ -89,6 +93,36 @@ TEST_F(IpcTests, connectToServer)
 	EXPECT_EQ(true, m_connectToServer_hasClientNode);
 }
 
+#if SYSAPI_UNIX
+TEST_F(IpcTests, connectToServer_unixSocket)
+{
+	NetworkAddress address(synergy::string::sprintf(
+		"unix:/tmp/synergy-ipctests-%d.sock", (int)getpid()), 0);
+	address.resolve();
+
+	SocketMultiplexer socketMultiplexer;
+	IpcServer server(&m_events, &socketMultiplexer, address);
+	server.listen();
+	m_connectToServer_server = &server;
+
+	m_events.adoptHandler(
+		m_events.forIpcServer().messageReceived(), &server,
+		new TMethodEventJob<IpcTests>(
+		this, &IpcTests::connectToServer_handleMessageReceived));
+	
+	IpcClient client(&m_events, &socketMultiplexer, address);
+	client.connect();
+	
+	m_events.initQuitTimeout(5);
+	m_events.loop();
+	m_events.removeHandler(m_events.forIpcServer().messageReceived(), &server);
+	m_events.cleanupQuitTimeout();
+	
+	EXPECT_EQ(true, m_connectToServer_helloMessageReceived);
+	EXPECT_EQ(true, m_connectToServer_hasClientNode);
+}
+#endif
+
 TEST_F(IpcTests, sendMessageToServer)
 {
 	SocketMultiplexer socketMultiplexer;
@@ -32,11 +32,15 @@
 #include "net/SocketMultiplexer.h"
 #include "net/NetworkAddress.h"
 #include "net/TCPSocketFactory.h"
+#include "net/IDataSocket.h"
 #include "mt/Thread.h"
+#include "mt/ThreadPool.h"
 #include "base/TMethodEventJob.h"
 #include "base/TMethodJob.h"
 #include "base/Log.h"
+#include "arch/Arch.h"
 #include "common/stdexcept.h"
+#include "common/stdvector.h"
 
 #include "test/global/gtest.h"
 #include <sstream>
@@ -68,9 +72,14 @@ class NetworkTests : public ::testing::Test
 {
 public:
 	NetworkTests() :
+		m_threadPool(&m_events),
 		m_mockData(NULL),
 		m_mockDataSize(0),
-		m_mockFileSize(0)
+		m_mockFileSize(0),
+		m_ticks(0),
+		m_lastTick(0.0),
+		m_maxTickGap(0.0),
+		m_disconnected(0)
 	{
 		m_mockData = newMockData(kMockDataSize);
 		createFile(m_mockFile, kMockFilename, kMockFileSize);
@@ -83,6 +92,10 @@ public:
 	}
 
 	void				sendMockData(void* eventTarget);
+
+	// send mock data from a server whose socket multiplexer has
+	// \p ioThreads I/O threads to a client
+	void				runSendToClient_mockData(UInt32 ioThreads);
 	
 	void				sendToClient_mockData_handleClientConnected(const Event&, void* vlistener);
 	void				sendToClient_mockData_fileRecieveCompleted(const Event&, void*);
@@ -95,16 +108,36 @@ public:
 
 	void				sendToServer_mockFile_handleClientConnected(const Event&, void* vlistener);
 	void				sendToServer_mockFile_fileRecieveCompleted(const Event& event, void*);
+
+	void				stalledHandshakes_handleTick(const Event&, void*);
+	void				stalledHandshakes_handleStop(const Event&, void*);
+	void				stalledHandshakes_handleDisconnected(const Event&, void*);
 	
 public:
 	TestEventQueue		m_events;
+	ThreadPool			m_threadPool;
 	UInt8*				m_mockData;
 	size_t				m_mockDataSize;
 	fstream				m_mockFile;
 	size_t				m_mockFileSize;
+	UInt32				m_ticks;
+	double				m_lastTick;
+	double				m_maxTickGap;
+	UInt32				m_disconnected;
 };
 
 TEST_F(NetworkTests, sendToClient_mockData)
+{
+	runSendToClient_mockData(0);
+}
+
+TEST_F(NetworkTests, sendToClient_mockData_ioThreads)
+{
+	// accepted connections on their own thread
+	runSendToClient_mockData(1);
+}
+
+TEST_F(NetworkTests, sendToClient_mockFile)
 {
 	// server and client
 	NetworkAddress serverAddress(TEST_HOST, TEST_PORT);
@@ -123,7 +156,7 @@ TEST_F(NetworkTests, sendToClient_mockData)
 	m_events.adoptHandler(
 		m_events.forClientListener().connected(), &listener,
 		new TMethodEventJob<NetworkTests>(
-			this, &NetworkTests::sendToClient_mockData_handleClientConnected, &listener));
+			this, &NetworkTests::sendToClient_mockFile_handleClientConnected, &listener));
 
 	ON_CALL(serverConfig, isScreen(_)).WillByDefault(Return(true));
 	ON_CALL(serverConfig, getInputFilter()).WillByDefault(Return(&serverInputFilter));
@@ -145,7 +178,7 @@ TEST_F(NetworkTests, sendToClient_mockData)
 	m_events.adoptHandler(
 		m_events.forIScreen().fileRecieveCompleted(), &client,
 		new TMethodEventJob<NetworkTests>(
-			this, &NetworkTests::sendToClient_mockData_fileRecieveCompleted));
+			this, &NetworkTests::sendToClient_mockFile_fileRecieveCompleted));
 
 	client.connect();
 
@@ -156,13 +189,12 @@ TEST_F(NetworkTests, sendToClient_mockData)
 	m_events.cleanupQuitTimeout();
 }
 
-TEST_F(NetworkTests, sendToClient_mockFile)
+TEST_F(NetworkTests, sendToServer_mockData)
 {
 	// server and client
 	NetworkAddress serverAddress(TEST_HOST, TEST_PORT);
-
 	serverAddress.resolve();
-	
+
 	// server
 	SocketMultiplexer serverSocketMultiplexer;
 	TCPSocketFactory* serverSocketFactory = new TCPSocketFactory(&m_events, &serverSocketMultiplexer);
@@ -171,11 +203,6 @@ TEST_F(NetworkTests, sendToClient_mockFile)
 	NiceMock<MockPrimaryClient> primaryClient;
 	NiceMock<MockConfig> serverConfig;
 	NiceMock<MockInputFilter> serverInputFilter;
-	
-	m_events.adoptHandler(
-		m_events.forClientListener().connected(), &listener,
-		new TMethodEventJob<NetworkTests>(
-			this, &NetworkTests::sendToClient_mockFile_handleClientConnected, &listener));
 
 	ON_CALL(serverConfig, isScreen(_)).WillByDefault(Return(true));
 	ON_CALL(serverConfig, getInputFilter()).WillByDefault(Return(&serverInputFilter));
@@ -193,25 +220,31 @@ TEST_F(NetworkTests, sendToClient_mockFile)
 	ON_CALL(clientScreen, getCursorPos(_, _)).WillByDefault(Invoke(getCursorPos));
 
 	Client client(&m_events, "stub", serverAddress, clientSocketFactory, &clientScreen, true, false);
-		
+	
 	m_events.adoptHandler(
-		m_events.forIScreen().fileRecieveCompleted(), &client,
+		m_events.forClientListener().connected(), &listener,
 		new TMethodEventJob<NetworkTests>(
-			this, &NetworkTests::sendToClient_mockFile_fileRecieveCompleted));
+			this, &NetworkTests::sendToServer_mockData_handleClientConnected, &client));
+
+	m_events.adoptHandler(
+		m_events.forIScreen().fileRecieveCompleted(), &server,
+		new TMethodEventJob<NetworkTests>(
+			this, &NetworkTests::sendToServer_mockData_fileRecieveCompleted));
 
 	client.connect();
 
 	m_events.initQuitTimeout(10);
 	m_events.loop();
 	m_events.removeHandler(m_events.forClientListener().connected(), &listener);
-	m_events.removeHandler(m_events.forIScreen().fileRecieveCompleted(), &client);
+	m_events.removeHandler(m_events.forIScreen().fileRecieveCompleted(), &server);
 	m_events.cleanupQuitTimeout();
 }
 
-TEST_F(NetworkTests, sendToServer_mockData)
+TEST_F(NetworkTests, sendToServer_mockFile)
 {
 	// server and client
 	NetworkAddress serverAddress(TEST_HOST, TEST_PORT);
+
 	serverAddress.resolve();
 
 	// server
@@ -243,12 +276,12 @@ TEST_F(NetworkTests, sendToServer_mockData)
 	m_events.adoptHandler(
 		m_events.forClientListener().connected(), &listener,
 		new TMethodEventJob<NetworkTests>(
-			this, &NetworkTests::sendToServer_mockData_handleClientConnected, &client));
+			this, &NetworkTests::sendToServer_mockFile_handleClientConnected, &client));
 
 	m_events.adoptHandler(
 		m_events.forIScreen().fileRecieveCompleted(), &server,
 		new TMethodEventJob<NetworkTests>(
-			this, &NetworkTests::sendToServer_mockData_fileRecieveCompleted));
+			this, &NetworkTests::sendToServer_mockFile_fileRecieveCompleted));
 
 	client.connect();
 
@@ -259,21 +292,107 @@ TEST_F(NetworkTests, sendToServer_mockData)
 	m_events.cleanupQuitTimeout();
 }
 
-TEST_F(NetworkTests, sendToServer_mockFile)
+TEST_F(NetworkTests, secureListen_stalledHandshakes_timersStillServiced)
+{
+	// needs the network security plugin and the server certificate
+	ARCH->plugin().load();
+	ARCH->plugin().init(Log::getInstance(), Arch::getInstance());
+	String certificate = ARCH->getProfileDirectory();
+#if SYSAPI_WIN32
+	certificate.append("\\");
+#elif SYSAPI_UNIX
+	certificate.append("/");
+#endif
+	certificate.append("Synergy.pem");
+	if (!TCPSocketFactory::isSecureAvailable() ||
+		!ifstream(certificate.c_str()).good()) {
+		LOG((CLOG_NOTE "skipping test, ns plugin or certificate not available"));
+		ARCH->plugin().unload();
+		return;
+	}
+
+	NetworkAddress serverAddress(TEST_HOST, TEST_PORT);
+	serverAddress.resolve();
+
+	SocketMultiplexer serverSocketMultiplexer;
+	TCPSocketFactory* serverSocketFactory = new TCPSocketFactory(&m_events, &serverSocketMultiplexer);
+	ClientListener* listener = new ClientListener(serverAddress, serverSocketFactory, &m_events, true);
+
+	// clients that connect but never start the secure handshake.  the
+	// listener admits only a batch of them and hangs up on the rest;
+	// the admitted ones wait in the handshake until it times out.
+	const size_t kClients = 50;
+	SocketMultiplexer clientSocketMultiplexer;
+	TCPSocketFactory clientSocketFactory(&m_events, &clientSocketMultiplexer);
+	std::vector<IDataSocket*> clients;
+	for (size_t i = 0; i < kClients; ++i) {
+		IDataSocket* client = clientSocketFactory.create(false);
+		m_events.adoptHandler(
+			m_events.forISocket().disconnected(), client->getEventTarget(),
+			new TMethodEventJob<NetworkTests>(
+				this, &NetworkTests::stalledHandshakes_handleDisconnected));
+		client->connect(serverAddress);
+		clients.push_back(client);
+	}
+
+	// the event loop must keep servicing timers while they're waiting
+	EventQueueTimer* tick = m_events.newTimer(0.01, NULL);
+	m_events.adoptHandler(Event::kTimer, tick,
+		new TMethodEventJob<NetworkTests>(
+			this, &NetworkTests::stalledHandshakes_handleTick));
+	EventQueueTimer* stop = m_events.newOneShotTimer(1.0, NULL);
+	m_events.adoptHandler(Event::kTimer, stop,
+		new TMethodEventJob<NetworkTests>(
+			this, &NetworkTests::stalledHandshakes_handleStop));
+
+	m_lastTick = ARCH->time();
+	m_events.initQuitTimeout(10);
+	m_events.loop();
+	m_events.cleanupQuitTimeout();
+	m_events.removeHandler(Event::kTimer, tick);
+	m_events.deleteTimer(tick);
+	m_events.removeHandler(Event::kTimer, stop);
+	m_events.deleteTimer(stop);
+
+	for (size_t i = 0; i < clients.size(); ++i) {
+		m_events.removeHandler(m_events.forISocket().disconnected(),
+							clients[i]->getEventTarget());
+		delete clients[i];
+	}
+	delete listener;
+	ARCH->plugin().unload();
+
+	EXPECT_GT(m_ticks, 50U);
+	EXPECT_LT(m_maxTickGap, 0.25);
+
+	// some clients must still have been in the handshake
+	EXPECT_LT(m_disconnected, kClients);
+}
+
+void
+NetworkTests::runSendToClient_mockData(UInt32 ioThreads)
 {
 	// server and client
 	NetworkAddress serverAddress(TEST_HOST, TEST_PORT);
 
 	serverAddress.resolve();
-
+	
 	// server
 	SocketMultiplexer serverSocketMultiplexer;
+	if (ioThreads > 0) {
+		serverSocketMultiplexer.setIOThreads(ioThreads);
+	}
 	TCPSocketFactory* serverSocketFactory = new TCPSocketFactory(&m_events, &serverSocketMultiplexer);
 	ClientListener listener(serverAddress, serverSocketFactory, &m_events, false);
 	NiceMock<MockScreen> serverScreen;
 	NiceMock<MockPrimaryClient> primaryClient;
 	NiceMock<MockConfig> serverConfig;
 	NiceMock<MockInputFilter> serverInputFilter;
+	
+	m_events.adoptHandler(
+		m_events.forClientListener().connected(), &listener,
+		new TMethodEventJob<NetworkTests>(
+			this, &NetworkTests::sendToClient_mockData_handleClientConnected, &listener));
 
 	ON_CALL(serverConfig, isScreen(_)).WillByDefault(Return(true));
 	ON_CALL(serverConfig, getInputFilter()).WillByDefault(Return(&serverInputFilter));
@@ -291,24 +410,25 @@ TEST_F(NetworkTests, sendToServer_mockFile)
 	ON_CALL(clientScreen, getCursorPos(_, _)).WillByDefault(Invoke(getCursorPos));
 
 	Client client(&m_events, "stub", serverAddress, clientSocketFactory, &clientScreen, true, false);
-	
-	m_events.adoptHandler(
-		m_events.forClientListener().connected(), &listener,
-		new TMethodEventJob<NetworkTests>(
-			this, &NetworkTests::sendToServer_mockFile_handleClientConnected, &client));
-
+		
 	m_events.adoptHandler(
-		m_events.forIScreen().fileRecieveCompleted(), &server,
+		m_events.forIScreen().fileRecieveCompleted(), &client,
 		new TMethodEventJob<NetworkTests>(
-			this, &NetworkTests::sendToServer_mockFile_fileRecieveCompleted));
+			this, &NetworkTests::sendToClient_mockData_fileRecieveCompleted));
 
 	client.connect();
 
 	m_events.initQuitTimeout(10);
 	m_events.loop();
 	m_events.removeHandler(m_events.forClientListener().connected(), &listener);
-	m_events.removeHandler(m_events.forIScreen().fileRecieveCompleted(), &server);
+	m_events.removeHandler(m_events.forIScreen().fileRecieveCompleted(), &client);
 	m_events.cleanupQuitTimeout();
+
+	if (ioThreads > 0) {
+		// only the listen socket stays on the main multiplexer
+		EXPECT_EQ(1U, serverSocketMultiplexer.getNumSockets());
+		EXPECT_EQ(1U, serverSocketMultiplexer.getIOMultiplexer()->getNumSockets());
+	}
 }
 
 void 
@@ -397,6 +517,29 @@ NetworkTests::sendToServer_mockFile_fileRecieveCompleted(const Event& event, voi
 	m_events.raiseQuitEvent();
 }
 
+void
+NetworkTests::stalledHandshakes_handleTick(const Event&, void*)
+{
+	double now = ARCH->time();
+	if (now - m_lastTick > m_maxTickGap) {
+		m_maxTickGap = now - m_lastTick;
+	}
+	m_lastTick = now;
+	++m_ticks;
+}
+
+void
+NetworkTests::stalledHandshakes_handleStop(const Event&, void*)
+{
+	m_events.raiseQuitEvent();
+}
+
+void
+NetworkTests::stalledHandshakes_handleDisconnected(const Event&, void*)
+{
+	++m_disconnected;
+}
+
 void 
 NetworkTests::sendMockData(void* eventTarget)
 {
@@ -0,0 +1,354 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define TEST_ENV
+
+#include "test/global/TestEventQueue.h"
+#include "net/TCPSocket.h"
+#include "net/TCPListenSocket.h"
+#include "net/XSocket.h"
+#include "net/SocketMultiplexer.h"
+#include "net/ISocketMultiplexerJob.h"
+#include "net/NetworkAddress.h"
+#include "arch/Arch.h"
+#include "base/Metrics.h"
+#include "base/TMethodEventJob.h"
+#include "base/Stopwatch.h"
+#include "base/String.h"
+
+#include "test/global/gtest.h"
+
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#if SYSAPI_UNIX
+#	include <unistd.h>
+#endif
+
+#define TEST_PORT 24804
+#define TEST_HOST "127.0.0.1"
+
+const double kReadTimeout = 10.0;
+
+class TCPSocketTests : public ::testing::Test
+{
+public:
+	TCPSocketTests() :
+		m_listen(NULL),
+		m_peer(NULL),
+		m_queued(METRICS->gauge("synergy_socket_output_queue_bytes",
+							"Bytes queued for sending on TCP sockets")),
+		m_count(0)
+	{
+	}
+
+	~TCPSocketTests()
+	{
+		if (m_peer != NULL) {
+			ARCH->closeSocket(m_peer);
+		}
+		if (m_listen != NULL) {
+			ARCH->closeSocket(m_listen);
+		}
+	}
+
+	// connect over loopback.  returns our end and keeps the other end
+	// in m_peer.
+	ArchSocket			connectPair();
+
+	// fill our end's send buffer until the socket would block.  returns
+	// the number of bytes written.
+	size_t				fillSendBuffer(ArchSocket socket);
+
+	// read n bytes from the peer
+	std::vector<UInt8>	readPeer(size_t n);
+
+	// count the events of the given type for target that arrive within
+	// timeout seconds
+	UInt32				countEvents(Event::Type type, void* target,
+							double timeout);
+	void				handleCountedEvent(const Event&, void*);
+	void				handleCountTimeout(const Event&, void*);
+
+public:
+	TestEventQueue		m_events;
+	SocketMultiplexer	m_multiplexer;
+	ArchSocket			m_listen;
+	ArchSocket			m_peer;
+	MetricGauge*		m_queued;
+	UInt32				m_count;
+};
+
+static
+std::vector<UInt8>
+newData(size_t size, UInt8 seed)
+{
+	std::vector<UInt8> data(size);
+	for (size_t i = 0; i < size; ++i) {
+		data[i] = static_cast<UInt8>(i * 7 + seed);
+	}
+	return data;
+}
+
+TEST_F(TCPSocketTests, write_idleSocket_sentWithoutQueueing)
+{
+	TCPSocket socket(&m_events, &m_multiplexer, connectPair());
+	std::vector<UInt8> data = newData(100, 1);
+	SInt64 queued = m_queued->getValue();
+
+	socket.write(&data[0], (UInt32)data.size());
+
+	EXPECT_EQ(queued, m_queued->getValue());
+	EXPECT_TRUE(readPeer(data.size()) == data);
+}
+
+TEST_F(TCPSocketTests, write_largerThanSendBuffer_queuesRemainderInOrder)
+{
+	TCPSocket socket(&m_events, &m_multiplexer, connectPair());
+	std::vector<UInt8> data    = newData(16 * 1024 * 1024, 2);
+	std::vector<UInt8> trailer = newData(100, 3);
+	SInt64 queued = m_queued->getValue();
+
+	// the first write is partly sent directly and the trailer must
+	// queue behind the rest of it
+	socket.write(&data[0], (UInt32)data.size());
+	SInt64 remainder = m_queued->getValue() - queued;
+	socket.write(&trailer[0], (UInt32)trailer.size());
+
+	EXPECT_LT(0, remainder);
+	EXPECT_GT((SInt64)data.size(), remainder);
+	data.insert(data.end(), trailer.begin(), trailer.end());
+	EXPECT_TRUE(readPeer(data.size()) == data);
+	socket.flush();
+	EXPECT_EQ(queued, m_queued->getValue());
+}
+
+TEST_F(TCPSocketTests, write_sendBufferFull_queuesAndSendsLater)
+{
+	ArchSocket archSocket = connectPair();
+	size_t filled = fillSendBuffer(archSocket);
+	TCPSocket socket(&m_events, &m_multiplexer, archSocket);
+	std::vector<UInt8> data = newData(1000, 4);
+	SInt64 queued = m_queued->getValue();
+
+	// the direct send would block so everything is queued
+	socket.write(&data[0], (UInt32)data.size());
+
+	EXPECT_EQ(queued + (SInt64)data.size(), m_queued->getValue());
+	std::vector<UInt8> received = readPeer(filled + data.size());
+	ASSERT_EQ(filled + data.size(), received.size());
+	EXPECT_TRUE(std::equal(data.begin(), data.end(),
+							received.begin() + filled));
+	socket.flush();
+	EXPECT_EQ(queued, m_queued->getValue());
+}
+
+TEST_F(TCPSocketTests, write_sendBufferFull_armsWritabilityInPlace)
+{
+	ArchSocket archSocket = connectPair();
+	size_t filled = fillSendBuffer(archSocket);
+	TCPSocket socket(&m_events, &m_multiplexer, archSocket);
+	UInt32 numSockets = m_multiplexer.getNumSockets();
+	ISocketMultiplexerJob* job = m_multiplexer.getJob(&socket);
+	ASSERT_TRUE(job != NULL);
+	EXPECT_TRUE(job->isReadable());
+	EXPECT_FALSE(job->isWritable());
+
+	// the peer isn't reading so the data stays queued
+	std::vector<UInt8> data = newData(1000, 7);
+	socket.write(&data[0], (UInt32)data.size());
+
+	ASSERT_EQ(job, m_multiplexer.getJob(&socket));
+	EXPECT_TRUE(job->isReadable());
+	EXPECT_TRUE(job->isWritable());
+	EXPECT_EQ(numSockets, m_multiplexer.getNumSockets());
+
+	EXPECT_EQ(filled + data.size(), readPeer(filled + data.size()).size());
+	socket.flush();
+}
+
+TEST_F(TCPSocketTests, serviceConnected_bufferDrained_dropsWritabilityInPlace)
+{
+	ArchSocket archSocket = connectPair();
+	size_t filled = fillSendBuffer(archSocket);
+	TCPSocket socket(&m_events, &m_multiplexer, archSocket);
+	UInt32 numSockets = m_multiplexer.getNumSockets();
+	ISocketMultiplexerJob* job = m_multiplexer.getJob(&socket);
+	std::vector<UInt8> data = newData(1000, 8);
+	socket.write(&data[0], (UInt32)data.size());
+	ASSERT_TRUE(job != NULL);
+	ASSERT_TRUE(job->isWritable());
+
+	// reading lets the multiplexer drain the buffer.  it then stops
+	// waiting for writability right after signalling the flush.
+	EXPECT_EQ(filled + data.size(), readPeer(filled + data.size()).size());
+	socket.flush();
+	Stopwatch timer;
+	while (m_multiplexer.getJob(&socket) == job && job->isWritable() &&
+			timer.getTime() < kReadTimeout) {
+		ARCH->sleep(0.01);
+	}
+
+	ASSERT_EQ(job, m_multiplexer.getJob(&socket));
+	EXPECT_TRUE(job->isReadable());
+	EXPECT_FALSE(job->isWritable());
+	EXPECT_EQ(numSockets, m_multiplexer.getNumSockets());
+}
+
+TEST_F(TCPSocketTests, write_twiceDirectlySent_oneOutputFlushed)
+{
+	TCPSocket socket(&m_events, &m_multiplexer, connectPair());
+	std::vector<UInt8> hello = newData(20, 5);
+	std::vector<UInt8> retry = newData(10, 6);
+
+	// like turning a client away, whose handler for outputFlushed
+	// deletes the stream
+	socket.write(&hello[0], (UInt32)hello.size());
+	socket.write(&retry[0], (UInt32)retry.size());
+
+	EXPECT_EQ(1, countEvents(m_events.forIStream().outputFlushed(),
+							socket.getEventTarget(), 0.5));
+	hello.insert(hello.end(), retry.begin(), retry.end());
+	EXPECT_TRUE(readPeer(hello.size()) == hello);
+}
+
+#if SYSAPI_UNIX
+TEST_F(TCPSocketTests, bind_unixPathIsRegularFile_throwsAndKeepsFile)
+{
+	String path = synergy::string::sprintf(
+		"/tmp/synergy-tcpsockettests-%d.txt", (int)getpid());
+	std::ofstream(path.c_str()) << "notes";
+	NetworkAddress address("unix:" + path, 0);
+	address.resolve();
+	TCPListenSocket listen(&m_events, &m_multiplexer, IArchNetwork::kUNIX);
+
+	EXPECT_THROW(listen.bind(address), XSocketBind);
+
+	EXPECT_EQ(0, access(path.c_str(), F_OK));
+	remove(path.c_str());
+}
+
+TEST_F(TCPSocketTests, close_unixSocketReplaced_keepsNewSocket)
+{
+	String path = synergy::string::sprintf(
+		"/tmp/synergy-tcpsockettests-%d.sock", (int)getpid());
+	NetworkAddress address("unix:" + path, 0);
+	address.resolve();
+	TCPListenSocket first(&m_events, &m_multiplexer, IArchNetwork::kUNIX);
+	first.bind(address);
+
+	// another server takes over the path
+	remove(path.c_str());
+	TCPListenSocket second(&m_events, &m_multiplexer, IArchNetwork::kUNIX);
+	second.bind(address);
+	first.close();
+
+	EXPECT_EQ(0, access(path.c_str(), F_OK));
+	second.close();
+	EXPECT_NE(0, access(path.c_str(), F_OK));
+}
+#endif
+
+ArchSocket
+TCPSocketTests::connectPair()
+{
+	NetworkAddress address(TEST_HOST, TEST_PORT);
+	address.resolve();
+
+	m_listen = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kSTREAM);
+	ARCH->setReuseAddrOnSocket(m_listen, true);
+	ARCH->bindSocket(m_listen, address.getAddress());
+	ARCH->listenOnSocket(m_listen);
+
+	ArchSocket socket = ARCH->newSocket(IArchNetwork::kINET,
+							IArchNetwork::kSTREAM);
+	ARCH->connectSocket(socket, address.getAddress());
+
+	Stopwatch timer;
+	while (m_peer == NULL && timer.getTime() < kReadTimeout) {
+		IArchNetwork::PollEntry pe = { m_listen, IArchNetwork::kPOLLIN, 0 };
+		ARCH->pollSocket(&pe, 1, 0.1);
+		m_peer = ARCH->acceptSocket(m_listen, NULL);
+	}
+	if (m_peer == NULL) {
+		ADD_FAILURE() << "timed out accepting connection";
+	}
+	return socket;
+}
+
+size_t
+TCPSocketTests::fillSendBuffer(ArchSocket socket)
+{
+	std::vector<UInt8> chunk(4096);
+	size_t total = 0;
+	for (;;) {
+		size_t n = ARCH->writeSocket(socket, &chunk[0], chunk.size());
+		if (n == 0) {
+			return total;
+		}
+		total += n;
+	}
+}
+
+std::vector<UInt8>
+TCPSocketTests::readPeer(size_t n)
+{
+	std::vector<UInt8> data(n);
+	size_t received = 0;
+	Stopwatch timer;
+	while (received < n && timer.getTime() < kReadTimeout) {
+		IArchNetwork::PollEntry pe = { m_peer, IArchNetwork::kPOLLIN, 0 };
+		ARCH->pollSocket(&pe, 1, 0.1);
+		received += ARCH->readSocket(m_peer, &data[received], n - received);
+	}
+	data.resize(received);
+	return data;
+}
+
+UInt32
+TCPSocketTests::countEvents(Event::Type type, void* target, double timeout)
+{
+	m_count = 0;
+	m_events.adoptHandler(type, target,
+		new TMethodEventJob<TCPSocketTests>(
+			this, &TCPSocketTests::handleCountedEvent));
+	EventQueueTimer* timer = m_events.newOneShotTimer(timeout, NULL);
+	m_events.adoptHandler(Event::kTimer, timer,
+		new TMethodEventJob<TCPSocketTests>(
+			this, &TCPSocketTests::handleCountTimeout));
+
+	m_events.loop();
+
+	m_events.removeHandler(Event::kTimer, timer);
+	m_events.deleteTimer(timer);
+	m_events.removeHandler(type, target);
+	return m_count;
+}
+
+void
+TCPSocketTests::handleCountedEvent(const Event&, void*)
+{
+	++m_count;
+}
+
+void
+TCPSocketTests::handleCountTimeout(const Event&, void*)
+{
+	m_events.raiseQuitEvent();
+}
@@ -0,0 +1,91 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test/mock/synergy/MockEventQueue.h"
+#include "platform/VirtualScreen.h"
+#include "synergy/Clipboard.h"
+
+#include "test/global/gtest.h"
+
+using ::testing::NiceMock;
+
+TEST(VirtualScreenTests, fakeInput_secondary_recordsInjectedInput)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	VirtualScreen screen(&eventQueue, false, 800, 600);
+
+	screen.fakeMouseMove(10, 20);
+	screen.fakeKeyDown('a', 0, 30);
+	screen.fakeKeyUp(30);
+
+	const VirtualScreen::InputList& input = screen.getInjectedInput();
+	ASSERT_EQ(3U, input.size());
+	EXPECT_EQ(VirtualScreen::Input::kMouseMove, input[0].m_type);
+	EXPECT_EQ(10, input[0].m_x);
+	EXPECT_EQ(20, input[0].m_y);
+	EXPECT_EQ(VirtualScreen::Input::kKeyDown, input[1].m_type);
+	EXPECT_EQ('a', input[1].m_id);
+	EXPECT_EQ(30, input[1].m_button);
+	EXPECT_EQ(VirtualScreen::Input::kKeyUp, input[2].m_type);
+	EXPECT_FALSE(screen.isKeyDown(30));
+
+	SInt32 x, y;
+	screen.getCursorPos(x, y);
+	EXPECT_EQ(10, x);
+	EXPECT_EQ(20, y);
+
+	screen.clearInjectedInput();
+	EXPECT_TRUE(screen.getInjectedInput().empty());
+}
+
+TEST(VirtualScreenTests, setClipboard_data_copiedAndTimed)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	VirtualScreen screen(&eventQueue, false, 800, 600);
+	EXPECT_EQ(0.0, screen.getClipboardTime(kClipboardClipboard));
+
+	Clipboard clipboard;
+	clipboard.open(0);
+	clipboard.add(IClipboard::kText, "synergy rocks!");
+	clipboard.close();
+	screen.setClipboard(kClipboardClipboard, &clipboard);
+
+	Clipboard actual;
+	screen.getClipboard(kClipboardClipboard, &actual);
+	actual.open(0);
+	EXPECT_EQ("synergy rocks!", actual.get(IClipboard::kText));
+	actual.close();
+	EXPECT_LT(0.0, screen.getClipboardTime(kClipboardClipboard));
+	EXPECT_EQ(0.0, screen.getClipboardGrabTime(kClipboardClipboard));
+}
+
+TEST(VirtualScreenTests, setClipboard_null_emptiedAndGrabTimed)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	VirtualScreen screen(&eventQueue, false, 800, 600);
+
+	screen.setClipboard(kClipboardClipboard, NULL);
+
+	Clipboard actual;
+	screen.getClipboard(kClipboardClipboard, &actual);
+	actual.open(0);
+	EXPECT_FALSE(actual.has(IClipboard::kText));
+	actual.close();
+	EXPECT_EQ(0.0, screen.getClipboardTime(kClipboardClipboard));
+	EXPECT_LT(0.0, screen.getClipboardGrabTime(kClipboardClipboard));
+}
@@ -72,6 +72,17 @@ protected:
 	Display* m_display;
 };
 
+// exposes fakeKey() so tests can inject keystrokes directly
+class TestXWindowsKeyState : public XWindowsKeyState
+{
+public:
+	TestXWindowsKeyState(Display* display, bool useXKB,
+		IEventQueue* events, synergy::KeyMap& keyMap) :
+		XWindowsKeyState(display, useXKB, events, keyMap) { }
+
+	using XWindowsKeyState::fakeKey;
+};
+
 TEST_F(XWindowsKeyStateTests, setActiveGroup_pollAndSet_groupIsZero)
 {
 	MockKeyMap keyMap;
@@ -244,3 +255,24 @@ TEST_F(XWindowsKeyStateTests, pollActiveGroup_xkb_areEqual)
 #endif
 }
 
+
+TEST_F(XWindowsKeyStateTests, fakeKey_pressAndRelease_oneRequestPerKeystroke)
+{
+	MockKeyMap keyMap;
+	MockEventQueue eventQueue;
+	TestXWindowsKeyState keyState(
+		m_display, true, &eventQueue, keyMap);
+	KeyCode key = XKeysymToKeycode(m_display, XK_Shift_L);
+	XSync(m_display, False);
+	unsigned long firstRequest = NextRequest(m_display);
+	unsigned long lastReply    = LastKnownRequestProcessed(m_display);
+
+	keyState.fakeKey(synergy::KeyMap::Keystroke(key, true, false, 0));
+	keyState.fakeKey(synergy::KeyMap::Keystroke(key, false, false, 0));
+
+	// each keystroke is a single XTest request and nothing waits on the
+	// server;  the event queue buffer does the flushing.
+	EXPECT_EQ(2, NextRequest(m_display) - firstRequest);
+	EXPECT_EQ(lastReply, LastKnownRequestProcessed(m_display));
+	XSync(m_display, False);
+}
@@ -0,0 +1,41 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/gtest.h"
+
+#include "platform/XWindowsUtil.h"
+#include "synergy/key_types.h"
+
+#define XK_LATIN2
+#define XK_CYRILLIC
+#define XK_GREEK
+#define XK_TECHNICAL
+#include <X11/keysym.h>
+
+TEST(XWindowsUtilTests, mapKeySymToKeyID_tableKeySyms_mapToUnicode)
+{
+	EXPECT_EQ(0x0104, XWindowsUtil::mapKeySymToKeyID(XK_Aogonek));
+	EXPECT_EQ(0x0416, XWindowsUtil::mapKeySymToKeyID(XK_Cyrillic_ZHE));
+	EXPECT_EQ(0x03c9, XWindowsUtil::mapKeySymToKeyID(XK_Greek_omega));
+	EXPECT_EQ(0x221a, XWindowsUtil::mapKeySymToKeyID(XK_radical));
+}
+
+TEST(XWindowsUtilTests, mapKeySymToKeyID_unknownKeySym_returnsNone)
+{
+	EXPECT_EQ(kKeyNone, XWindowsUtil::mapKeySymToKeyID(0x0ff0));
+	EXPECT_EQ(kKeyNone, XWindowsUtil::mapKeySymToKeyID(0x00ffffff));
+}
@@ -0,0 +1,34 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "net/IListenSocket.h"
+
+#include "test/global/gmock.h"
+
+class MockListenSocket : public IListenSocket
+{
+public:
+	MockListenSocket() { }
+	MOCK_METHOD0(accept, IDataSocket*());
+	MOCK_METHOD1(deleteSocket, void(void*));
+	MOCK_METHOD1(bind, void(const NetworkAddress&));
+	MOCK_METHOD0(close, void());
+	MOCK_CONST_METHOD0(getEventTarget, void*());
+};
@@ -61,5 +61,6 @@ public:
 	MOCK_METHOD0(forIKeyState, IKeyStateEvents&());
 	MOCK_METHOD0(forIPrimaryScreen, IPrimaryScreenEvents&());
 	MOCK_METHOD0(forIScreen, IScreenEvents&());
+	MOCK_METHOD0(forThreadPool, ThreadPoolEvents&());
 	MOCK_CONST_METHOD0(waitForReady, void());
 };
@@ -0,0 +1,65 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#if SYSAPI_UNIX
+
+#include "arch/unix/ArchWakeupUnix.h"
+
+#include "test/global/gtest.h"
+
+#include <poll.h>
+
+static
+bool
+isReadable(const ArchWakeupUnix& wakeup)
+{
+	struct pollfd pfd;
+	pfd.fd      = wakeup.getFd();
+	pfd.events  = POLLIN;
+	pfd.revents = 0;
+	return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN) != 0;
+}
+
+TEST(ArchWakeupUnixTests, signal_notSignalled_readable)
+{
+	ArchWakeupUnix wakeup;
+	ASSERT_NE(-1, wakeup.getFd());
+	EXPECT_FALSE(isReadable(wakeup));
+
+	wakeup.signal();
+
+	EXPECT_TRUE(isReadable(wakeup));
+}
+
+TEST(ArchWakeupUnixTests, reset_signalledManyTimes_notReadable)
+{
+	ArchWakeupUnix wakeup;
+	for (int i = 0; i < 1000; ++i) {
+		wakeup.signal();
+	}
+
+	wakeup.reset();
+
+	EXPECT_FALSE(isReadable(wakeup));
+
+	// the next wakeup isn't swallowed by the coalescing
+	wakeup.signal();
+	EXPECT_TRUE(isReadable(wakeup));
+}
+
+#endif
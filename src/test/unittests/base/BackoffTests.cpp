@@ -0,0 +1,73 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/Backoff.h"
+
+#include "test/global/gtest.h"
+
+TEST(BackoffTests, next_repeatedFailures_doublesUpToMaxWithJitter)
+{
+	Backoff backoff(1.0, 8.0);
+	backoff.setSeed(1);
+
+	double expected[] = { 1.0, 2.0, 4.0, 8.0, 8.0, 8.0 };
+	for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+		double delay = backoff.next();
+		EXPECT_GE(delay, expected[i]);
+		EXPECT_LT(delay, 1.5 * expected[i]);
+	}
+}
+
+TEST(BackoffTests, next_hint_waitsAtLeastHint)
+{
+	Backoff backoff(1.0, 8.0);
+	backoff.setSeed(1);
+
+	double delay = backoff.next(3.0);
+	EXPECT_GE(delay, 3.0);
+	EXPECT_LT(delay, 4.5);
+
+	// the hint doesn't change the schedule
+	delay = backoff.next();
+	EXPECT_GE(delay, 2.0);
+	EXPECT_LT(delay, 3.0);
+}
+
+TEST(BackoffTests, next_differentSeeds_spreadOut)
+{
+	Backoff a(1.0, 8.0);
+	Backoff b(1.0, 8.0);
+	a.setSeed(1);
+	b.setSeed(2);
+
+	EXPECT_NE(a.next(), b.next());
+}
+
+TEST(BackoffTests, reset_afterSuccess_startsOverAtMin)
+{
+	Backoff backoff(1.0, 8.0);
+	backoff.next();
+	backoff.next();
+	backoff.next();
+
+	backoff.reset();
+
+	double delay = backoff.next();
+	EXPECT_GE(delay, 1.0);
+	EXPECT_LT(delay, 1.5);
+}
@@ -0,0 +1,50 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Histogram.h"
+
+#include "test/global/gtest.h"
+
+TEST(HistogramTests, getBucketIndex_everyValue_withinBucketBounds)
+{
+	UInt32 values[] = { 0, 1, 3, 4, 7, 8, 9, 100, 1000, 65535, 1000000, 0xffffffff };
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+		UInt32 index = Histogram::getBucketIndex(values[i]);
+		ASSERT_LT(index, (UInt32)Histogram::kNumBuckets);
+		EXPECT_LE(values[i], Histogram::getBucketUpperBound(index));
+		if (index > 0) {
+			EXPECT_GT(values[i], Histogram::getBucketUpperBound(index - 1));
+		}
+	}
+}
+
+TEST(HistogramTests, getPercentile_uniformSamples_approximatesRank)
+{
+	Histogram histogram;
+	for (UInt32 i = 1; i <= 1000; ++i) {
+		histogram.add(i);
+	}
+
+	EXPECT_EQ(1000, histogram.getCount());
+	EXPECT_EQ(1000, histogram.getMax());
+	EXPECT_NEAR(500, histogram.getPercentile(50), 125);
+	EXPECT_NEAR(990, histogram.getPercentile(99), 10);
+	EXPECT_EQ(1000, histogram.getPercentile(100));
+
+	histogram.reset();
+	EXPECT_EQ(0, histogram.getPercentile(50));
+}
@@ -0,0 +1,77 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Metrics.h"
+
+#include "test/global/gtest.h"
+
+TEST(MetricsTests, counter_sameNameAndLabels_returnsSameCounter)
+{
+	String labels = Metrics::label("client", "a");
+	MetricCounter* first = METRICS->counter("test_same_total", "help", labels);
+	MetricCounter* second = METRICS->counter("test_same_total", "help", labels);
+	MetricCounter* other = METRICS->counter("test_same_total", "help",
+							Metrics::label("client", "b"));
+
+	EXPECT_EQ(first, second);
+	EXPECT_NE(first, other);
+}
+
+TEST(MetricsTests, label_specialCharacters_escaped)
+{
+	EXPECT_EQ("client=\"a\\\"b\\\\c\\n\"", Metrics::label("client", "a\"b\\c\n"));
+}
+
+TEST(MetricsTests, format_counterAndHistogram_prometheusText)
+{
+	METRICS->counter("test_format_total", "Things counted.",
+		Metrics::label("client", "x"))->increment(3);
+
+	MetricHistogram* histogram = METRICS->histogram("test_format_micros",
+							"Things timed.");
+	histogram->observe(2);
+	histogram->observe(100);
+
+	String text = METRICS->format();
+	EXPECT_NE(String::npos, text.find(
+		"# HELP test_format_total Things counted.\n"
+		"# TYPE test_format_total counter\n"
+		"test_format_total{client=\"x\"} 3\n"));
+	EXPECT_NE(String::npos, text.find("# TYPE test_format_micros histogram\n"));
+	EXPECT_NE(String::npos, text.find("test_format_micros_bucket{le=\"3\"} 1\n"));
+	EXPECT_NE(String::npos, text.find("test_format_micros_bucket{le=\"+Inf\"} 2\n"));
+	EXPECT_NE(String::npos, text.find("test_format_micros_sum 102\n"));
+	EXPECT_NE(String::npos, text.find("test_format_micros_count 2\n"));
+}
+
+TEST(MetricsTests, release_lastHold_seriesRemoved)
+{
+	String labels = Metrics::label("client", "release");
+	METRICS->retain(labels);
+	METRICS->retain(labels);
+	METRICS->counter("test_release_total", "help", labels)->increment(7);
+	METRICS->counter("test_release_total", "help")->increment();
+
+	METRICS->release(labels);
+	EXPECT_NE(String::npos, METRICS->format().find(
+		"test_release_total{client=\"release\"} 7\n"));
+
+	METRICS->release(labels);
+	String text = METRICS->format();
+	EXPECT_EQ(String::npos, text.find("client=\"release\""));
+	EXPECT_NE(String::npos, text.find("test_release_total 1\n"));
+}
@@ -0,0 +1,78 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Trace.h"
+
+#include "test/global/gtest.h"
+#include <fstream>
+#include <sstream>
+
+TEST(TraceTests, write_recordedSpan_chromeTraceJson)
+{
+	const char* filename = "TraceTests.json";
+
+	TRACE->setThreadName("trace \"test\"");
+	TRACE->start();
+	{
+		TraceSpan span("test", "span");
+	}
+	TRACE->stop();
+	{
+		// not recorded once stopped
+		TraceSpan span("test", "stopped");
+	}
+
+	ASSERT_TRUE(TRACE->write(filename));
+
+	std::ifstream file(filename);
+	std::stringstream json;
+	json << file.rdbuf();
+	file.close();
+	remove(filename);
+
+	EXPECT_EQ(0U, json.str().find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+	EXPECT_NE(std::string::npos, json.str().find(
+		"\"name\":\"thread_name\",\"args\":{\"name\":\"trace \\\"test\\\"\"}}"));
+	EXPECT_NE(std::string::npos, json.str().find("\"cat\":\"test\",\"name\":\"span\"}"));
+	EXPECT_EQ(std::string::npos, json.str().find("\"name\":\"stopped\""));
+}
+
+TEST(TraceTests, write_whileRecording_recordingResumes)
+{
+	const char* filename = "TraceTests.json";
+
+	TRACE->start();
+	TRACE->record("test", "before", 1.0, 2.0);
+	ASSERT_TRUE(TRACE->write(filename));
+	TRACE->record("test", "after", 2.0, 3.0);
+	TRACE->stop();
+
+	// dropped even when called directly
+	TRACE->record("test", "late", 3.0, 4.0);
+
+	ASSERT_TRUE(TRACE->write(filename));
+
+	std::ifstream file(filename);
+	std::stringstream json;
+	json << file.rdbuf();
+	file.close();
+	remove(filename);
+
+	EXPECT_NE(std::string::npos, json.str().find("\"name\":\"before\""));
+	EXPECT_NE(std::string::npos, json.str().find("\"name\":\"after\""));
+	EXPECT_EQ(std::string::npos, json.str().find("\"name\":\"late\""));
+}
@@ -0,0 +1,95 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ipc/IpcLogBuffer.h"
+
+#include "test/global/gtest.h"
+
+TEST(IpcLogBufferTests, take_appendedLines_unframeInOrder)
+{
+	IpcLogBuffer buffer(64);
+	buffer.append("first", 5);
+	buffer.append("", 0);
+	buffer.append("third", 5);
+
+	String frames;
+	EXPECT_EQ(3, buffer.take(frames, 1024));
+	EXPECT_EQ(0, buffer.getNumLines());
+	EXPECT_EQ(0, buffer.getSize());
+
+	std::vector<String> lines;
+	ASSERT_TRUE(IpcLogBuffer::unframe(frames, lines));
+	ASSERT_EQ(3, lines.size());
+	EXPECT_EQ("first", lines[0]);
+	EXPECT_EQ("", lines[1]);
+	EXPECT_EQ("third", lines[2]);
+}
+
+TEST(IpcLogBufferTests, append_full_dropsOldestAcrossWrap)
+{
+	// room for three 8 byte frames, so the fourth and later wrap
+	IpcLogBuffer buffer(30);
+	const char* text[] = { "line0", "line1", "line2", "line3", "line4" };
+	for (int i = 0; i < 5; ++i) {
+		buffer.append(text[i], 5);
+	}
+
+	EXPECT_EQ(2, buffer.takeDropped());
+	EXPECT_EQ(0, buffer.takeDropped());
+	EXPECT_EQ(3, buffer.getNumLines());
+
+	String frames;
+	buffer.take(frames, 1024);
+	std::vector<String> lines;
+	ASSERT_TRUE(IpcLogBuffer::unframe(frames, lines));
+	ASSERT_EQ(3, lines.size());
+	EXPECT_EQ("line2", lines[0]);
+	EXPECT_EQ("line3", lines[1]);
+	EXPECT_EQ("line4", lines[2]);
+}
+
+TEST(IpcLogBufferTests, take_maxSize_stopsOnWholeLine)
+{
+	IpcLogBuffer buffer(256);
+	buffer.append("0123456789", 10);
+	buffer.append("0123456789", 10);
+	buffer.append("0123456789", 10);
+
+	// 14 bytes per frame
+	String frames;
+	EXPECT_EQ(2, buffer.take(frames, 40));
+	EXPECT_EQ(28, frames.size());
+
+	// a line bigger than the limit is still taken on its own
+	frames.clear();
+	EXPECT_EQ(1, buffer.take(frames, 1));
+	EXPECT_EQ(0, buffer.take(frames, 1));
+}
+
+TEST(IpcLogBufferTests, unframe_truncated_fails)
+{
+	IpcLogBuffer buffer(64);
+	buffer.append("hello", 5);
+
+	String frames;
+	buffer.take(frames, 1024);
+	frames.resize(frames.size() - 1);
+
+	std::vector<String> lines;
+	EXPECT_FALSE(IpcLogBuffer::unframe(frames, lines));
+}
@@ -0,0 +1,139 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "mt/ThreadPool.h"
+
+#include "mt/CondVar.h"
+#include "mt/Lock.h"
+#include "mt/Mutex.h"
+#include "base/EventTypes.h"
+#include "base/IJob.h"
+#include "base/TMethodEventJob.h"
+#include "test/global/TestEventQueue.h"
+
+#include "test/global/gtest.h"
+
+// counts how many times it has been run
+class CountingJob : public IJob {
+public:
+	CountingJob(CondVar<int>* count) : m_count(count) { }
+
+	virtual void run()
+	{
+		Lock lock(m_count);
+		*m_count = *m_count + 1;
+		m_count->broadcast();
+	}
+
+private:
+	CondVar<int>*		m_count;
+};
+
+// throws something that isn't an exception class
+class ThrowingJob : public IJob {
+public:
+	virtual void run()
+	{
+		throw 1;
+	}
+};
+
+class ThreadPoolTests : public ::testing::Test {
+public:
+	ThreadPoolTests() : m_completed(false) { }
+
+	void				handleCompleted(const Event&, void*)
+	{
+		m_completed = true;
+		m_events.raiseQuitEvent();
+	}
+
+public:
+	TestEventQueue		m_events;
+	bool				m_completed;
+};
+
+TEST_F(ThreadPoolTests, run_moreJobsThanThreads_runsAllOnBoundedThreads)
+{
+	ThreadPool pool(&m_events, 2);
+	Mutex mutex;
+	CondVar<int> count(&mutex, 0);
+
+	for (int i = 0; i < 20; ++i) {
+		pool.run(new CountingJob(&count));
+	}
+
+	{
+		Lock lock(&count);
+		while (count < 20) {
+			ASSERT_TRUE(count.wait(5.0));
+		}
+	}
+	EXPECT_LE(pool.getNumThreads(), 2U);
+	EXPECT_EQ(0U, pool.getNumQueued());
+}
+
+TEST_F(ThreadPoolTests, run_withTarget_postsCompletedEvent)
+{
+	ThreadPool pool(&m_events);
+	Mutex mutex;
+	CondVar<int> count(&mutex, 0);
+
+	m_events.adoptHandler(m_events.forThreadPool().completed(), this,
+							new TMethodEventJob<ThreadPoolTests>(this,
+								&ThreadPoolTests::handleCompleted));
+
+	pool.run(new CountingJob(&count), this);
+
+	m_events.initQuitTimeout(5);
+	m_events.loop();
+	m_events.removeHandler(m_events.forThreadPool().completed(), this);
+	m_events.cleanupQuitTimeout();
+
+	EXPECT_TRUE(m_completed);
+	EXPECT_EQ(1, count);
+}
+
+TEST_F(ThreadPoolTests, run_jobThrowsUnknown_postsCompletedAndKeepsWorker)
+{
+	ThreadPool pool(&m_events, 1);
+	Mutex mutex;
+	CondVar<int> count(&mutex, 0);
+
+	m_events.adoptHandler(m_events.forThreadPool().completed(), this,
+							new TMethodEventJob<ThreadPoolTests>(this,
+								&ThreadPoolTests::handleCompleted));
+
+	pool.run(new ThrowingJob, this);
+
+	m_events.initQuitTimeout(5);
+	m_events.loop();
+	m_events.removeHandler(m_events.forThreadPool().completed(), this);
+	m_events.cleanupQuitTimeout();
+	EXPECT_TRUE(m_completed);
+
+	// the only worker is still there to run the next job
+	pool.run(new CountingJob(&count));
+	{
+		Lock lock(&count);
+		while (count < 1) {
+			ASSERT_TRUE(count.wait(5.0));
+		}
+	}
+	EXPECT_EQ(1U, pool.getNumThreads());
+}
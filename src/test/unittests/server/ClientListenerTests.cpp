@@ -0,0 +1,134 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test/mock/server/MockServer.h"
+#include "test/mock/net/MockDataSocket.h"
+#include "test/mock/net/MockListenSocket.h"
+#include "test/mock/net/MockSocketFactory.h"
+#include "server/ClientListener.h"
+#include "net/NetworkAddress.h"
+#include "base/EventQueue.h"
+
+#include "test/global/gtest.h"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+// remembers the first timer created so a test can fire it
+class TimerEventQueue : public EventQueue {
+public:
+	TimerEventQueue() : m_timer(NULL) { }
+
+	virtual EventQueueTimer*
+						newOneShotTimer(double duration, void* target)
+	{
+		EventQueueTimer* timer = EventQueue::newOneShotTimer(duration, target);
+		if (m_timer == NULL) {
+			m_timer = timer;
+		}
+		return timer;
+	}
+
+	EventQueueTimer*	m_timer;
+};
+
+class ClientListenerTests : public ::testing::Test {
+public:
+	ClientListenerTests() :
+		m_socket(&m_events),
+		m_factory(new NiceMock<MockSocketFactory>())
+	{
+		ON_CALL(*m_factory, createListen(true))
+			.WillByDefault(Return(&m_listen));
+		ON_CALL(m_listen, accept())
+			.WillByDefault(Return(&m_socket));
+		ON_CALL(m_socket, getEventTarget())
+			.WillByDefault(Return(&m_socket));
+	}
+
+	// accept m_socket, which then waits for the secure handshake
+	void				connect(ClientListener& listener)
+	{
+		listener.setServer(&m_server);
+		m_events.dispatchEvent(Event(
+			m_events.forIListenSocket().connecting(),
+			static_cast<IListenSocket*>(&m_listen)));
+	}
+
+	void				sendSocketEvent(Event::Type type)
+	{
+		m_events.dispatchEvent(Event(type, &m_socket));
+	}
+
+	void*				socketPointer()
+	{
+		return static_cast<IDataSocket*>(&m_socket);
+	}
+
+	TimerEventQueue		m_events;
+	MockServer			m_server;
+	NiceMock<MockListenSocket> m_listen;
+	NiceMock<MockDataSocket> m_socket;
+	NiceMock<MockSocketFactory>* m_factory;
+};
+
+TEST_F(ClientListenerTests, secureConnected_pendingSocket_promotedToUnknownClient)
+{
+	ClientListener listener(NetworkAddress(24800), m_factory, &m_events, true);
+
+	// the unknown client says hello and the socket is kept
+	EXPECT_CALL(m_socket, write(_, _)).Times(::testing::AtLeast(1));
+	EXPECT_CALL(m_listen, deleteSocket(_)).Times(0);
+
+	connect(listener);
+	sendSocketEvent(m_events.forIDataSocket().secureConnected());
+
+	// the handshake timer no longer applies
+	ASSERT_TRUE(m_events.m_timer != NULL);
+	m_events.dispatchEvent(Event(Event::kTimer, m_events.m_timer));
+}
+
+TEST_F(ClientListenerTests, disconnected_pendingSocket_socketDeleted)
+{
+	ClientListener listener(NetworkAddress(24800), m_factory, &m_events, true);
+
+	EXPECT_CALL(m_listen, deleteSocket(socketPointer())).Times(1);
+	EXPECT_CALL(m_socket, write(_, _)).Times(0);
+
+	connect(listener);
+	sendSocketEvent(m_events.forISocket().disconnected());
+
+	// no longer pending, so a late handshake is ignored
+	sendSocketEvent(m_events.forIDataSocket().secureConnected());
+}
+
+TEST_F(ClientListenerTests, timeout_pendingSocket_socketDeleted)
+{
+	ClientListener listener(NetworkAddress(24800), m_factory, &m_events, true);
+
+	EXPECT_CALL(m_listen, deleteSocket(socketPointer())).Times(1);
+	EXPECT_CALL(m_socket, write(_, _)).Times(0);
+
+	connect(listener);
+	ASSERT_TRUE(m_events.m_timer != NULL);
+	m_events.dispatchEvent(Event(Event::kTimer, m_events.m_timer));
+
+	// no longer pending, so a late handshake is ignored
+	sendSocketEvent(m_events.forIDataSocket().secureConnected());
+}
@@ -0,0 +1,259 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/InputFilter.h"
+#include "server/Server.h"
+#include "base/EventQueue.h"
+#include "base/TMethodEventJob.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdlib>
+
+// matches key down events, so it has no match key and is tried against
+// every event
+class KeyDownCondition : public InputFilter::Condition {
+public:
+	KeyDownCondition(IEventQueue* events) : m_events(events) { }
+
+	virtual Condition*	clone() const { return new KeyDownCondition(m_events); }
+	virtual String		format() const { return "keydown()"; }
+	virtual InputFilter::EFilterStatus
+						match(const Event& event)
+	{
+		if (event.getType() == m_events->forIKeyState().keyDown()) {
+			return InputFilter::kActivate;
+		}
+		return InputFilter::kNoMatch;
+	}
+
+private:
+	IEventQueue*		m_events;
+};
+
+// remembers the creation time of the last event it handled
+class EventTimeRecorder {
+public:
+	EventTimeRecorder() : m_time(-1.0) { }
+
+	void				handle(const Event& event, void*)
+	{
+		m_time = event.getTime();
+	}
+
+	double				m_time;
+};
+
+// find the first matching rule by trying every rule in order
+static UInt32
+findRuleLinear(InputFilter& filter, const Event& event)
+{
+	for (UInt32 i = 0; i < filter.getNumRules(); ++i) {
+		if (filter.getRule(i).match(event) != InputFilter::kNoMatch) {
+			return i;
+		}
+	}
+	return filter.getNumRules();
+}
+
+static void
+expectSameRule(InputFilter& filter, const Event& event)
+{
+	UInt32 linear = findRuleLinear(filter, event);
+	UInt32 indexed = filter.findRule(event);
+	EXPECT_EQ(linear, indexed);
+}
+
+static const KeyModifierMask s_masks[] = {
+	0,
+	KeyModifierShift,
+	KeyModifierControl,
+	KeyModifierShift | KeyModifierControl,
+	KeyModifierAlt
+};
+static const UInt32 s_numMasks = sizeof(s_masks) / sizeof(s_masks[0]);
+
+// make a pseudo-random condition of any type, or NULL
+static InputFilter::Condition*
+newRandomCondition(IEventQueue* events)
+{
+	switch (rand() % 5) {
+	case 0:
+		return new InputFilter::MouseButtonCondition(events,
+						(ButtonID)(1 + rand() % 5),
+						s_masks[rand() % s_numMasks]);
+
+	case 1:
+		return new InputFilter::KeystrokeCondition(events,
+						(KeyID)('a' + rand() % 26),
+						s_masks[rand() % s_numMasks]);
+
+	case 2:
+		return new InputFilter::ScreenConnectedCondition(events,
+						(rand() % 2) ? "" : "client");
+
+	case 3:
+		return new KeyDownCondition(events);
+
+	default:
+		return NULL;
+	}
+}
+
+TEST(InputFilterTests, findRule_manyRules_sameAsLinear)
+{
+	EventQueue events;
+	InputFilter filter(&events);
+
+	// a mix of every condition type, with duplicates, in pseudo-random
+	// order so keyed and unkeyed rules interleave
+	srand(1);
+	for (UInt32 n = 0; n < 300; ++n) {
+		filter.addFilterRule(InputFilter::Rule(newRandomCondition(&events)));
+	}
+
+	// button events, including modifiers that buttons ignore
+	for (ButtonID button = 0; button <= 6; ++button) {
+		for (UInt32 m = 0; m < s_numMasks; ++m) {
+			KeyModifierMask masks[] = {
+				s_masks[m], s_masks[m] | KeyModifierCapsLock
+			};
+			for (UInt32 k = 0; k < 2; ++k) {
+				IPlatformScreen::ButtonInfo* info =
+					IPlatformScreen::ButtonInfo::alloc(button, masks[k]);
+				expectSameRule(filter,
+					Event(events.forIPrimaryScreen().buttonDown(),
+							NULL, info, Event::kDontFreeData));
+				expectSameRule(filter,
+					Event(events.forIPrimaryScreen().buttonUp(),
+							NULL, info, Event::kDontFreeData));
+				free(info);
+			}
+		}
+	}
+
+	// hotkey events.  without a primary client no hotkey is registered
+	// so every keystroke condition has id 0.
+	for (UInt32 id = 0; id < 3; ++id) {
+		IPlatformScreen::HotKeyInfo* info =
+			IPlatformScreen::HotKeyInfo::alloc(id);
+		expectSameRule(filter,
+			Event(events.forIPrimaryScreen().hotKeyDown(),
+					NULL, info, Event::kDontFreeData));
+		expectSameRule(filter,
+			Event(events.forIPrimaryScreen().hotKeyUp(),
+					NULL, info, Event::kDontFreeData));
+		free(info);
+	}
+
+	// screen connected events
+	Server::ScreenConnectedInfo client("client");
+	expectSameRule(filter, Event(events.forServer().connected(),
+					NULL, &client, Event::kDontFreeData));
+	Server::ScreenConnectedInfo other("other");
+	expectSameRule(filter, Event(events.forServer().connected(),
+					NULL, &other, Event::kDontFreeData));
+
+	// key events only match unkeyed conditions
+	expectSameRule(filter, Event(events.forIKeyState().keyDown(),
+					NULL, NULL, Event::kDontFreeData));
+	expectSameRule(filter, Event(events.forIKeyState().keyUp(),
+					NULL, NULL, Event::kDontFreeData));
+}
+
+TEST(InputFilterTests, findRule_ruleRemoved_indexUpdated)
+{
+	EventQueue events;
+	InputFilter filter(&events);
+	filter.addFilterRule(InputFilter::Rule(
+		new InputFilter::MouseButtonCondition(&events, 1, 0)));
+	filter.addFilterRule(InputFilter::Rule(
+		new InputFilter::MouseButtonCondition(&events, 1, 0)));
+
+	IPlatformScreen::ButtonInfo* info =
+		IPlatformScreen::ButtonInfo::alloc(1, 0);
+	Event event(events.forIPrimaryScreen().buttonDown(),
+					NULL, info, Event::kDontFreeData);
+	EXPECT_EQ(0, filter.findRule(event));
+
+	filter.removeFilterRule(0);
+	EXPECT_EQ(0, filter.findRule(event));
+
+	filter.removeFilterRule(0);
+	EXPECT_EQ(filter.getNumRules(), filter.findRule(event));
+
+	free(info);
+}
+
+TEST(InputFilterTests, findRule_interleavedMutations_sameAsLinear)
+{
+	EventQueue events;
+	InputFilter filter(&events);
+
+	IPlatformScreen::ButtonInfo* button =
+		IPlatformScreen::ButtonInfo::alloc(1, 0);
+	Event buttonDown(events.forIPrimaryScreen().buttonDown(),
+					NULL, button, Event::kDontFreeData);
+	IPlatformScreen::HotKeyInfo* hotKey =
+		IPlatformScreen::HotKeyInfo::alloc(0);
+	Event hotKeyDown(events.forIPrimaryScreen().hotKeyDown(),
+					NULL, hotKey, Event::kDontFreeData);
+	Server::ScreenConnectedInfo client("client");
+	Event connected(events.forServer().connected(),
+					NULL, &client, Event::kDontFreeData);
+	Event keyDown(events.forIKeyState().keyDown(),
+					NULL, NULL, Event::kDontFreeData);
+
+	// look up after every add or remove so the index is used between
+	// mutations and a stale index would give a different answer
+	srand(2);
+	for (UInt32 n = 0; n < 400; ++n) {
+		if (filter.getNumRules() > 0 && rand() % 3 == 0) {
+			filter.removeFilterRule(rand() % filter.getNumRules());
+		}
+		else {
+			filter.addFilterRule(
+				InputFilter::Rule(newRandomCondition(&events)));
+		}
+		expectSameRule(filter, buttonDown);
+		expectSameRule(filter, hotKeyDown);
+		expectSameRule(filter, connected);
+		expectSameRule(filter, keyDown);
+	}
+
+	free(hotKey);
+	free(button);
+}
+
+TEST(InputFilterTests, keystrokeActionPerform_eventTime_keptOnKeyEvent)
+{
+	EventQueue events;
+	EventTimeRecorder recorder;
+	int target;
+	events.adoptHandler(events.forIKeyState().keyDown(), &target,
+		new TMethodEventJob<EventTimeRecorder>(
+			&recorder, &EventTimeRecorder::handle));
+
+	InputFilter::KeystrokeAction action(&events,
+		IPlatformScreen::KeyInfo::alloc('a', 0, 0, 1), true);
+	Event event(events.forIPrimaryScreen().hotKeyDown(), &target);
+	event.setTime(12.5);
+	action.perform(event);
+
+	EXPECT_EQ(12.5, recorder.m_time);
+	events.removeHandler(events.forIKeyState().keyDown(), &target);
+}
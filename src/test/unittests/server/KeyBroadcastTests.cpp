@@ -0,0 +1,49 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/KeyBroadcast.h"
+#include "synergy/protocol_types.h"
+
+#include "test/global/gtest.h"
+
+TEST(KeyBroadcastTests, getMessage_keyDown_encodesKeyMaskButton)
+{
+	KeyBroadcast key(KeyBroadcast::kDown, 0x61, 0x0002, 0x0026);
+
+	const String& actual = key.getMessage(kMsgDKeyDown);
+
+	EXPECT_EQ(String("DKDN\x00\x61\x00\x02\x00\x26", 10), actual);
+}
+
+TEST(KeyBroadcastTests, getMessage_oldProtocol_omitsButton)
+{
+	KeyBroadcast key(KeyBroadcast::kUp, 0x61, 0x0002, 0x0026);
+
+	const String& actual = key.getMessage(kMsgDKeyUp1_0);
+
+	EXPECT_EQ(String("DKUP\x00\x61\x00\x02", 8), actual);
+}
+
+TEST(KeyBroadcastTests, getMessage_sameFormatTwice_encodedOnce)
+{
+	KeyBroadcast key(KeyBroadcast::kDown, 0x61, 0x0000, 0x0026);
+
+	const String& first = key.getMessage(kMsgDKeyDown1_0);
+	const String& second = key.getMessage(kMsgDKeyDown1_0);
+
+	EXPECT_EQ(&first, &second);
+}
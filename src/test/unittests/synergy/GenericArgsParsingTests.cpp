@@ -313,3 +313,23 @@ TEST(GenericArgsParsingTests, parseGenericArgs_dragDropCmdOnLinux_enableDragDrop
 	EXPECT_EQ(1, i);
 }
 #endif
+
+TEST(GenericArgsParsingTests, parseGenericArgs_inputSchedulingCmd_saveSettings)
+{
+	int i = 1;
+	const int argc = 7;
+	const char* kInputCmd[argc] = { "stub", "--input-priority", "-5",
+		"--input-realtime", "20", "--input-cpu", "1" };
+
+	ArgParser argParser(NULL);
+	ArgsBase argsBase;
+	argParser.setArgsBase(argsBase);
+
+	for (; i < argc; ++i) {
+		argParser.parseGenericArgs(argc, kInputCmd, i);
+	}
+
+	EXPECT_EQ(-5, argsBase.m_inputPriority);
+	EXPECT_EQ(20, argsBase.m_inputRealtimePriority);
+	EXPECT_EQ(1, argsBase.m_inputCPU);
+}
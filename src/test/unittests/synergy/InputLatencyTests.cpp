@@ -0,0 +1,75 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/InputLatency.h"
+#include "base/Metrics.h"
+
+#include "test/global/gtest.h"
+
+TEST(InputLatencyTests, addClockSample_symmetricPath_estimatesOffset)
+{
+	InputLatency latency;
+
+	// remote clock is 1000000us ahead, 200us each way, 50us remote
+	// turnaround.  the local clock wraps between send and receive.
+	UInt32 localSend = 0xffffff00;
+	UInt32 remoteRecv = localSend + 1000000 + 200;
+	UInt32 remoteSend = remoteRecv + 50;
+	UInt32 localRecv = localSend + 450;
+	latency.addClockSample(localSend, remoteRecv, remoteSend, localRecv);
+
+	EXPECT_TRUE(latency.hasClockOffset());
+	EXPECT_EQ(1000000, latency.getClockOffset());
+	EXPECT_EQ(400, latency.getRoundTrip());
+
+	// a slower sample must not displace the better estimate
+	latency.addClockSample(localSend, remoteRecv + 5000,
+							remoteSend + 5000, localRecv + 5000);
+	EXPECT_EQ(1000000, latency.getClockOffset());
+}
+
+TEST(InputLatencyTests, addInput_knownOffset_splitsStages)
+{
+	InputLatency latency;
+	latency.addClockSample(0, 1000100, 1000100, 200);
+
+	// captured at remote 2000000, sent 300us later, 100us on the wire,
+	// injected 700us after receipt
+	latency.addInput(2000000, 2000300, 1000400, 1001100);
+
+	EXPECT_EQ(300, latency.getCaptureToSend().getMax());
+	EXPECT_EQ(100, latency.getNetwork().getMax());
+	EXPECT_EQ(700, latency.getReceiveToInject().getMax());
+	EXPECT_EQ(1100, latency.getTotal().getMax());
+}
+
+TEST(InputLatencyTests, addInput_sample_recordedInMetrics)
+{
+	MetricHistogram* total = METRICS->histogram(
+		"synergy_input_latency_microseconds",
+		"Input latency from capture to injection by stage",
+		Metrics::label("stage", "total"));
+	UInt64 count = total->getCount();
+	UInt64 sum   = total->getSum();
+
+	InputLatency latency;
+	latency.addClockSample(0, 1000100, 1000100, 200);
+	latency.addInput(2000000, 2000300, 1000400, 1001100);
+
+	EXPECT_EQ(count + 1, total->getCount());
+	EXPECT_EQ(sum + 1100, total->getSum());
+}
@@ -0,0 +1,97 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Si Ltd.
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/KeyMap.h"
+
+#include "test/global/gtest.h"
+
+using synergy::KeyMap;
+
+static KeyMap::KeyItem
+makeKeyItem(KeyID id, KeyButton button,
+				KeyModifierMask required, KeyModifierMask sensitive)
+{
+	KeyMap::KeyItem item;
+	item.m_id        = id;
+	item.m_group     = 0;
+	item.m_button    = button;
+	item.m_required  = required;
+	item.m_sensitive = sensitive;
+	item.m_generates = 0;
+	item.m_dead      = false;
+	item.m_lock      = false;
+	item.m_client    = 0;
+	KeyMap::initModifierKey(item);
+	return item;
+}
+
+static void
+addTestKeys(KeyMap& keyMap)
+{
+	keyMap.addKeyEntry(makeKeyItem(kKeyShift_L, 50, 0, 0));
+	keyMap.addKeyEntry(makeKeyItem('a', 38, 0, KeyModifierShift));
+	keyMap.addKeyEntry(makeKeyItem('A', 38,
+							KeyModifierShift, KeyModifierShift));
+	keyMap.finish();
+}
+
+TEST(KeyMapTests, mapKey_repeatedCall_sameKeystrokes)
+{
+	KeyMap keyMap;
+	addTestKeys(keyMap);
+
+	for (int i = 0; i < 2; ++i) {
+		KeyMap::Keystrokes keys;
+		KeyMap::ModifierToKeys activeModifiers;
+		KeyModifierMask state = 0;
+
+		const KeyMap::KeyItem* item = keyMap.mapKey(keys, 'A', 0,
+							activeModifiers, state, KeyModifierShift, false);
+
+		ASSERT_TRUE(item != NULL);
+		EXPECT_EQ(38, item->m_button);
+		// shift down, A down, shift up
+		ASSERT_EQ(3, keys.size());
+		EXPECT_EQ(50, keys[0].m_data.m_button.m_button);
+		EXPECT_TRUE(keys[0].m_data.m_button.m_press);
+		EXPECT_EQ(38, keys[1].m_data.m_button.m_button);
+		EXPECT_EQ(50, keys[2].m_data.m_button.m_button);
+		EXPECT_FALSE(keys[2].m_data.m_button.m_press);
+		EXPECT_EQ(0, state);
+		EXPECT_TRUE(activeModifiers.empty());
+	}
+}
+
+TEST(KeyMapTests, mapKey_keyAddedAfterMapping_mapsNewKey)
+{
+	KeyMap keyMap;
+	addTestKeys(keyMap);
+	KeyMap::Keystrokes keys;
+	KeyMap::ModifierToKeys activeModifiers;
+	KeyModifierMask state = 0;
+	EXPECT_TRUE(keyMap.mapKey(keys, 'b', 0,
+							activeModifiers, state, 0, false) == NULL);
+
+	keyMap.addKeyEntry(makeKeyItem('b', 56, 0, KeyModifierShift));
+	keyMap.finish();
+	keys.clear();
+	const KeyMap::KeyItem* item = keyMap.mapKey(keys, 'b', 0,
+							activeModifiers, state, 0, false);
+
+	ASSERT_TRUE(item != NULL);
+	EXPECT_EQ(56, item->m_button);
+}
@@ -64,3 +64,17 @@ TEST(ServerArgsParsingTests, parseServerArgs_configArg_setConfigFile)
 
 	EXPECT_EQ("mock_configFile", serverArgs.m_configFile);
 }
+
+TEST(ServerArgsParsingTests, parseServerArgs_ioThreadsArg_setIOThreads)
+{
+	NiceMock<MockArgParser> argParser;
+	ON_CALL(argParser, parseGenericArgs(_, _, _)).WillByDefault(Invoke(server_stubParseGenericArgs));
+	ON_CALL(argParser, checkUnexpectedArgs()).WillByDefault(Invoke(server_stubCheckUnexpectedArgs));
+	ServerArgs serverArgs;
+	const int argc = 3;
+	const char* kIOThreadsCmd[argc] = { "stub", "--io-threads", "4" };
+
+	argParser.parseServerArgs(serverArgs, argc, kIOThreadsCmd);
+
+	EXPECT_EQ(4, serverArgs.m_ioThreads);
+}